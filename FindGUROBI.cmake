@@ -58,4 +58,8 @@ FIND_LIBRARY(GUROBI_LIB
 
 set(GUROBI_LIBRARIES ${GUROBI_CPP_LIB} ${GUROBI_LIB})
 
-set(GUROBI_FOUND TRUE)
+if(GUROBI_INCLUDE_DIR AND GUROBI_CPP_LIB AND GUROBI_LIB)
+  set(GUROBI_FOUND TRUE)
+else()
+  set(GUROBI_FOUND FALSE)
+endif()
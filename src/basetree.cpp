@@ -14,8 +14,7 @@ BaseTree::BaseTree()
   , _idToNode()
   , _isLeaf(_tree, false)
   , _leafSet()
-  , _leafSubset(_tree)
-  , _level(_tree)
+  , _compactTree()
 {
 }
 
@@ -25,8 +24,7 @@ BaseTree::BaseTree(const BaseTree& other)
   , _idToNode()
   , _isLeaf(_tree, false)
   , _leafSet()
-  , _leafSubset(_tree)
-  , _level(_tree)
+  , _compactTree()
 {
   lemon::digraphCopy(other._tree, _tree)
     .node(other._root, _root)
@@ -50,8 +48,7 @@ BaseTree::BaseTree(const Digraph& T,
   , _idToNode()
   , _isLeaf(_tree, false)
   , _leafSet()
-  , _leafSubset(_tree)
-  , _level(_tree)
+  , _compactTree()
 {
   lemon::digraphCopy(T, _tree)
     .node(root, _root)
@@ -190,8 +187,6 @@ void BaseTree::init()
   _leafSet.clear();
   for (NodeIt u(_tree); u != lemon::INVALID; ++u)
   {
-    _leafSubset[u].clear();
-    
     OutArcIt a(_tree, u);
     if (a == lemon::INVALID)
     {
@@ -200,27 +195,7 @@ void BaseTree::init()
     }
   }
   
-  lemon::bfs(_tree).distMap(_level).run(_root);
-  
-  initLeafSubset(_root);
-}
-
-void BaseTree::initLeafSubset(Node u)
-{
-  NodeSet merged;
-  for (OutArcIt a(_tree, u); a != lemon::INVALID; ++a)
-  {
-    Node v = _tree.target(a);
-    initLeafSubset(v);
-    merged.insert(_leafSubset[v].begin(), _leafSubset[v].end());
-  }
-  
-  if (merged.empty())
-  {
-    // node is a leaf
-    merged.insert(u);
-  }
-  _leafSubset[u] = merged;
+  _compactTree.init(_tree, _root);
 }
 
 bool BaseTree::readVertexLabeling(std::istream& in,
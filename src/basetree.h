@@ -9,6 +9,7 @@
 #define BASETREE_H
 
 #include "utils.h"
+#include "compacttree.h"
 
 /// This class models a tree whose nodes are labeled by unique identifiers
 class BaseTree
@@ -56,9 +57,10 @@ public:
   }
   
   /// Return anatomical site labels
-  virtual StringSet getAnatomicalSites() const
+  virtual const StringSet& getAnatomicalSites() const
   {
-    return StringSet();
+    static const StringSet emptySet;
+    return emptySet;
   }
   
   /// Return underlying LEMON tree
@@ -82,15 +84,7 @@ public:
   /// @param v Node
   bool isAncestor(Node u, Node v) const
   {
-    while (v != _root)
-    {
-      if (u == v)
-        return true;
-      else
-        v = _tree.source(InArcIt(_tree, v));
-    }
-    
-    return u == v;
+    return _compactTree.isAncestor(u, v);
   }
   
   static bool isAncestor(const Digraph& tree,
@@ -125,14 +119,7 @@ public:
   /// @param u Node
   Node parent(Node u) const
   {
-    if (u == _root)
-    {
-      return lemon::INVALID;
-    }
-    else
-    {
-      return _tree.source(InArcIt(_tree, u));
-    }
+    return _compactTree.parent(u);
   }
   
   /// Return the root node
@@ -168,15 +155,15 @@ public:
   /// @param u Node
   int level(Node u) const
   {
-    return _level[u];
+    return _compactTree.depth(u);
   }
   
   /// Return the set of leaves that occur in the subtree rooted at the provided node
   ///
   /// @param u Node
-  const NodeSet& leafSubset(Node u) const
+  NodeSet leafSubset(Node u) const
   {
-    return _leafSubset[u];
+    return _compactTree.leafSubset(u);
   }
   
   /// Return the leaf set
@@ -197,7 +184,14 @@ public:
   /// @param nodes Node set
   Node getLCA(const NodeSet& nodes) const
   {
-    return getLCA(_tree, nodes);
+    return _compactTree.getLCA(nodes);
+  }
+  
+  /// Return the frozen array-based view of the tree
+  /// for read-only hot paths
+  const CompactTree& compactTree() const
+  {
+    return _compactTree;
   }
   
   /// Decides whether the given set of nodes is connected
@@ -206,7 +200,7 @@ public:
   bool isConnected(const NodeSet& nodes) const;
   
   /// Initialize auxilliary data structures
-  /// (_isLeaf, _leafSet, _leafSubset, _level)
+  /// (_isLeaf, _leafSet, _compactTree)
   void init();
   
   /// Return a node corresponding to the given identifier.
@@ -263,7 +257,7 @@ public:
   /// Return a generated color map based on the anatomical sites present in the current tree
   StringToIntMap generateColorMap() const
   {
-    StringSet Sigma = getAnatomicalSites();
+    const StringSet& Sigma = getAnatomicalSites();
     
     StringToIntMap colorMap;
     int idx = 0;
@@ -325,13 +319,9 @@ protected:
   BoolNodeMap _isLeaf;
   /// Leaf set
   NodeSet _leafSet;
-  /// Leaf set of subtree rooted at a node
-  NodeNodeSetMap _leafSubset;
-  /// BFS level of a node
-  IntNodeMap _level;
-  
-  /// Initialize _leafSubset
-  void initLeafSubset(Node node);
+  /// Frozen array-based view of the tree
+  /// (preorder intervals, leaf ranks and LCA sparse table)
+  CompactTree _compactTree;
   
   /// Decide whether the tree is valid
   virtual bool isValid() const;
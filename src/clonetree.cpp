@@ -11,12 +11,20 @@
 CloneTree::CloneTree()
   : BaseTree()
   , _l(_tree)
+  , _lIndex(_tree, -1)
+  , _anatomicalSites()
+  , _indexToAnatomicalSite()
+  , _anatomicalSiteToIndex()
 {
 }
 
 CloneTree::CloneTree(const CloneTree& other)
   : BaseTree(other)
   , _l(_tree)
+  , _lIndex(_tree, -1)
+  , _anatomicalSites()
+  , _indexToAnatomicalSite()
+  , _anatomicalSiteToIndex()
 {
   for (NodeIt u(_tree); u != lemon::INVALID; ++u)
   {
@@ -25,6 +33,8 @@ CloneTree::CloneTree(const CloneTree& other)
     
     _l[u] = other._l[other_u];
   }
+  
+  initAnatomicalSites();
 }
 
 CloneTree& CloneTree::operator =(const CloneTree& other)
@@ -51,6 +61,8 @@ CloneTree& CloneTree::operator =(const CloneTree& other)
       
       _l[u] = other._l[other_u];
     }
+    
+    initAnatomicalSites();
   }
   
   return *this;
@@ -62,6 +74,10 @@ CloneTree::CloneTree(const Digraph& T,
                      const StringNodeMap& l)
   : BaseTree(T, root, label)
   , _l(_tree)
+  , _lIndex(_tree, -1)
+  , _anatomicalSites()
+  , _indexToAnatomicalSite()
+  , _anatomicalSiteToIndex()
 {
   for (NodeIt v(T); v != lemon::INVALID; ++v)
   {
@@ -71,6 +87,29 @@ CloneTree::CloneTree(const Digraph& T,
       _l[getNodeByLabel(label_v)] = l[v];
     }
   }
+  
+  initAnatomicalSites();
+}
+
+void CloneTree::initAnatomicalSites()
+{
+  _anatomicalSites.clear();
+  for (Node u : _leafSet)
+  {
+    _anatomicalSites.insert(_l[u]);
+  }
+  
+  _indexToAnatomicalSite.assign(_anatomicalSites.begin(), _anatomicalSites.end());
+  _anatomicalSiteToIndex.clear();
+  for (int s = 0; s < _indexToAnatomicalSite.size(); ++s)
+  {
+    _anatomicalSiteToIndex[_indexToAnatomicalSite[s]] = s;
+  }
+  
+  for (NodeIt u(_tree); u != lemon::INVALID; ++u)
+  {
+    _lIndex[u] = _isLeaf[u] ? _anatomicalSiteToIndex[_l[u]] : -1;
+  }
 }
 
 bool CloneTree::readLeafLabeling(std::istream& in)
@@ -119,6 +158,8 @@ bool CloneTree::readLeafLabeling(std::istream& in)
     }
   }
   
+  initAnatomicalSites();
+  
   return true;
 }
 
@@ -500,6 +541,7 @@ void CloneTree::mergeSameSiblingLeaves()
   }
   
   init();
+  initAnatomicalSites();
 }
 
 void CloneTree::writeDOT(std::ostream& out,
@@ -671,7 +713,7 @@ SplitSet CloneTree::getSplits() const
   const NodeSet allLeaves = leafSet();
   for (NodeIt v(_tree); v != lemon::INVALID; ++v)
   {
-    const NodeSet& L_v = leafSubset(v);
+    const NodeSet L_v = leafSubset(v);
     NodeSet L_complement_v;
     std::set_difference(allLeaves.begin(), allLeaves.end(),
                         L_v.begin(), L_v.end(),
@@ -44,15 +44,24 @@ public:
     return _l[u];
   }
   
+  /// Return the anatomical site index of the leaf label of the given node
+  ///
+  /// @param u Node
+  int lIndex(Node u) const
+  {
+    assert(_isLeaf[u]);
+    return _lIndex[u];
+  }
+  
   /// Return the set of leaf labels of subtree rooted at the given node
   ///
   /// @param u Node
   StringSet ll(Node u) const
   {
     StringSet res;
-    for (Node v : _leafSubset[u])
+    for (int r = _compactTree.leafBegin(u); r < _compactTree.leafEnd(u); ++r)
     {
-      res.insert(l(v));
+      res.insert(l(_compactTree.leaf(r)));
     }
     return res;
   }
@@ -189,29 +198,64 @@ public:
   /// Return number of anatomical sites
   int getNrAnatomicalSites() const
   {
-    return getAnatomicalSites().size();
+    return _indexToAnatomicalSite.size();
   }
   
   /// Return anatomical site labels
-  StringSet getAnatomicalSites() const
+  const StringSet& getAnatomicalSites() const
+  {
+    return _anatomicalSites;
+  }
+  
+  /// Return the index of the given anatomical site, or -1 if it does not
+  /// label any leaf. Indices are dense and follow the lexicographic order
+  /// of the anatomical site labels.
+  ///
+  /// @param s Anatomical site label
+  int anatomicalSiteToIndex(const std::string& s) const
+  {
+    StringToIntMap::const_iterator it = _anatomicalSiteToIndex.find(s);
+    return it == _anatomicalSiteToIndex.end() ? -1 : it->second;
+  }
+  
+  /// Return the label of the anatomical site with the given index
+  ///
+  /// @param s Anatomical site index
+  const std::string& indexToAnatomicalSite(int s) const
+  {
+    assert(0 <= s && s < _indexToAnatomicalSite.size());
+    return _indexToAnatomicalSite[s];
+  }
+  
+  /// Convert a vertex labeling by anatomical site labels to a vertex labeling
+  /// by anatomical site indices
+  ///
+  /// @param lPlus Labeling of each node by an anatomical site
+  /// @param lPlusIndex Output labeling of each node by an anatomical site index
+  void getIndexLabeling(const StringNodeMap& lPlus,
+                        IntNodeMap& lPlusIndex) const
   {
-    StringSet res;
-    
     for (NodeIt v(_tree); v != lemon::INVALID; ++v)
     {
-      if (isLeaf(v))
-      {
-        res.insert(_l[v]);
-      }
+      lPlusIndex[v] = anatomicalSiteToIndex(lPlus[v]);
+      assert(lPlusIndex[v] != -1);
     }
-    
-    return res;
   }
   
   /// Return all migration edges of the provided vertex labeling
   ///
   /// @param lPlus Labeling of each node by an anatomical site
   ArcSet getMigrationEdges(const StringNodeMap& lPlus) const
+  {
+    IntNodeMap lPlusIndex(_tree);
+    getIndexLabeling(lPlus, lPlusIndex);
+    return getMigrationEdges(lPlusIndex);
+  }
+  
+  /// Return all migration edges of the provided vertex labeling
+  ///
+  /// @param lPlus Labeling of each node by an anatomical site index
+  ArcSet getMigrationEdges(const IntNodeMap& lPlus) const
   {
     ArcSet res;
     
@@ -240,9 +284,21 @@ public:
   /// Return split set
   SplitSet getSplits() const;
   
+protected:
+  /// Intern the anatomical site labels of the leaves
+  void initAnatomicalSites();
+  
 protected:
   /// Leaf labeling L(T) -> Sigma
   StringNodeMap _l;
+  /// Anatomical site index of leaf label (-1 for inner vertices)
+  IntNodeMap _lIndex;
+  /// Anatomical site labels
+  StringSet _anatomicalSites;
+  /// Anatomical site index to label
+  StringVector _indexToAnatomicalSite;
+  /// Anatomical site label to index
+  StringToIntMap _anatomicalSiteToIndex;
 };
 
 #endif // CLONETREE_H
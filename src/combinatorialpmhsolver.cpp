@@ -0,0 +1,421 @@
+/*
+ * combinatorialpmhsolver.cpp
+ *
+ *  Created on: 18-oct-2026
+ *      Author: M. El-Kebir
+ */
+
+#include "combinatorialpmhsolver.h"
+#include <fstream>
+#include <limits>
+
+CombinatorialPmhSolver::CombinatorialPmhSolver(const CloneTree& T,
+                                               const std::string& primary,
+                                               MigrationGraph::Pattern pattern,
+                                               const StringPairList& forcedComigrations)
+  : _T(T)
+  , _primary(primary)
+  , _pattern(pattern)
+  , _forcedComigrations(forcedComigrations)
+  , _bounds(std::make_pair(-1, std::make_pair(-1, -1)))
+  , _stateToSample()
+  , _sampleToState()
+  , _charT(T, primary, _stateToSample, _sampleToState)
+  , _sankoff(_charT)
+  , _parent()
+  , _bestParent()
+  , _bestMu(-1)
+  , _bestSigma(-1)
+  , _rootMu(-1)
+  , _infeasible(false)
+  , _timer()
+  , _timeLimit(-1)
+  , _timeLimitReached(false)
+  , _nrSearchNodes(0)
+  , _LB(-1)
+  , _UB(-1)
+  , _pLPlus(NULL)
+{
+  assert(isSupported(pattern));
+}
+
+CombinatorialPmhSolver::~CombinatorialPmhSolver()
+{
+  delete _pLPlus;
+}
+
+void CombinatorialPmhSolver::init(const IntTriple& bounds)
+{
+  const int nrAnatomicalSites = _stateToSample.size();
+  assert(_stateToSample[0] == _primary);
+
+  _bounds = bounds;
+  _infeasible = false;
+
+  // the migration graph spans all anatomical sites
+  if (bounds.second.first != -1 && nrAnatomicalSites - 1 > bounds.second.first)
+  {
+    _infeasible = true;
+  }
+
+  _parent = IntVector(nrAnatomicalSites, -1);
+  for (const StringPair& st : _forcedComigrations)
+  {
+    assert(_sampleToState.count(st.first) == 1);
+    assert(_sampleToState.count(st.second) == 1);
+
+    const int s = _sampleToState[st.first];
+    const int t = _sampleToState[st.second];
+
+    if (t == 0 || s == t
+        || (_pattern == MigrationGraph::PS && s != 0)
+        || (_parent[t] != -1 && _parent[t] != s))
+    {
+      // the primary tumor is not seeded and every metastasis
+      // is seeded by a single anatomical site
+      _infeasible = true;
+    }
+    else if (_parent[t] == -1)
+    {
+      if (isAncestor(t, s))
+      {
+        _infeasible = true;
+      }
+      _parent[t] = s;
+    }
+  }
+
+  if (_pattern == MigrationGraph::PS)
+  {
+    for (int t = 1; t < nrAnatomicalSites; ++t)
+    {
+      _parent[t] = 0;
+    }
+  }
+}
+
+bool CombinatorialPmhSolver::isAncestor(int t, int s) const
+{
+  for (; s != -1; s = _parent[s])
+  {
+    if (s == t)
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+int CombinatorialPmhSolver::getNrSeedingSites() const
+{
+  const int nrAnatomicalSites = _stateToSample.size();
+
+  BoolVector seeding(nrAnatomicalSites, false);
+  int res = 0;
+  for (int t = 1; t < nrAnatomicalSites; ++t)
+  {
+    const int s = _parent[t];
+    if (s != -1 && !seeding[s])
+    {
+      seeding[s] = true;
+      ++res;
+    }
+  }
+  return res;
+}
+
+int CombinatorialPmhSolver::bound()
+{
+  const int nrAnatomicalSites = _stateToSample.size();
+  const int inf = std::numeric_limits<int>::max();
+
+  // migrations into an undecided anatomical site are allowed
+  // from any other anatomical site
+  IntMatrix costs(nrAnatomicalSites, IntVector(nrAnatomicalSites, 1));
+  for (int t = 0; t < nrAnatomicalSites; ++t)
+  {
+    for (int s = 0; s < nrAnatomicalSites; ++s)
+    {
+      if (s == t)
+      {
+        costs[s][t] = 0;
+      }
+      else if (t == 0 || (_parent[t] != -1 && _parent[t] != s))
+      {
+        costs[s][t] = inf;
+      }
+    }
+  }
+
+  _sankoff.setTransitionCosts(0, costs);
+  _sankoff.computeCosts(0);
+  ++_nrSearchNodes;
+
+  return _sankoff.getRootCost(0, 0);
+}
+
+double CombinatorialPmhSolver::objective(int mu, int gamma, int sigma) const
+{
+  const int nrAnatomicalSites = _stateToSample.size();
+  return mu
+    + (1. / (nrAnatomicalSites * nrAnatomicalSites)) * gamma
+    + (1. / (nrAnatomicalSites * nrAnatomicalSites)) * (1. / (nrAnatomicalSites + 1)) * sigma;
+}
+
+void CombinatorialPmhSolver::branch(int k)
+{
+  const int nrAnatomicalSites = _stateToSample.size();
+  const int inf = std::numeric_limits<int>::max();
+
+  if (_timeLimit != -1 && _timer.realTime() > _timeLimit)
+  {
+    _timeLimitReached = true;
+    return;
+  }
+
+  assert(0 < k && k < nrAnatomicalSites && _parent[k] == -1);
+
+  for (int s = 0; s < nrAnatomicalSites && !_timeLimitReached; ++s)
+  {
+    if (s == k || isAncestor(k, s)) continue;
+
+    _parent[k] = s;
+
+    // (mu, gamma, sigma) is minimized lexicographically, where gamma is fixed
+    const int mu = bound();
+    const int sigma = getNrSeedingSites();
+    const bool pruned = mu == inf
+      || (_bounds.first != -1 && mu > _bounds.first)
+      || (_bounds.second.second != -1 && sigma > _bounds.second.second)
+      || (_bestMu != -1 && (mu > _bestMu || (mu == _bestMu && sigma >= _bestSigma)));
+
+    if (!pruned)
+    {
+      // skip anatomical sites whose parent is forced
+      int l = k + 1;
+      while (l < nrAnatomicalSites && _parent[l] != -1)
+      {
+        ++l;
+      }
+
+      if (l == nrAnatomicalSites)
+      {
+        // the migration graph is decided, so mu and sigma are exact
+        _bestMu = mu;
+        _bestSigma = sigma;
+        _bestParent = _parent;
+      }
+      else
+      {
+        branch(l);
+      }
+    }
+
+    _parent[k] = -1;
+  }
+}
+
+bool CombinatorialPmhSolver::solve(int timeLimit)
+{
+  const int nrAnatomicalSites = _stateToSample.size();
+  const int inf = std::numeric_limits<int>::max();
+
+  _timer.restart();
+  _timeLimit = timeLimit;
+  _timeLimitReached = false;
+  _nrSearchNodes = 0;
+  _bestMu = _bestSigma = -1;
+  _bestParent.clear();
+
+  if (_infeasible)
+  {
+    return false;
+  }
+
+  // root of the search tree
+  _rootMu = bound();
+  if (_rootMu == inf || (_bounds.first != -1 && _rootMu > _bounds.first))
+  {
+    return false;
+  }
+
+  int k = 1;
+  while (k < nrAnatomicalSites && _parent[k] != -1)
+  {
+    ++k;
+  }
+
+  if (k == nrAnatomicalSites)
+  {
+    const int sigma = getNrSeedingSites();
+    if (_bounds.second.second == -1 || sigma <= _bounds.second.second)
+    {
+      _bestMu = _rootMu;
+      _bestSigma = sigma;
+      _bestParent = _parent;
+    }
+  }
+  else
+  {
+    branch(k);
+  }
+
+  if (_bestMu == -1)
+  {
+    return false;
+  }
+
+  _UB = objective(_bestMu, nrAnatomicalSites - 1, _bestSigma);
+  if (_timeLimitReached)
+  {
+    _LB = objective(_rootMu, nrAnatomicalSites - 1, nrAnatomicalSites > 1 ? 1 : 0);
+  }
+  else
+  {
+    _LB = _UB;
+  }
+
+  processSolution();
+
+  return true;
+}
+
+void CombinatorialPmhSolver::processSolution()
+{
+  _parent = _bestParent;
+  bound();
+
+  Sankoff::SolutionIt it(_sankoff, 0);
+  assert(it.valid());
+
+  delete _pLPlus;
+  _pLPlus = new StringNodeMap(_T.tree());
+  for (NodeIt v(_charT.tree()); v != lemon::INVALID; ++v)
+  {
+    const Node vv = _T.getNodeByLabel(_charT.label(v));
+    assert(vv != lemon::INVALID);
+
+    _pLPlus->set(vv, _stateToSample[it.state(v)]);
+  }
+}
+
+void CombinatorialPmhSolver::writeCloneTree(std::ostream& out,
+                                            const StringToIntMap& colorMap) const
+{
+  _T.writeDOT(out, lPlus(), colorMap);
+}
+
+IntTriple CombinatorialPmhSolver::run(const CloneTree& T,
+                                      const std::string& primary,
+                                      const std::string& outputDirectory,
+                                      const std::string& outputPrefix,
+                                      const StringToIntMap& colorMap,
+                                      MigrationGraph::Pattern pattern,
+                                      int timeLimit,
+                                      const IntTriple& bounds,
+                                      const StringPairList& forcedComigrations,
+                                      std::ostream& out)
+{
+  char buf[1024];
+
+  CombinatorialPmhSolver solver(T,
+                                primary,
+                                pattern,
+                                forcedComigrations);
+  solver.init(bounds);
+
+  lemon::Timer timer;
+  bool solved = solver.solve(timeLimit);
+  if (!solved)
+  {
+    out << outputPrefix << "\t"
+        << "(" << MigrationGraph::getAllowedPatternsString(pattern) << ")\t"
+        << "-" << "\t"
+        << "-" << "\t"
+        << "-" << "\t"
+        << "-" << "\t"
+        << "-" << "\t"
+        << "-" << "\t"
+        << timer.realTime()
+        << std::endl;
+
+    IntTriple res;
+    res.first = -1;
+    res.second.first = -1;
+    res.second.second = -1;
+
+    return res;
+  }
+
+  MigrationGraph G(solver.T(), solver.lPlus());
+
+  int mu = G.getNrMigrations();
+  int gamma = G.getNrComigrations(solver.T(), solver.lPlus());
+  int sigma = G.getNrSeedingSites();
+
+  out << outputPrefix << "\t"
+      << "(" << MigrationGraph::getAllowedPatternsString(pattern) << ")\t"
+      << mu << "\t"
+      << gamma << "\t"
+      << sigma << "\t"
+      << G.getPatternString(G.getPattern(), G.isMonoclonal()) << "\t"
+      << solver.LB() << "\t"
+      << solver.UB() << "\t"
+      << timer.realTime()
+      << std::endl;
+
+  if (!outputDirectory.empty())
+  {
+    snprintf(buf, 1024, "%s/%sT-%s-%s.dot",
+             outputDirectory.c_str(),
+             outputPrefix.c_str(),
+             primary.c_str(),
+             MigrationGraph::getPatternString(pattern).c_str());
+    AtomicOfstream outT(buf);
+    solver.writeCloneTree(outT, colorMap);
+    outT.close();
+
+    snprintf(buf, 1024, "%s/%sG-%s-%s.dot",
+             outputDirectory.c_str(),
+             outputPrefix.c_str(),
+             primary.c_str(),
+             MigrationGraph::getPatternString(pattern).c_str());
+    AtomicOfstream outG(buf);
+    G.writeDOT(outG, colorMap);
+    outG.close();
+
+    snprintf(buf, 1024, "%s/%sG-%s-%s.tree",
+             outputDirectory.c_str(),
+             outputPrefix.c_str(),
+             primary.c_str(),
+             MigrationGraph::getPatternString(pattern).c_str());
+    AtomicOfstream outGraph(buf);
+    G.write(outGraph);
+    outGraph.close();
+
+    snprintf(buf, 1024, "%s/%sT-%s-%s.tree",
+             outputDirectory.c_str(),
+             outputPrefix.c_str(),
+             primary.c_str(),
+             MigrationGraph::getPatternString(pattern).c_str());
+    AtomicOfstream outTree(buf);
+    solver.T().write(outTree);
+    outTree.close();
+
+    snprintf(buf, 1024, "%s/%sT-%s-%s.labeling",
+             outputDirectory.c_str(),
+             outputPrefix.c_str(),
+             primary.c_str(),
+             MigrationGraph::getPatternString(pattern).c_str());
+    AtomicOfstream outLabeling(buf);
+    solver.T().writeVertexLabeling(outLabeling, solver.lPlus());
+    outLabeling.close();
+  }
+
+  IntTriple res;
+  res.first = mu;
+  res.second.first = gamma;
+  res.second.second = sigma;
+
+  return res;
+}
@@ -0,0 +1,214 @@
+/*
+ * combinatorialpmhsolver.h
+ *
+ *  Created on: 18-oct-2026
+ *      Author: M. El-Kebir
+ */
+
+#ifndef COMBINATORIALPMHSOLVER_H
+#define COMBINATORIALPMHSOLVER_H
+
+#include "utils.h"
+#include "clonetree.h"
+#include "charactertree.h"
+#include "sankoff.h"
+#include "migrationgraph.h"
+#include <lemon/time_measure.h>
+
+/// This class implements a combinatorial branch-and-bound algorithm for
+/// solving the Parsimonious Migration History (PMH) problem under the
+/// PS and S topological constraints.
+///
+/// Under these constraints the migration graph G is a tree rooted at the
+/// primary tumor that spans all anatomical sites, hence the comigration
+/// number equals the number of anatomical sites minus one. The algorithm
+/// branches on the parent of each metastatic site in G. Each node of the
+/// search tree is bounded by a Sankoff dynamic program whose transition
+/// costs only allow the migrations of G that have been decided so far,
+/// which yields a lower bound on the migration number. At the leaves of
+/// the search tree G is fully decided and the Sankoff costs are exact.
+///
+/// \brief This class implements a combinatorial algorithm for solving
+/// PMH under the PS and S topological constraints
+class CombinatorialPmhSolver
+{
+public:
+  /// Constructor
+  ///
+  /// @param T Clone tree
+  /// @param primary Primary tumor
+  /// @param pattern Topological constraint, either PS or S
+  /// @param forcedComigrations List of ordered pairs of anatomical sites
+  /// that must be present
+  CombinatorialPmhSolver(const CloneTree& T,
+                         const std::string& primary,
+                         MigrationGraph::Pattern pattern,
+                         const StringPairList& forcedComigrations);
+
+  /// Destructor
+  ~CombinatorialPmhSolver();
+
+  /// Return whether the given topological constraint is supported
+  ///
+  /// @param pattern Topological constraint
+  static bool isSupported(MigrationGraph::Pattern pattern)
+  {
+    return pattern == MigrationGraph::PS || pattern == MigrationGraph::S;
+  }
+
+  /// Return clone tree
+  const CloneTree& T() const
+  {
+    return _T;
+  }
+
+  /// Return vertex labeling
+  const StringNodeMap& lPlus() const
+  {
+    return *_pLPlus;
+  }
+
+  /// Initialize solver
+  ///
+  /// @param bounds Upper bounds on mu, gamma and sigma
+  void init(const IntTriple& bounds);
+
+  /// Solve
+  ///
+  /// @param timeLimit Time limit in seconds (-1: no time limit)
+  bool solve(int timeLimit);
+
+  /// Return lower bound
+  double LB() const
+  {
+    return _LB;
+  }
+
+  /// Return upper bound
+  double UB() const
+  {
+    return _UB;
+  }
+
+  /// Return number of explored search tree nodes
+  int getNrSearchNodes() const
+  {
+    return _nrSearchNodes;
+  }
+
+  /// Write clone tree in DOT format
+  ///
+  /// @param out Output stream
+  /// @param colorMap Color map
+  void writeCloneTree(std::ostream& out,
+                      const StringToIntMap& colorMap) const;
+
+  /// Solve PMH under a topological constraint
+  ///
+  /// @param T Non-binary clone tree
+  /// @param primary Primary tumor
+  /// @param outputDirectory Output directory
+  /// @param outputPrefix Prefix prepended to every output filename
+  /// @param colorMap Color map
+  /// @param pattern Topological constraint, either PS or S
+  /// @param timeLimit Time limit in seconds
+  /// @param bounds Upper bounds on mu, gamma and sigma
+  /// @param forcedComigrations List of ordered pairs of anatomical sites
+  /// that must be present
+  /// @param out Output stream receiving the results
+  static IntTriple run(const CloneTree& T,
+                       const std::string& primary,
+                       const std::string& outputDirectory,
+                       const std::string& outputPrefix,
+                       const StringToIntMap& colorMap,
+                       MigrationGraph::Pattern pattern,
+                       int timeLimit,
+                       const IntTriple& bounds,
+                       const StringPairList& forcedComigrations,
+                       std::ostream& out);
+
+private:
+  /// Clone tree
+  const CloneTree& _T;
+  /// Label of primary tumor anatomical site
+  const std::string& _primary;
+  /// Topological constraint
+  const MigrationGraph::Pattern _pattern;
+  /// List of ordered pairs of anatomical sites that must be present
+  const StringPairList& _forcedComigrations;
+  /// Upper bounds on mu, gamma and sigma (-1: disabled)
+  IntTriple _bounds;
+
+  /// State to anatomical site label, state 0 is the primary tumor
+  StringVector _stateToSample;
+  /// Anatomical site label to state
+  CharacterTree::StringToIntMap _sampleToState;
+  /// Character-based tree with a single character whose states are
+  /// the anatomical sites
+  CharacterTree _charT;
+  /// Sankoff instance used for bounding
+  Sankoff _sankoff;
+
+  /// Parent of each anatomical site in the migration graph,
+  /// -1 if undecided (the primary tumor has no parent)
+  IntVector _parent;
+  /// Parent of the migration graph of the incumbent
+  IntVector _bestParent;
+  /// Migration number of the incumbent (-1 if none)
+  int _bestMu;
+  /// Seeding site number of the incumbent
+  int _bestSigma;
+  /// Lower bound on the migration number at the root of the search tree
+  int _rootMu;
+  /// Indicates whether the instance is infeasible regardless of search
+  bool _infeasible;
+
+  /// Timer
+  lemon::Timer _timer;
+  /// Time limit in seconds (-1: no time limit)
+  int _timeLimit;
+  /// Indicates whether the time limit was reached
+  bool _timeLimitReached;
+  /// Number of explored search tree nodes
+  int _nrSearchNodes;
+
+  /// Lower bound on the optimal solution
+  double _LB;
+  /// Upper bound on the optimal solution
+  double _UB;
+  /// Resulting vertex labeling
+  StringNodeMap* _pLPlus;
+
+  /// Return whether anatomical site t is an ancestor of anatomical site s
+  /// in the partially decided migration graph
+  ///
+  /// @param t Anatomical site (state)
+  /// @param s Anatomical site (state)
+  bool isAncestor(int t, int s) const;
+
+  /// Return the number of distinct parents in the partially decided
+  /// migration graph, which is a lower bound on the seeding site number
+  int getNrSeedingSites() const;
+
+  /// Return the minimum number of migrations of a vertex labeling whose
+  /// migrations are compatible with the partially decided migration graph,
+  /// std::numeric_limits<int>::max() if there is no such labeling
+  int bound();
+
+  /// Return the value of the objective function of the ILP formulation
+  ///
+  /// @param mu Migration number
+  /// @param gamma Comigration number
+  /// @param sigma Seeding site number
+  double objective(int mu, int gamma, int sigma) const;
+
+  /// Decide the parent of anatomical sites k and beyond
+  ///
+  /// @param k Anatomical site (state)
+  void branch(int k);
+
+  /// Construct vertex labeling from the incumbent
+  void processSolution();
+};
+
+#endif // COMBINATORIALPMHSOLVER_H
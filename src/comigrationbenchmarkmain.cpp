@@ -0,0 +1,180 @@
+/*
+ * comigrationbenchmarkmain.cpp
+ *
+ *  Created on: 18-oct-2026
+ *      Author: M. El-Kebir
+ */
+
+#include "utils.h"
+#include "clonetree.h"
+#include "migrationgraph.h"
+#include <lemon/arg_parser.h>
+#include <lemon/time_measure.h>
+#include <fstream>
+
+/// Return the number of comigrations by scanning the migration edges
+/// of every pair of anatomical sites (reference implementation)
+///
+/// @param T Clone tree
+/// @param lPlus Vertex labeling
+int getNrComigrationsReference(const CloneTree& T,
+                               const StringNodeMap& lPlus)
+{
+  const Digraph& TT = T.tree();
+
+  StringSet sites;
+  for (NodeIt v(TT); v != lemon::INVALID; ++v)
+  {
+    sites.insert(lPlus[v]);
+  }
+
+  ArcSet migrationEdges = T.getMigrationEdges(lPlus);
+
+  int nrComigrations = 0;
+  for (const std::string& l_x : sites)
+  {
+    for (const std::string& l_y : sites)
+    {
+      ArcSet migrationEdges_xy;
+      for (Arc uv : migrationEdges)
+      {
+        Node u = TT.source(uv);
+        Node v = TT.target(uv);
+
+        if (lPlus[u] == l_x && lPlus[v] == l_y)
+        {
+          migrationEdges_xy.insert(uv);
+        }
+      }
+
+      int nrAncestralMigrationEdges = 0;
+      for (Arc uv : migrationEdges_xy)
+      {
+        int count = 0;
+
+        Arc prevArc = uv;
+        while (prevArc != lemon::INVALID)
+        {
+          if (migrationEdges_xy.count(prevArc) == 1)
+          {
+            ++count;
+          }
+          prevArc = InArcIt(TT, TT.source(prevArc));
+        }
+        if (count > nrAncestralMigrationEdges)
+        {
+          nrAncestralMigrationEdges = count;
+        }
+      }
+      nrComigrations += nrAncestralMigrationEdges;
+    }
+  }
+
+  return nrComigrations;
+}
+
+int main(int argc, char** argv)
+{
+  int nrRepetitions = 1000;
+
+  lemon::ArgParser ap(argc, argv);
+  ap.refOption("n", "Number of repetitions per instance (default: 1000)", nrRepetitions)
+    .other("T", "Clone tree")
+    .other("vertex_labeling", "Vertex labeling (pairs of T and vertex_labeling may be repeated)");
+  ap.parse();
+
+  if (ap.files().empty() || ap.files().size() % 2 != 0)
+  {
+    std::cerr << "Error: pairs of <T> and <vertex_labeling> must be specified" << std::endl;
+    return 1;
+  }
+
+  std::cout << "T\t|V(T)|\tm\tgamma\treference time (ms)\ttime (ms)\tspeedup" << std::endl;
+
+  double totalReferenceTime = 0;
+  double totalTime = 0;
+  const int nrFiles = ap.files().size();
+  for (int i = 0; i < nrFiles; i += 2)
+  {
+    const std::string& filenameT = ap.files()[i];
+    std::ifstream inT(filenameT.c_str());
+    if (!inT.good())
+    {
+      std::cerr << "Could not open '" << filenameT << "' for reading" << std::endl;
+      return 1;
+    }
+
+    const std::string& filenameLabeling = ap.files()[i + 1];
+    std::ifstream inLeafLabeling(filenameLabeling.c_str());
+    if (!inLeafLabeling.good())
+    {
+      std::cerr << "Could not open '" << filenameLabeling << "' for reading" << std::endl;
+      return 1;
+    }
+
+    CloneTree T;
+    try
+    {
+      if (!T.read(inT)) return 1;
+      if (!T.readLeafLabeling(inLeafLabeling)) return 1;
+    }
+    catch (std::runtime_error& e)
+    {
+      std::cerr << e.what() << std::endl;
+      return 1;
+    }
+
+    StringNodeMap lPlus(T.tree());
+    std::ifstream inVertexLabeling(filenameLabeling.c_str());
+    if (!T.readVertexLabeling(inVertexLabeling, T, lPlus))
+    {
+      return 1;
+    }
+
+    MigrationGraph G(T, lPlus);
+
+    int referenceGamma = 0;
+    lemon::Timer referenceTimer;
+    for (int r = 0; r < nrRepetitions; ++r)
+    {
+      referenceGamma = getNrComigrationsReference(T, lPlus);
+    }
+    referenceTimer.stop();
+    totalReferenceTime += referenceTimer.realTime();
+
+    // the labeling is interned once, as done by the callers on hot paths
+    IntNodeMap lPlusIndex(T.tree());
+    T.getIndexLabeling(lPlus, lPlusIndex);
+
+    int gamma = 0;
+    lemon::Timer timer;
+    for (int r = 0; r < nrRepetitions; ++r)
+    {
+      gamma = G.getNrComigrations(T, lPlusIndex);
+    }
+    timer.stop();
+    totalTime += timer.realTime();
+
+    if (gamma != referenceGamma)
+    {
+      std::cerr << "Error: comigration number " << gamma
+                << " does not match reference " << referenceGamma
+                << " for '" << filenameT << "'" << std::endl;
+      return 1;
+    }
+
+    std::cout << filenameT << "\t"
+      << lemon::countNodes(T.tree()) << "\t"
+      << T.getNrAnatomicalSites() << "\t"
+      << gamma << "\t"
+      << 1000 * referenceTimer.realTime() / nrRepetitions << "\t"
+      << 1000 * timer.realTime() / nrRepetitions << "\t"
+      << referenceTimer.realTime() / timer.realTime()
+      << std::endl;
+  }
+
+  std::cerr << "Total time: " << totalReferenceTime << " s (reference), "
+            << totalTime << " s (speedup: " << totalReferenceTime / totalTime << ")" << std::endl;
+
+  return 0;
+}
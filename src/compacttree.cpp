@@ -0,0 +1,215 @@
+/*
+ * compacttree.cpp
+ *
+ *  Created on: 18-oct-2026
+ *      Author: M. El-Kebir
+ */
+
+#include "compacttree.h"
+
+CompactTree::CompactTree()
+  : _node()
+  , _index()
+  , _parent()
+  , _end()
+  , _depth()
+  , _childOffset(1, 0)
+  , _child()
+  , _leafBegin(1, 0)
+  , _leaf()
+  , _first()
+  , _log()
+  , _sparse()
+{
+}
+
+CompactTree::CompactTree(const Digraph& T,
+                         Node root)
+  : _node()
+  , _index()
+  , _parent()
+  , _end()
+  , _depth()
+  , _childOffset()
+  , _child()
+  , _leafBegin()
+  , _leaf()
+  , _first()
+  , _log()
+  , _sparse()
+{
+  init(T, root);
+}
+
+void CompactTree::init(const Digraph& T,
+                       Node root)
+{
+  _node.clear();
+  _index.assign(T.maxNodeId() + 1, -1);
+  _parent.clear();
+  _depth.clear();
+  _leaf.clear();
+  
+  // 1. Preorder, parents and depths
+  NodeVector stack;
+  IntVector stackParent;
+  if (root != lemon::INVALID)
+  {
+    stack.push_back(root);
+    stackParent.push_back(-1);
+  }
+  while (!stack.empty())
+  {
+    const Node u = stack.back();
+    const int p = stackParent.back();
+    stack.pop_back();
+    stackParent.pop_back();
+    
+    if (_index[Digraph::id(u)] != -1)
+    {
+      // not a tree, only the first visit is kept
+      continue;
+    }
+    
+    const int i = _node.size();
+    _index[Digraph::id(u)] = i;
+    _node.push_back(u);
+    _parent.push_back(p);
+    _depth.push_back(p == -1 ? 0 : _depth[p] + 1);
+    
+    // push children in reverse such that the first child is visited first
+    const int top = stack.size();
+    for (OutArcIt a(T, u); a != lemon::INVALID; ++a)
+    {
+      stack.push_back(T.target(a));
+      stackParent.push_back(i);
+    }
+    std::reverse(stack.begin() + top, stack.end());
+  }
+  
+  const int n = _node.size();
+  
+  // 2. Children in CSR format, subtree intervals and leaf ranks
+  _childOffset.assign(n + 1, 0);
+  for (int i = 1; i < n; ++i)
+  {
+    ++_childOffset[_parent[i] + 1];
+  }
+  for (int i = 0; i < n; ++i)
+  {
+    _childOffset[i + 1] += _childOffset[i];
+  }
+  _child.assign(n > 0 ? n - 1 : 0, -1);
+  IntVector pos(_childOffset.begin(), _childOffset.end() - 1);
+  for (int i = 1; i < n; ++i)
+  {
+    _child[pos[_parent[i]]++] = i;
+  }
+  
+  _end.assign(n, 0);
+  for (int i = n - 1; i >= 0; --i)
+  {
+    const int lastChildOffset = _childOffset[i + 1] - 1;
+    _end[i] = lastChildOffset >= _childOffset[i] ? _end[_child[lastChildOffset]] : i + 1;
+  }
+  
+  _leafBegin.assign(n + 1, 0);
+  for (int i = 0; i < n; ++i)
+  {
+    const bool leaf = _childOffset[i] == _childOffset[i + 1];
+    if (leaf)
+    {
+      _leaf.push_back(i);
+    }
+    _leafBegin[i + 1] = _leafBegin[i] + (leaf ? 1 : 0);
+  }
+  
+  // 3. Euler tour
+  IntVector euler;
+  euler.reserve(n > 0 ? 2 * n - 1 : 0);
+  _first.assign(n, -1);
+  if (n > 0)
+  {
+    // second component is the next child to visit
+    std::vector<IntPair> eulerStack(1, IntPair(0, _childOffset[0]));
+    _first[0] = 0;
+    euler.push_back(0);
+    while (!eulerStack.empty())
+    {
+      IntPair& top = eulerStack.back();
+      const int i = top.first;
+      if (top.second < _childOffset[i + 1])
+      {
+        const int j = _child[top.second++];
+        _first[j] = euler.size();
+        euler.push_back(j);
+        eulerStack.push_back(IntPair(j, _childOffset[j]));
+      }
+      else
+      {
+        eulerStack.pop_back();
+        if (!eulerStack.empty())
+        {
+          euler.push_back(eulerStack.back().first);
+        }
+      }
+    }
+  }
+  
+  // 4. Sparse table over the Euler tour
+  const int m = euler.size();
+  _log.assign(m + 1, 0);
+  for (int l = 2; l <= m; ++l)
+  {
+    _log[l] = _log[l / 2] + 1;
+  }
+  
+  _sparse.assign(1, euler);
+  for (int k = 1; (1 << k) <= m; ++k)
+  {
+    const IntVector& prev = _sparse[k - 1];
+    IntVector cur(m - (1 << k) + 1);
+    for (int l = 0; l < cur.size(); ++l)
+    {
+      cur[l] = std::min(prev[l], prev[l + (1 << (k - 1))]);
+    }
+    _sparse.push_back(cur);
+  }
+}
+
+Node CompactTree::getLCA(const NodeSet& nodes) const
+{
+  if (nodes.empty())
+  {
+    return lemon::INVALID;
+  }
+  
+  NodeSet::const_iterator it = nodes.begin();
+  int lca = index(*it);
+  for (++it; it != nodes.end(); ++it)
+  {
+    lca = getLCA(lca, index(*it));
+  }
+  
+  return _node[lca];
+}
+
+NodeSet CompactTree::leafSubset(Node u) const
+{
+  NodeSet res;
+  for (int r = leafBegin(u); r < leafEnd(u); ++r)
+  {
+    res.insert(leaf(r));
+  }
+  return res;
+}
+
+BoolVector CompactTree::leafBitset(Node u) const
+{
+  BoolVector res(_leaf.size(), false);
+  for (int r = leafBegin(u); r < leafEnd(u); ++r)
+  {
+    res[r] = true;
+  }
+  return res;
+}
@@ -0,0 +1,242 @@
+/*
+ * compacttree.h
+ *
+ *  Created on: 18-oct-2026
+ *      Author: M. El-Kebir
+ */
+
+#ifndef COMPACTTREE_H
+#define COMPACTTREE_H
+
+#include "utils.h"
+
+/// This class models a frozen, array-based view of a rooted tree.
+/// Nodes are stored in preorder, such that the subtree rooted at a node
+/// occupies a contiguous interval of preorder indices and the leaves
+/// of that subtree occupy a contiguous interval of leaf ranks.
+/// Ancestor queries take O(1) time, LCA queries take O(1) time after
+/// O(n log n) preprocessing (sparse table over the Euler tour).
+/// The view must be rebuilt whenever the underlying tree is modified.
+class CompactTree
+{
+public:
+  /// Default constructor
+  CompactTree();
+  
+  /// Constructor
+  ///
+  /// @param T Directed graph
+  /// @param root Root node
+  CompactTree(const Digraph& T,
+              Node root);
+  
+  /// (Re)build view of the given tree
+  ///
+  /// @param T Directed graph
+  /// @param root Root node
+  void init(const Digraph& T,
+            Node root);
+  
+  /// Return the number of nodes
+  int getNrNodes() const
+  {
+    return _node.size();
+  }
+  
+  /// Return the number of leaves
+  int getNrLeaves() const
+  {
+    return _leaf.size();
+  }
+  
+  /// Return the preorder index of a node
+  ///
+  /// @param u Node
+  int index(Node u) const
+  {
+    assert(Digraph::id(u) < _index.size());
+    return _index[Digraph::id(u)];
+  }
+  
+  /// Return the node with the given preorder index
+  ///
+  /// @param i Preorder index
+  Node node(int i) const
+  {
+    assert(0 <= i && i < _node.size());
+    return _node[i];
+  }
+  
+  /// Return the root node
+  Node root() const
+  {
+    return _node.empty() ? lemon::INVALID : _node.front();
+  }
+  
+  /// Return parent node. If u is the root lemon::INVALID is returned.
+  ///
+  /// @param u Node
+  Node parent(Node u) const
+  {
+    const int p = _parent[index(u)];
+    return p == -1 ? lemon::INVALID : _node[p];
+  }
+  
+  /// Return the depth of a node. The root node has depth 0.
+  ///
+  /// @param u Node
+  int depth(Node u) const
+  {
+    return _depth[index(u)];
+  }
+  
+  /// Return the number of children of a node
+  ///
+  /// @param u Node
+  int getNrChildren(Node u) const
+  {
+    const int i = index(u);
+    return _childOffset[i + 1] - _childOffset[i];
+  }
+  
+  /// Return the k-th child of a node
+  ///
+  /// @param u Node
+  /// @param k Child index
+  Node child(Node u, int k) const
+  {
+    assert(0 <= k && k < getNrChildren(u));
+    return _node[_child[_childOffset[index(u)] + k]];
+  }
+  
+  /// Decide whether a node is a leaf
+  ///
+  /// @param u Node
+  bool isLeaf(Node u) const
+  {
+    return getNrChildren(u) == 0;
+  }
+  
+  /// Decide whether one node is an ancestor (or self) of another
+  ///
+  /// @param u Node
+  /// @param v Node
+  bool isAncestor(Node u, Node v) const
+  {
+    const int i = index(u);
+    const int j = index(v);
+    return i <= j && j < _end[i];
+  }
+  
+  /// Return the LCA of two nodes
+  ///
+  /// @param u Node
+  /// @param v Node
+  Node getLCA(Node u, Node v) const
+  {
+    return _node[getLCA(index(u), index(v))];
+  }
+  
+  /// Return the LCA of the provided set of nodes,
+  /// lemon::INVALID is returned if the set is empty
+  ///
+  /// @param nodes Node set
+  Node getLCA(const NodeSet& nodes) const;
+  
+  /// Return the leaf with the given leaf rank
+  ///
+  /// @param r Leaf rank
+  Node leaf(int r) const
+  {
+    assert(0 <= r && r < _leaf.size());
+    return _node[_leaf[r]];
+  }
+  
+  /// Return the smallest leaf rank in the subtree rooted at the given node
+  ///
+  /// @param u Node
+  int leafBegin(Node u) const
+  {
+    return _leafBegin[index(u)];
+  }
+  
+  /// Return one past the largest leaf rank in the subtree rooted
+  /// at the given node
+  ///
+  /// @param u Node
+  int leafEnd(Node u) const
+  {
+    return _leafBegin[_end[index(u)]];
+  }
+  
+  /// Return the number of leaves in the subtree rooted at the given node
+  ///
+  /// @param u Node
+  int getNrLeaves(Node u) const
+  {
+    return leafEnd(u) - leafBegin(u);
+  }
+  
+  /// Return the set of leaves that occur in the subtree rooted at the
+  /// provided node
+  ///
+  /// @param u Node
+  NodeSet leafSubset(Node u) const;
+  
+  /// Return the leaves that occur in the subtree rooted at the provided node
+  /// as a bit vector indexed by leaf rank
+  ///
+  /// @param u Node
+  BoolVector leafBitset(Node u) const;
+
+private:
+  /// Return the preorder index of the LCA of the nodes
+  /// with the given preorder indices
+  ///
+  /// @param i Preorder index
+  /// @param j Preorder index
+  int getLCA(int i, int j) const
+  {
+    int l = _first[i];
+    int r = _first[j];
+    if (l > r)
+    {
+      std::swap(l, r);
+    }
+    
+    // every node visited by the Euler tour in between is a descendant
+    // of the LCA, which has the smallest preorder index among them
+    const int k = _log[r - l + 1];
+    return std::min(_sparse[k][l], _sparse[k][r - (1 << k) + 1]);
+  }
+
+private:
+  /// Nodes in preorder
+  NodeVector _node;
+  /// Preorder index of a node indexed by Digraph::id (-1 if absent)
+  IntVector _index;
+  /// Preorder index of parent (-1 for the root)
+  IntVector _parent;
+  /// One past the largest preorder index in the subtree
+  IntVector _end;
+  /// Depth
+  IntVector _depth;
+  /// Children of preorder index i are _child[_childOffset[i]..._childOffset[i+1]-1]
+  IntVector _childOffset;
+  /// Preorder indices of children
+  IntVector _child;
+  /// Leaf rank of the first leaf at or after a preorder index,
+  /// has one extra entry equal to the number of leaves
+  IntVector _leafBegin;
+  /// Preorder indices of leaves by leaf rank
+  IntVector _leaf;
+  /// Position of first occurrence of a preorder index in the Euler tour
+  IntVector _first;
+  /// Floor of base-2 logarithm
+  IntVector _log;
+  /// _sparse[k][l] is the smallest preorder index in the Euler tour
+  /// positions l...l+2^k-1
+  IntMatrix _sparse;
+};
+
+#endif // COMPACTTREE_H
@@ -8,6 +8,7 @@
 #include "enumeratemutationtrees.h"
 #include "rootedcladisticnoisysparseenumeration.h"
 #include "spruce/rootedcladisticnoisyenumeration.h"
+#include <cstdio>
 
 EnumerateMutationTrees::EnumerateMutationTrees(const FrequencyMatrix& F)
   : _F(F)
@@ -15,11 +16,195 @@ EnumerateMutationTrees::EnumerateMutationTrees(const FrequencyMatrix& F)
 {
 }
 
+class EnumerateMutationTrees::TreeWriter : public gm::RootedCladisticEnumeration::SolutionSink
+{
+public:
+  /// Constructor
+  ///
+  /// @param enumerate Enumeration
+  /// @param outputDirectory Output directory, trees are spooled to
+  /// a temporary file if empty
+  TreeWriter(const EnumerateMutationTrees& enumerate,
+             const std::string& outputDirectory)
+    : _enumerate(enumerate)
+    , _outputDirectory(outputDirectory)
+    , _pSpool(outputDirectory.empty() ? std::tmpfile() : NULL)
+    , _spoolSize(0)
+    , _nrTrees(0)
+    , _nrFiles(0)
+  {
+  }
+  
+  /// Destructor
+  ~TreeWriter()
+  {
+    if (_pSpool)
+    {
+      fclose(_pSpool);
+    }
+  }
+  
+  /// Return whether the trees can be written
+  bool good() const
+  {
+    return !_outputDirectory.empty() || _pSpool != NULL;
+  }
+  
+  /// Discard the trees written so far
+  virtual void clear()
+  {
+    _nrTrees = 0;
+    _spoolSize = 0;
+  }
+  
+  /// Write the mutation tree of the given solution
+  ///
+  /// @param sol Solution
+  virtual void add(const gm::Solution& sol)
+  {
+    CloneTree T = _enumerate.getMutationTree(sol);
+    if (!_outputDirectory.empty())
+    {
+      char buf[1024];
+      snprintf(buf, 1024, "%s/barT%d.tree", _outputDirectory.c_str(), _nrTrees);
+      
+      std::ofstream outBarT(buf);
+      T.write(outBarT);
+      outBarT.close();
+      
+      _nrFiles = std::max(_nrFiles, _nrTrees + 1);
+    }
+    else
+    {
+      std::stringstream ss;
+      ss << lemon::countArcs(T.tree()) << " #edges, tree " << _nrTrees + 1 << std::endl;
+      T.write(ss);
+      
+      // discarded trees are overwritten
+      const std::string str = ss.str();
+      fseek(_pSpool, _spoolSize, SEEK_SET);
+      fwrite(str.c_str(), 1, str.size(), _pSpool);
+      _spoolSize += str.size();
+    }
+    ++_nrTrees;
+  }
+  
+  /// Return the number of trees
+  int getNrTrees() const
+  {
+    return _nrTrees;
+  }
+  
+  /// Remove the files of discarded trees
+  void finalize()
+  {
+    for (int idx = _nrTrees; idx < _nrFiles; ++idx)
+    {
+      char buf[1024];
+      snprintf(buf, 1024, "%s/barT%d.tree", _outputDirectory.c_str(), idx);
+      std::remove(buf);
+    }
+    _nrFiles = _nrTrees;
+  }
+  
+  /// Write the spooled trees in the format of operator<<
+  ///
+  /// @param out Output stream
+  void write(std::ostream& out) const
+  {
+    out << _nrTrees << " #trees" << std::endl;
+    
+    char buf[65536];
+    rewind(_pSpool);
+    for (long remaining = _spoolSize; remaining > 0;)
+    {
+      size_t count = fread(buf, 1, std::min<long>(remaining, sizeof(buf)), _pSpool);
+      if (count == 0)
+        break;
+      out.write(buf, count);
+      remaining -= count;
+    }
+  }
+  
+private:
+  /// Enumeration
+  const EnumerateMutationTrees& _enumerate;
+  /// Output directory
+  const std::string _outputDirectory;
+  /// Temporary file with the trees written so far
+  FILE* _pSpool;
+  /// Number of valid bytes in the temporary file
+  long _spoolSize;
+  /// Number of trees
+  int _nrTrees;
+  /// Number of tree files in the output directory
+  int _nrFiles;
+};
+
 void EnumerateMutationTrees::enumerate(const std::string& outputDirectory,
                                        const int nrThreads,
                                        const int limit,
                                        const int timeLimit,
                                        TreeVector& mutationTrees)
+{
+  enumerate(nrThreads, limit, timeLimit, NULL, mutationTrees);
+  
+  if (!outputDirectory.empty())
+  {
+    for (int idx = 0; idx < mutationTrees.size(); ++idx)
+    {
+      char buf[1024];
+      snprintf(buf, 1024, "%s/barT%d.tree", outputDirectory.c_str(), idx);
+      
+      std::ofstream outBarT(buf);
+      
+      mutationTrees[idx].write(outBarT);
+      
+      outBarT.close();
+    }
+  }
+  
+  std::cerr << "Found " << mutationTrees.size() << " mutation trees with "
+            << _nrCharactersInTrees << " out of "
+            << _F.getNrCharacters() << " mutations" << std::endl;
+}
+
+int EnumerateMutationTrees::enumerate(const std::string& outputDirectory,
+                                      const int nrThreads,
+                                      const int limit,
+                                      const int timeLimit,
+                                      std::ostream& out)
+{
+  TreeWriter writer(*this, outputDirectory);
+  if (!writer.good())
+  {
+    std::cerr << "Error: could not create temporary file" << std::endl;
+    return -1;
+  }
+  
+  TreeVector mutationTrees;
+  enumerate(nrThreads, limit, timeLimit, &writer, mutationTrees);
+  writer.finalize();
+  
+  if (outputDirectory.empty())
+  {
+    out << "# " << _nrCharactersInTrees << " out of "
+        << _F.getNrCharacters() << " mutations" << std::endl;
+    writer.write(out);
+  }
+  
+  std::cerr << "Found " << writer.getNrTrees() << " mutation trees with "
+            << _nrCharactersInTrees << " out of "
+            << _F.getNrCharacters() << " mutations" << std::endl;
+  
+  return writer.getNrTrees();
+}
+
+void EnumerateMutationTrees::enumerate(const int nrThreads,
+                                       const int limit,
+                                       const int timeLimit,
+                                       TreeWriter* pWriter,
+                                       TreeVector& mutationTrees)
 {
   // 1. Construct frequency tensors F_lb and F_ub
   RealTensor F_lb, F_ub;
@@ -44,81 +229,74 @@ void EnumerateMutationTrees::enumerate(const std::string& outputDirectory,
                                                 false,
                                                 IntSet());
   
+  // trees are written as they are found
+  enumerate.setSink(pWriter);
   enumerate.run();
   
   _nrCharactersInTrees = enumerate.objectiveValue();
   
-  gm::SolutionSet solutionSet;
-  enumerate.populateSolutionSet(solutionSet);
-  
   // 4. Transform enumerated mutation trees to the right format
   mutationTrees.clear();
+  if (pWriter)
+    return;
+  
+  gm::SolutionSet solutionSet;
+  enumerate.populateSolutionSet(solutionSet);
   
   int nrSolutions = solutionSet.solutionCount();
   for (int idx = 0; idx < nrSolutions; ++idx)
   {
-    const gm::Solution& sol = solutionSet.solution(idx);
-    gm::PerfectPhyloTree phyloT(sol.A(), sol.S());
+    mutationTrees.push_back(getMutationTree(solutionSet.solution(idx)));
+  }
+}
     
-    const Digraph& T = phyloT.T();
-    NodeNodeMap old2new(T, lemon::INVALID);
+CloneTree EnumerateMutationTrees::getMutationTree(const gm::Solution& sol) const
+{
+  gm::PerfectPhyloTree phyloT(sol.A(), sol.S());
     
-    Digraph newT;
-    Node newRoot = lemon::INVALID;
-    StringNodeMap idMap(newT, "");
-    StringNodeMap l(newT, "");
+  const Digraph& T = phyloT.T();
+  NodeNodeMap old2new(T, lemon::INVALID);
     
-    // Copy vertices
-    for (NodeIt v(T); v != lemon::INVALID; ++v)
+  Digraph newT;
+  Node newRoot = lemon::INVALID;
+  StringNodeMap idMap(newT, "");
+  StringNodeMap l(newT, "");
+  
+  // Copy vertices
+  for (NodeIt v(T); v != lemon::INVALID; ++v)
+  {
+    if (v != phyloT.root())
     {
-      if (v != phyloT.root())
-      {
-        Node vv = newT.addNode();
-        old2new[v] =  vv;
-        assert(phyloT.nodeToCharState(v).second == 1);
-        idMap[vv] = _F.indexToCharacter(phyloT.nodeToCharState(v).first);
-      }
+      Node vv = newT.addNode();
+      old2new[v] =  vv;
+      assert(phyloT.nodeToCharState(v).second == 1);
+      idMap[vv] = _F.indexToCharacter(phyloT.nodeToCharState(v).first);
     }
+  }
+  
+  for (ArcIt a(T); a != lemon::INVALID; ++a)
+  {
+    Node u = T.source(a);
+    Node v = T.target(a);
     
-    for (ArcIt a(T); a != lemon::INVALID; ++a)
+    if (u != phyloT.root())
     {
-      Node u = T.source(a);
-      Node v = T.target(a);
+      Node uu = old2new[u];
+      Node vv = old2new[v];
       
-      if (u != phyloT.root())
-      {
-        Node uu = old2new[u];
-        Node vv = old2new[v];
-        
-        newT.addArc(uu, vv);
-      }
-      else
-      {
-        // phyloT needs to have monoclonal origin
-        // (i.e. v_(*,0) has only a single child)
-        assert(newRoot == lemon::INVALID);
-        
-        newRoot = old2new[v];
-      }
+      newT.addArc(uu, vv);
     }
-    
-    mutationTrees.push_back(CloneTree(newT, newRoot, idMap, l));
-    if (!outputDirectory.empty())
+    else
     {
-      char buf[1024];
-      snprintf(buf, 1024, "%s/barT%d.tree", outputDirectory.c_str(), idx);
+      // phyloT needs to have monoclonal origin
+      // (i.e. v_(*,0) has only a single child)
+      assert(newRoot == lemon::INVALID);
       
-      std::ofstream outBarT(buf);
-      
-      mutationTrees.back().write(outBarT);
-      
-      outBarT.close();
+      newRoot = old2new[v];
     }
   }
   
-  std::cerr << "Found " << mutationTrees.size() << " mutation trees with "
-            << _nrCharactersInTrees << " out of "
-            << _F.getNrCharacters() << " mutations" << std::endl;
+  return CloneTree(newT, newRoot, idMap, l);
 }
 
 void EnumerateMutationTrees::getFrequencyTensor(RealTensor& F_lb,
@@ -11,6 +11,7 @@
 #include "frequencymatrix.h"
 #include "clonetree.h"
 #include "spruce/realtensor.h"
+#include "spruce/solution.h"
 
 /// This class enumerates all mutation trees given a frequency matrix
 class EnumerateMutationTrees
@@ -36,6 +37,23 @@ public:
                  const int timeLimit,
                  TreeVector& mutationTrees);
   
+  /// Enumerate mutation trees, which are written out as they are found
+  /// rather than kept in memory
+  ///
+  /// @param outputDirectory Output directory, may be empty
+  /// @param nrThreads Number of threads to use in the enumeration
+  /// @param limit Maximum number of trees to enumerate
+  /// @param timeLimit Time limit for the enumeration
+  /// @param out Output stream that the trees are written to
+  /// if outputDirectory is empty
+  ///
+  /// @return Number of enumerated mutation trees
+  int enumerate(const std::string& outputDirectory,
+                const int nrThreads,
+                const int limit,
+                const int timeLimit,
+                std::ostream& out);
+  
   /// Return number of mutations in the enumerated trees
   int getNrCharactersInTrees() const
   {
@@ -72,6 +90,28 @@ public:
   }
   
 private:
+  /// Streams enumerated mutation trees to disk
+  class TreeWriter;
+  
+  /// Enumerate mutation trees
+  ///
+  /// @param nrThreads Number of threads to use in the enumeration
+  /// @param limit Maximum number of trees to enumerate
+  /// @param timeLimit Time limit for the enumeration
+  /// @param pWriter Writer that the trees are streamed to, may be NULL
+  /// @param mutationTrees Vector to store enumerated mutation trees
+  /// if pWriter is NULL
+  void enumerate(const int nrThreads,
+                 const int limit,
+                 const int timeLimit,
+                 TreeWriter* pWriter,
+                 TreeVector& mutationTrees);
+  
+  /// Return the mutation tree of the given enumerated solution
+  ///
+  /// @param sol Solution
+  CloneTree getMutationTree(const gm::Solution& sol) const;
+  
   /// Construct frequency tensor (dimension: 2 * k * n)
   ///
   /// @param F_lb Frequency lower bounds
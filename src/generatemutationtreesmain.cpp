@@ -73,20 +73,15 @@ int main(int argc, char** argv)
   }
   else
   {
-    EnumerateMutationTrees::TreeVector trees;
+    // trees are streamed to disk rather than kept in memory
     EnumerateMutationTrees enumerate(F);
-    enumerate.enumerate(outputDirectory,
-                        nrThreads,
-                        limit,
-                        timeLimit,
-                        trees);
-    
-    if (outputDirectory.empty())
+    if (enumerate.enumerate(outputDirectory,
+                            nrThreads,
+                            limit,
+                            timeLimit,
+                            std::cout) < 0)
     {
-      std::cout << "# " << enumerate.getNrCharactersInTrees()
-                << " out of " << F.getNrCharacters() << " mutations"
-                << std::endl;
-      std::cout << trees;
+      return 1;
     }
   }
   
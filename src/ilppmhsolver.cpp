@@ -7,6 +7,8 @@
 
 #include "ilppmhsolver.h"
 #include <lemon/time_measure.h>
+#include <fstream>
+#include <sstream>
 
 IlpPmhSolver::IlpPmhSolver(const CloneTree& T,
                            const std::string& primary,
@@ -17,6 +19,7 @@ IlpPmhSolver::IlpPmhSolver(const CloneTree& T,
   , _primary(primary)
   , _pattern(pattern)
   , _forcedComigrations(forcedComigrations)
+  , _nrSharedConstrs(-1)
   , _lca()
   , _anatomicalSiteToIndex()
   , _indexToAnatomicalSite()
@@ -26,8 +29,20 @@ IlpPmhSolver::IlpPmhSolver(const CloneTree& T,
   , _pArcToIndex(NULL)
   , _primaryIndex(-1)
   , _L()
-  , _env(gurobiLogFilename)
-  , _model(_env)
+  , _subLabelOffset()
+  , _indexToSubLabel()
+  , _presentSites()
+  , _nrPrunedVars(0)
+  , _presolve(false)
+  , _contractedTo()
+  , _symmetricLeaves()
+  , _nrContractedVars(0)
+  , _nrContractedConstrs(0)
+  , _nrSymmetryConstrs(0)
+  , _warmStart(false)
+  , _pCache(NULL)
+  , _model(gurobiLogFilename)
+  , _profiler()
   , _x()
   , _y()
   , _z()
@@ -53,28 +68,76 @@ IlpPmhSolver::~IlpPmhSolver()
 
 void IlpPmhSolver::init(const IntTriple& bounds)
 {
+  _profiler.start("initIndices");
   initIndices();
+  _profiler.start("initReachability");
+  initReachability();
+  _profiler.start("initPresolve");
+  initPresolve();
+  _profiler.start("initVariables");
   initVariables();
+  _profiler.start("initLeafVariables");
   initLeafVariables();
+  _profiler.start("initVertexLabelingConstraints");
   initVertexLabelingConstraints();
-  initForcedComigrations();
+  _profiler.start("initConstraintsG");
   initConstraintsG();
+  _profiler.start("initConstraintsNonEdgesG");
   initConstraintsNonEdgesG();
+  _profiler.start("initConstraints");
   initConstraints();
+  _profiler.start("initLeafConstraints");
   initLeafConstraints();
+  _profiler.start("initSymmetryConstraints");
+  initSymmetryConstraints();
+  _profiler.start("initObjective");
   initObjective(bounds);
+  _profiler.start("initCallbacks");
   initCallbacks();
+  _profiler.start("initWarmStart");
   initWarmStart();
+  
+  // constraints added from here on are replaced by update()
+  _nrSharedConstrs = _model.getNrConstrs();
+  _profiler.start("initPatternConstraints");
+  initPatternConstraints();
+  _profiler.start("initForcedComigrations");
+  initForcedComigrations();
+  _profiler.stop();
+}
+
+void IlpPmhSolver::update(MigrationGraph::Pattern pattern,
+                          const StringPairList& forcedComigrations)
+{
+  _pattern = pattern;
+  _forcedComigrations = forcedComigrations;
+  
+  if (isInitialized())
+  {
+    _profiler.start("update");
+    _model.removeConstrs(_nrSharedConstrs);
+    initPatternConstraints();
+    initForcedComigrations();
+    _model.setStartFromSolution();
+    _profiler.stop();
+  }
 }
 
 void IlpPmhSolver::initWarmStart()
 {
+  if (_warmStart && initHeuristicWarmStart())
+  {
+    return;
+  }
+  
   const int nrAnatomicalSites = _anatomicalSiteToIndex.size();
   for (NodeIt v_i(getTree()); v_i != lemon::INVALID; ++v_i)
   {
     if (isLeaf(v_i)) continue;
     
     const int i = (*_pNodeToIndex)[v_i];
+    if (isContracted(i)) continue;
+    
     for (int s = 0; s < nrAnatomicalSites; ++s)
     {
       const int size_L_s = _L[s].size();
@@ -82,14 +145,548 @@ void IlpPmhSolver::initWarmStart()
       {
         if (s == _primaryIndex && c == 0)
         {
-          _x[i][s][c].set(GRB_DoubleAttr_Start, 1);
+          _x[i][s][c].setStart(1);
         }
         else
         {
-          _x[i][s][c].set(GRB_DoubleAttr_Start, 0);
+          _x[i][s][c].setStart(0);
+        }
+      }
+    }
+  }
+}
+
+bool IlpPmhSolver::initHeuristicWarmStart()
+{
+  const int nrAnatomicalSites = _anatomicalSiteToIndex.size();
+  const int nrNodes = _indexToNode.size();
+  
+  IntVector order;
+  IntVector parent(nrNodes, -1);
+  IntVector stack(1, (*_pNodeToIndex)[getRoot()]);
+  while (!stack.empty())
+  {
+    const int i = stack.back();
+    stack.pop_back();
+    order.push_back(i);
+    
+    // push children in reverse such that the first child is visited first
+    const int top = stack.size();
+    for (OutArcIt a_ij(getTree(), _indexToNode[i]); a_ij != lemon::INVALID; ++a_ij)
+    {
+      const int j = (*_pNodeToIndex)[getTree().target(a_ij)];
+      parent[j] = i;
+      stack.push_back(j);
+    }
+    std::reverse(stack.begin() + top, stack.end());
+  }
+  
+  BoolMatrix forced(nrAnatomicalSites, BoolVector(nrAnatomicalSites, false));
+  for (const StringPair& st : _forcedComigrations)
+  {
+    forced[_anatomicalSiteToIndex[st.first]][_anatomicalSiteToIndex[st.second]] = true;
+  }
+  
+  // 1. Candidate sets of allowed migrations: all migrations (R),
+  // migrations from the primary tumor only (PS), and the migrations of the
+  // unrestricted labeling (M) as well as the most frequent source of each
+  // anatomical site therein (S)
+  std::vector<BoolMatrix> candidates;
+  BoolMatrix allowed(nrAnatomicalSites, BoolVector(nrAnatomicalSites, true));
+  candidates.push_back(allowed);
+  
+  for (int s = 0; s < nrAnatomicalSites; ++s)
+  {
+    for (int t = 0; t < nrAnatomicalSites; ++t)
+    {
+      allowed[s][t] = s == _primaryIndex || forced[s][t];
+    }
+  }
+  candidates.push_back(allowed);
+  
+  IntVector state;
+  if (labelVertices(order, parent, candidates.front(), state))
+  {
+    IntMatrix count(nrAnatomicalSites, IntVector(nrAnatomicalSites, 0));
+    for (int i : order)
+    {
+      const int p = parent[i];
+      if (p == -1 || state[i] == -1 || state[i] == state[p]) continue;
+      
+      const int s = state[p] == nrAnatomicalSites ? _primaryIndex : state[p];
+      ++count[s][state[i]];
+    }
+    
+    for (int s = 0; s < nrAnatomicalSites; ++s)
+    {
+      for (int t = 0; t < nrAnatomicalSites; ++t)
+      {
+        allowed[s][t] = count[s][t] > 0 || forced[s][t];
+      }
+    }
+    candidates.push_back(allowed);
+    
+    for (int t = 0; t < nrAnatomicalSites; ++t)
+    {
+      int source = _primaryIndex;
+      for (int s = 0; s < nrAnatomicalSites; ++s)
+      {
+        if (count[s][t] > count[source][t])
+        {
+          source = s;
+        }
+      }
+      for (int s = 0; s < nrAnatomicalSites; ++s)
+      {
+        allowed[s][t] = s == source || forced[s][t];
+      }
+    }
+    candidates.push_back(allowed);
+  }
+  
+  // 2. Greedy local search: disallow the migration whose removal
+  // improves the objective value the most until no improvement is found
+  IntVector bestSubLabel;
+  double bestObj = std::numeric_limits<double>::max();
+  IntVector subLabel;
+  double obj;
+  for (BoolMatrix& candidate : candidates)
+  {
+    if (!labelVertices(order, parent, candidate, state)
+        || !getSubLabeling(order, parent, state, subLabel, obj))
+    {
+      continue;
+    }
+    
+    // only migrations of the current labeling need to be considered
+    for (BoolVector& row : candidate)
+    {
+      std::fill(row.begin(), row.end(), false);
+    }
+    for (int i : order)
+    {
+      const int p = parent[i];
+      if (p == -1 || state[i] == -1 || state[i] == state[p]) continue;
+      
+      candidate[state[p] == nrAnatomicalSites ? _primaryIndex : state[p]][state[i]] = true;
+    }
+    for (int s = 0; s < nrAnatomicalSites; ++s)
+    {
+      for (int t = 0; t < nrAnatomicalSites; ++t)
+      {
+        candidate[s][t] = candidate[s][t] || forced[s][t];
+      }
+    }
+    
+    bool improved = true;
+    while (improved)
+    {
+      improved = false;
+      
+      int bestS = -1, bestT = -1;
+      IntVector candidateSubLabel = subLabel;
+      for (int s = 0; s < nrAnatomicalSites; ++s)
+      {
+        for (int t = 0; t < nrAnatomicalSites; ++t)
+        {
+          if (!candidate[s][t] || forced[s][t]) continue;
+          
+          candidate[s][t] = false;
+          double candidateObj;
+          if (labelVertices(order, parent, candidate, state)
+              && getSubLabeling(order, parent, state, candidateSubLabel, candidateObj)
+              && candidateObj < obj - 1e-9)
+          {
+            obj = candidateObj;
+            subLabel = candidateSubLabel;
+            bestS = s;
+            bestT = t;
+          }
+          candidate[s][t] = true;
+        }
+      }
+      
+      if (bestS != -1)
+      {
+        candidate[bestS][bestT] = false;
+        improved = true;
+      }
+    }
+    
+    if (obj < bestObj)
+    {
+      bestObj = obj;
+      bestSubLabel = subLabel;
+    }
+  }
+  
+  if (bestSubLabel.empty())
+  {
+    return false;
+  }
+  
+  setStart(bestSubLabel);
+  return true;
+}
+
+bool IlpPmhSolver::labelVertices(const IntVector& order,
+                                 const IntVector& parent,
+                                 const BoolMatrix& allowed,
+                                 IntVector& state) const
+{
+  const int nrAnatomicalSites = _anatomicalSiteToIndex.size();
+  const int nrNodes = _indexToNode.size();
+  const int nrStates = nrAnatomicalSites + 1;
+  const int rootState = nrAnatomicalSites;
+  const int inf = std::numeric_limits<int>::max() / 2;
+  
+  // state rootState denotes (P,0), which cannot be entered by a migration
+  auto migrationCost = [&](int a, int b)
+  {
+    if (a == b)
+      return 0;
+    if (b == rootState)
+      return inf;
+    const int s = a == rootState ? _primaryIndex : a;
+    return s != b && allowed[s][b] ? 1 : inf;
+  };
+  
+  // cost[i][a] is the minimum number of migrations in the subtree rooted
+  // at v_i given that v_i has state a
+  IntMatrix cost(nrNodes, IntVector(nrStates, inf));
+  for (int r = order.size() - 1; r >= 0; --r)
+  {
+    const int i = order[r];
+    const Node v_i = _indexToNode[i];
+    if (isLeaf(v_i))
+    {
+      if (!isRequiredLeaf(v_i)) continue;
+      
+      const int s = _anatomicalSiteToIndex.find(getLeafAnatomicalSiteLabel(v_i))->second;
+      cost[i][s] = 0;
+      if (s == _primaryIndex)
+      {
+        cost[i][rootState] = 0;
+      }
+      continue;
+    }
+    
+    for (int a = 0; a < nrStates; ++a)
+    {
+      // vertices labeled by (s,c) != (P,0) have a descendant leaf labeled by s
+      if (a != rootState && !_presentSites[i][a]) continue;
+      
+      int sum = 0;
+      for (OutArcIt a_ij(getTree(), v_i); a_ij != lemon::INVALID && sum < inf; ++a_ij)
+      {
+        const Node v_j = getTree().target(a_ij);
+        const int j = (*_pNodeToIndex)[v_j];
+        if (isLeaf(v_j) && !isRequiredLeaf(v_j)) continue;
+        
+        int min_j = inf;
+        for (int b = 0; b < nrStates; ++b)
+        {
+          // a contracted vertex has the same sub-label as its child
+          if (isContracted(i) && a != b) continue;
+          min_j = std::min(min_j, cost[j][b] + migrationCost(a, b));
+        }
+        sum = std::min(inf, sum + min_j);
+      }
+      cost[i][a] = sum;
+    }
+  }
+  
+  const int root = order.front();
+  if (cost[root][rootState] >= inf)
+  {
+    return false;
+  }
+  
+  // backtrace, preferring the state of the parent
+  state.assign(nrNodes, -1);
+  state[root] = rootState;
+  for (int i : order)
+  {
+    const int p = parent[i];
+    const Node v_i = _indexToNode[i];
+    if (p == -1 || (isLeaf(v_i) && !isRequiredLeaf(v_i))) continue;
+    
+    const int a = state[p];
+    int best = a;
+    int bestCost = cost[i][a];
+    for (int b = 0; b < nrStates; ++b)
+    {
+      if (isContracted(p) && a != b) continue;
+      if (cost[i][b] + migrationCost(a, b) < bestCost)
+      {
+        best = b;
+        bestCost = cost[i][b] + migrationCost(a, b);
+      }
+    }
+    assert(bestCost < inf);
+    state[i] = best;
+  }
+  
+  return true;
+}
+
+bool IlpPmhSolver::getSubLabeling(const IntVector& order,
+                                  const IntVector& parent,
+                                  const IntVector& state,
+                                  IntVector& subLabel,
+                                  double& obj) const
+{
+  const int nrAnatomicalSites = _anatomicalSiteToIndex.size();
+  const int nrNodes = _indexToNode.size();
+  const int rootState = nrAnatomicalSites;
+  
+  // 1. Connected components of vertices with the same state,
+  // in preorder of their roots
+  IntVector comp(nrNodes, -1);
+  IntVector compSite, compParent, compNrLeaves;
+  for (int i : order)
+  {
+    if (state[i] == -1) continue;
+    
+    const int p = parent[i];
+    if (p != -1 && state[p] == state[i])
+    {
+      comp[i] = comp[p];
+    }
+    else
+    {
+      comp[i] = compSite.size();
+      compSite.push_back(state[i] == rootState ? _primaryIndex : state[i]);
+      compParent.push_back(p == -1 ? -1 : comp[p]);
+      compNrLeaves.push_back(0);
+    }
+    
+    if (isLeaf(_indexToNode[i]))
+    {
+      ++compNrLeaves[comp[i]];
+    }
+  }
+  
+  // 2. Migration graph and topological constraint
+  const int nrComps = compSite.size();
+  BoolMatrix gamma(nrAnatomicalSites, BoolVector(nrAnatomicalSites, false));
+  IntVector source(nrAnatomicalSites, -1);
+  bool singleSource = true;
+  for (int c = 1; c < nrComps; ++c)
+  {
+    const int s = compSite[compParent[c]];
+    const int t = compSite[c];
+    gamma[s][t] = true;
+    
+    if (_pattern != MigrationGraph::R && t == _primaryIndex)
+    {
+      // PS, S and M do not allow reseeding of the primary tumor
+      return false;
+    }
+    if (_pattern == MigrationGraph::PS && compParent[c] != 0)
+    {
+      return false;
+    }
+    if (source[t] != -1 && source[t] != s)
+    {
+      singleSource = false;
+    }
+    source[t] = s;
+    
+    if (_pattern == MigrationGraph::M)
+    {
+      for (int d = compParent[c]; d != -1; d = compParent[d])
+      {
+        if (compSite[d] == t)
+        {
+          return false;
+        }
+      }
+    }
+  }
+  if (_pattern == MigrationGraph::S && !singleSource)
+  {
+    return false;
+  }
+  
+  for (const StringPair& st : _forcedComigrations)
+  {
+    if (!gamma[_anatomicalSiteToIndex.find(st.first)->second][_anatomicalSiteToIndex.find(st.second)->second])
+    {
+      return false;
+    }
+  }
+  
+  // 3. Sub-labels of anatomical site s are ordered by non-increasing number
+  // of leaves, the root component is labeled by (P,0) which has a dummy leaf
+  IntVector compSubLabel(nrComps, -1);
+  for (int s = 0; s < nrAnatomicalSites; ++s)
+  {
+    IntVector comps;
+    for (int c = 0; c < nrComps; ++c)
+    {
+      if (compSite[c] == s)
+      {
+        comps.push_back(c);
+      }
+    }
+    std::stable_sort(comps.begin(), comps.end(), [&](int c, int d)
+    {
+      if (c == 0 || d == 0)
+        return c == 0;
+      return compNrLeaves[c] > compNrLeaves[d];
+    });
+    
+    if (comps.size() > _L[s].size())
+    {
+      return false;
+    }
+    for (int k = 0; k < comps.size(); ++k)
+    {
+      const int c = comps[k];
+      if (compNrLeaves[c] == 0)
+      {
+        return false;
+      }
+      if (k > 0 && compNrLeaves[c] > compNrLeaves[comps[k - 1]] + (comps[k - 1] == 0 ? 1 : 0))
+      {
+        return false;
+      }
+      compSubLabel[c] = getSubLabelIndex(s, k);
+    }
+  }
+  
+  subLabel.assign(nrNodes, -1);
+  for (int i = 0; i < nrNodes; ++i)
+  {
+    if (comp[i] == -1) continue;
+    
+    const int k = compSubLabel[comp[i]];
+    const int s = _indexToSubLabel[k].first;
+    const int c = _indexToSubLabel[k].second;
+    if (_x[i][s][c].isNull())
+    {
+      return false;
+    }
+    subLabel[i] = k;
+  }
+  
+  for (const IntTriple& sij : _symmetricLeaves)
+  {
+    if (subLabel[sij.second.first] > subLabel[sij.second.second])
+    {
+      return false;
+    }
+  }
+  
+  // 4. Objective value
+  int nrComigrations = 0;
+  int nrSeedingSites = 0;
+  for (int s = 0; s < nrAnatomicalSites; ++s)
+  {
+    const int n_s = std::count(gamma[s].begin(), gamma[s].end(), true);
+    nrComigrations += n_s;
+    nrSeedingSites += n_s > 0 ? 1 : 0;
+  }
+  
+  obj = (nrComps - 1)
+      + (1. / (nrAnatomicalSites * nrAnatomicalSites)) * nrComigrations
+      + (1. / (nrAnatomicalSites * nrAnatomicalSites)) * (1. / (nrAnatomicalSites + 1)) * nrSeedingSites;
+  
+  return true;
+}
+
+void IlpPmhSolver::setStart(const IntVector& subLabel)
+{
+  const int nrAnatomicalSites = _anatomicalSiteToIndex.size();
+  const int nrNodes = _indexToNode.size();
+  const int nrArcs = _indexToArc.size();
+  const int nrSubLabels = getNrSubLabels();
+  
+  for (int i = 0; i < nrNodes; ++i)
+  {
+    for (int k = 0; k < nrSubLabels; ++k)
+    {
+      const int s = _indexToSubLabel[k].first;
+      const int c = _indexToSubLabel[k].second;
+      _x[i][s][c].setStart(subLabel[i] == k ? 1 : 0);
+    }
+  }
+  
+  // migrations between sub-labels
+  BoolVector used(nrSubLabels, false);
+  for (int i = 0; i < nrNodes; ++i)
+  {
+    if (subLabel[i] != -1)
+    {
+      used[subLabel[i]] = true;
+    }
+  }
+  
+  BoolVector migration(nrSubLabels * nrSubLabels, false);
+  for (int ij = 0; ij < nrArcs; ++ij)
+  {
+    const Arc a_ij = _indexToArc[ij];
+    const int k = subLabel[(*_pNodeToIndex)[getTree().source(a_ij)]];
+    const int l = subLabel[(*_pNodeToIndex)[getTree().target(a_ij)]];
+    const int kl = k == -1 || l == -1 ? -1 : getSubLabelPairIndex(k, l);
+    
+    for (int e = _xx.rowBegin(ij); e < _xx.rowEnd(ij); ++e)
+    {
+      MilpVar xx = _xx.var(e);
+      xx.setStart(_xx.col(e) == kl ? 1 : 0);
+    }
+    
+    if (kl != -1 && k != l)
+    {
+      migration[kl] = true;
+    }
+  }
+  
+  BoolMatrix gamma(nrAnatomicalSites, BoolVector(nrAnatomicalSites, false));
+  for (int k = 0; k < nrSubLabels; ++k)
+  {
+    const int s = _indexToSubLabel[k].first;
+    const int c = _indexToSubLabel[k].second;
+    _y[s][c].setStart(used[k] ? 1 : 0);
+    
+    for (int l = 0; l < nrSubLabels; ++l)
+    {
+      const int t = _indexToSubLabel[l].first;
+      const int d = _indexToSubLabel[l].second;
+      const bool m_kl = migration[getSubLabelPairIndex(k, l)];
+      _z[s][c][t][d].setStart(m_kl ? 1 : 0);
+      gamma[s][t] = gamma[s][t] || m_kl;
+    }
+  }
+  
+  // w[s][t][d][e] = 1 iff both (t,d) and (t,e) have an incoming migration from s
+  for (int s = 0; s < nrAnatomicalSites; ++s)
+  {
+    bool sigma = false;
+    for (int t = 0; t < nrAnatomicalSites; ++t)
+    {
+      const int size_L_t = _L[t].size();
+      BoolVector in(size_L_t, false);
+      for (int d = 0; d < size_L_t; ++d)
+      {
+        for (int c = 0; c < _L[s].size(); ++c)
+        {
+          in[d] = in[d] || migration[getSubLabelPairIndex(getSubLabelIndex(s, c), getSubLabelIndex(t, d))];
+        }
+      }
+      for (int d = 0; d < size_L_t; ++d)
+      {
+        for (int e = 0; e < size_L_t; ++e)
+        {
+          _w[s][t][d][e].setStart(d != e && in[d] && in[e] ? 1 : 0);
         }
       }
+      
+      _gamma[s][t].setStart(gamma[s][t] ? 1 : 0);
+      sigma = sigma || gamma[s][t];
     }
+    _sigma[s].setStart(sigma ? 1 : 0);
   }
 }
 
@@ -151,24 +748,261 @@ void IlpPmhSolver::initIndices()
   int idx = 0;
   for (NodeIt v(getTree()); v != lemon::INVALID; ++v)
   {
-    _indexToNode[idx] = v;
-    _pNodeToIndex->set(v, idx);
-    ++idx;
+    _indexToNode[idx] = v;
+    _pNodeToIndex->set(v, idx);
+    ++idx;
+  }
+  
+  // 4. Initialize _indexToArc and _arcToIndex
+  const int nrArcs = lemon::countArcs(getTree());
+  _indexToArc = ArcVector(nrArcs, lemon::INVALID);
+  delete _pArcToIndex;
+  _pArcToIndex = new IntArcMap(getTree(), -1);
+  
+  idx = 0;
+  for (ArcIt a(getTree()); a != lemon::INVALID; ++a)
+  {
+    _indexToArc[idx] = a;
+    _pArcToIndex->set(a, idx);
+    ++idx;
+  }
+}
+
+void IlpPmhSolver::initReachability()
+{
+  const int nrAnatomicalSites = _anatomicalSiteToIndex.size();
+  const int nrNodes = _indexToNode.size();
+  
+  _subLabelOffset = IntVector(nrAnatomicalSites + 1, 0);
+  _indexToSubLabel.clear();
+  for (int s = 0; s < nrAnatomicalSites; ++s)
+  {
+    const int size_L_s = _L[s].size();
+    for (int c = 0; c < size_L_s; ++c)
+    {
+      _indexToSubLabel.push_back(IntPair(s, c));
+    }
+    _subLabelOffset[s + 1] = _indexToSubLabel.size();
+  }
+  _nrPrunedVars = 0;
+  
+  // preorder of the underlying tree
+  IntVector order;
+  order.reserve(nrNodes);
+  NodeVector stack(1, getRoot());
+  while (!stack.empty())
+  {
+    Node v_i = stack.back();
+    stack.pop_back();
+    order.push_back((*_pNodeToIndex)[v_i]);
+    for (OutArcIt a(getTree(), v_i); a != lemon::INVALID; ++a)
+    {
+      stack.push_back(getTree().target(a));
+    }
+  }
+  
+  // A vertex labeled by (s,c) != (P,0) has a child labeled by (s,c),
+  // so s must be the label of a descendant leaf. Vertices are visited bottom-up.
+  _presentSites = BoolMatrix(nrNodes, BoolVector(nrAnatomicalSites, false));
+  for (int r = order.size() - 1; r >= 0; --r)
+  {
+    const int i = order[r];
+    const Node v_i = _indexToNode[i];
+    if (isLeaf(v_i))
+    {
+      const int s = _anatomicalSiteToIndex[getLeafAnatomicalSiteLabel(v_i)];
+      _presentSites[i][s] = true;
+    }
+    
+    if (v_i != getRoot())
+    {
+      const int k = (*_pNodeToIndex)[getParent(v_i)];
+      for (int s = 0; s < nrAnatomicalSites; ++s)
+      {
+        if (_presentSites[i][s])
+        {
+          _presentSites[k][s] = true;
+        }
+      }
+    }
+  }
+}
+
+void IlpPmhSolver::initPresolve()
+{
+  const int nrAnatomicalSites = _anatomicalSiteToIndex.size();
+  const int nrNodes = _indexToNode.size();
+  
+  _contractedTo = IntVector(nrNodes);
+  for (int i = 0; i < nrNodes; ++i)
+  {
+    _contractedTo[i] = i;
+  }
+  _symmetricLeaves.clear();
+  _nrContractedVars = 0;
+  _nrContractedConstrs = 0;
+  _nrSymmetryConstrs = 0;
+  
+  if (!_presolve)
+    return;
+  
+  // A vertex labeled by (s,c) != (P,0) has a descendant leaf labeled by (s,c).
+  // Hence, a non-root vertex v_i with a single child v_j is labeled by either
+  // (P,0) or the label of v_j. Labeling v_i by (P,0) and v_j by (t,d) is
+  // equivalent to labeling both by (t,d), as the migration edge (v_i,v_j)
+  // is replaced by the incoming edge of v_i whose source is labeled by (P,0).
+  // So v_i shares the variables of v_j. Vertices are visited bottom-up.
+  const CompactTree& compactT = getOrgT().compactTree();
+  for (int r = compactT.getNrNodes() - 1; r >= 0; --r)
+  {
+    const Node v_i = compactT.node(r);
+    const int i = (*_pNodeToIndex)[v_i];
+    
+    if (!isLeaf(v_i) && v_i != getRoot() && compactT.getNrChildren(v_i) == 1)
+    {
+      const int j = (*_pNodeToIndex)[compactT.child(v_i, 0)];
+      _contractedTo[i] = _contractedTo[j];
+      for (int s = 0; s < nrAnatomicalSites; ++s)
+      {
+        if (_presentSites[i][s])
+        {
+          _nrContractedVars += _L[s].size();
+        }
+      }
+    }
+  }
+  
+  // Sibling leaves v_i and v_j labeled by s either share the label of their
+  // parent or are the only vertices with their respective sub-labels,
+  // in which case their sub-labels may be swapped
+  IntVector lastLeaf(nrAnatomicalSites);
+  for (NodeIt v_k(getTree()); v_k != lemon::INVALID; ++v_k)
+  {
+    if (isLeaf(v_k)) continue;
+    
+    std::fill(lastLeaf.begin(), lastLeaf.end(), -1);
+    for (OutArcIt a(getTree(), v_k); a != lemon::INVALID; ++a)
+    {
+      Node v_j = getTree().target(a);
+      if (!isLeaf(v_j)) continue;
+      
+      const int j = (*_pNodeToIndex)[v_j];
+      const int s = _anatomicalSiteToIndex[getLeafAnatomicalSiteLabel(v_j)];
+      if (lastLeaf[s] != -1)
+      {
+        _symmetricLeaves.push_back(IntTriple(s, IntPair(lastLeaf[s], j)));
+      }
+      lastLeaf[s] = j;
+    }
+  }
+}
+
+void IlpPmhSolver::getBoundsX(int i, int s, int c,
+                              double& lb, double& ub) const
+{
+  lb = 0;
+  ub = 1;
+  
+  const Node v_i = _indexToNode[i];
+  if (_presolve && v_i == getRoot())
+  {
+    lb = ub = (s == _primaryIndex && c == 0) ? 1 : 0;
+  }
+  else if (!_presentSites[i][s]
+           && (isLeaf(v_i) || s != _primaryIndex || c != 0))
+  {
+    ub = 0;
+  }
+}
+
+MilpVar IlpPmhSolver::addBinaryVar(double lb, double ub, const char* name)
+{
+  if (ub == 0)
+  {
+    ++_nrPrunedVars;
+    return MilpVar();
+  }
+  
+  return strlen(name) > 255 ? _model.addVar(lb, ub, 0, MilpVar::BINARY) : _model.addVar(lb, ub, 0, MilpVar::BINARY, name);
+}
+
+void IlpPmhSolver::writePresolveSummary(std::ostream& out) const
+{
+  const int nrVars = _model.getNrVars();
+  const int nrConstrs = _model.getNrConstrs();
+  
+  int nrContractedVertices = 0;
+  for (int i = 0; i < _contractedTo.size(); ++i)
+  {
+    if (isContracted(i))
+    {
+      ++nrContractedVertices;
+    }
+  }
+  
+  out << "Presolve: "
+      << nrVars + _nrPrunedVars + _nrContractedVars << " -> "
+      << nrVars - _model.getNrFixedVars() << " variables, "
+      << nrConstrs + _model.getNrRedundantConstrs() + _nrContractedConstrs - _nrSymmetryConstrs << " -> "
+      << nrConstrs << " constraints ("
+      << nrContractedVertices << " contracted vertices, "
+      << _symmetricLeaves.size() << " ordered pairs of sibling leaves)"
+      << std::endl;
+}
+
+std::string IlpPmhSolver::getLogFilename(const std::string& outputDirectory,
+                                         const std::string& outputPrefix,
+                                         const std::string& primary,
+                                         MigrationGraph::Pattern pattern)
+{
+  if (outputDirectory.empty())
+  {
+    return "";
+  }
+  
+  char buf[1024];
+  snprintf(buf, 1024, "%s/%slog-%s-%s.txt",
+           outputDirectory.c_str(),
+           outputPrefix.c_str(),
+           primary.c_str(),
+           MigrationGraph::getPatternString(pattern).c_str());
+  
+  return buf;
+}
+
+std::string IlpPmhSolver::getProfileFilename(const std::string& outputDirectory,
+                                             const std::string& outputPrefix,
+                                             const std::string& primary,
+                                             MigrationGraph::Pattern pattern)
+{
+  if (outputDirectory.empty())
+  {
+    return "";
   }
   
-  // 4. Initialize _indexToArc and _arcToIndex
-  const int nrArcs = lemon::countArcs(getTree());
-  _indexToArc = ArcVector(nrArcs, lemon::INVALID);
-  delete _pArcToIndex;
-  _pArcToIndex = new IntArcMap(getTree(), -1);
+  char buf[1024];
+  snprintf(buf, 1024, "%s/%sprofile-%s-%s.json",
+           outputDirectory.c_str(),
+           outputPrefix.c_str(),
+           primary.c_str(),
+           MigrationGraph::getPatternString(pattern).c_str());
   
-  idx = 0;
-  for (ArcIt a(getTree()); a != lemon::INVALID; ++a)
+  return buf;
+}
+
+void IlpPmhSolver::writeProfile(const std::string& filename)
+{
+  if (filename.empty())
   {
-    _indexToArc[idx] = a;
-    _pArcToIndex->set(a, idx);
-    ++idx;
+    return;
   }
+  
+  _profiler.stop();
+  _profiler.setCounter("peakMemoryKB", Profiler::getPeakMemory());
+  
+  AtomicOfstream out(filename);
+  _profiler.writeJSON(out);
+  out.close();
 }
 
 IntTriple IlpPmhSolver::run(const CloneTree& T,
@@ -182,25 +1016,16 @@ IntTriple IlpPmhSolver::run(const CloneTree& T,
                             bool outputSearchGraph,
                             int timeLimit,
                             const IntTriple& bounds,
-                            const StringPairList& forcedComigrations)
+                            const StringPairList& forcedComigrations,
+                            std::ostream& out)
 {
-  std::string filenameGurobiLog;
-  if (!outputDirectory.empty())
-  {
-    char buf[1024];
-    snprintf(buf, 1024, "%s/%slog-%s-%s.txt",
-             outputDirectory.c_str(),
-             outputPrefix.c_str(),
-             primary.c_str(),
-             MigrationGraph::getPatternString(pattern).c_str());
-    
-    filenameGurobiLog = buf;
-  }
-  
   IlpPmhSolver solver(T,
                       primary,
                       pattern,
-                      filenameGurobiLog,
+                      getLogFilename(outputDirectory,
+                                     outputPrefix,
+                                     primary,
+                                     pattern),
                       forcedComigrations);
   return run(solver,
              T,
@@ -214,7 +1039,62 @@ IntTriple IlpPmhSolver::run(const CloneTree& T,
              outputSearchGraph,
              timeLimit,
              bounds,
-             forcedComigrations);
+             forcedComigrations,
+             out);
+}
+
+void IlpPmhSolver::writeSolution(const MigrationGraph& G,
+                                 const std::string& outputDirectory,
+                                 const std::string& outputPrefix,
+                                 const std::string& primary,
+                                 const std::string& name,
+                                 const StringToIntMap& colorMap) const
+{
+  char buf[1024];
+  snprintf(buf, 1024, "%s/%sT-%s-%s.dot",
+           outputDirectory.c_str(),
+           outputPrefix.c_str(),
+           primary.c_str(),
+           name.c_str());
+  AtomicOfstream outT(buf);
+  writeCloneTree(outT, colorMap);
+  outT.close();
+  
+  snprintf(buf, 1024, "%s/%sG-%s-%s.dot",
+           outputDirectory.c_str(),
+           outputPrefix.c_str(),
+           primary.c_str(),
+           name.c_str());
+  AtomicOfstream outG(buf);
+  G.writeDOT(outG, colorMap);
+  outG.close();
+  
+  snprintf(buf, 1024, "%s/%sG-%s-%s.tree",
+           outputDirectory.c_str(),
+           outputPrefix.c_str(),
+           primary.c_str(),
+           name.c_str());
+  AtomicOfstream outGraph(buf);
+  G.write(outGraph);
+  outGraph.close();
+  
+  snprintf(buf, 1024, "%s/%sT-%s-%s.tree",
+           outputDirectory.c_str(),
+           outputPrefix.c_str(),
+           primary.c_str(),
+           name.c_str());
+  AtomicOfstream outTree(buf);
+  T().write(outTree);
+  outTree.close();
+  
+  snprintf(buf, 1024, "%s/%sT-%s-%s.labeling",
+           outputDirectory.c_str(),
+           outputPrefix.c_str(),
+           primary.c_str(),
+           name.c_str());
+  AtomicOfstream outLabeling(buf);
+  T().writeVertexLabeling(outLabeling, lPlus());
+  outLabeling.close();
 }
 
 IntTriple IlpPmhSolver::run(IlpPmhSolver& solver,
@@ -229,14 +1109,53 @@ IntTriple IlpPmhSolver::run(IlpPmhSolver& solver,
                             bool outputSearchGraph,
                             int timeLimit,
                             const IntTriple& bounds,
-                            const StringPairList& forcedComigrations)
+                            const StringPairList& forcedComigrations,
+                            std::ostream& out)
 {
   char buf[1024];
   std::string filenameSearchGraph;
+  const std::string filenameProfile = getProfileFilename(outputDirectory,
+                                                         outputPrefix,
+                                                         primary,
+                                                         pattern);
+  
+  solver._profiler.clear();
+  solver._profiler.setAttribute("primary", primary);
+  solver._profiler.setAttribute("pattern", MigrationGraph::getPatternString(pattern));
+  solver._profiler.setAttribute("backend", MilpModel::getBackendString(MilpModel::getDefaultBackend()));
+  
+  std::string cacheKey;
+  if (solver._pCache)
+  {
+    solver._profiler.start("cacheLookup");
+    cacheKey = solver._pCache->getKey(T, primary, pattern, bounds, forcedComigrations);
+    SolutionCache::Entry entry;
+    const bool hit = solver._pCache->lookup(cacheKey, entry);
+    solver._profiler.stop();
+    solver._profiler.setAttribute("cache", hit ? "hit" : "miss");
+    
+    if (hit)
+    {
+      return runCached(solver, entry, primary,
+                       outputDirectory, outputPrefix,
+                       colorMap, pattern, out);
+    }
+  }
   
   try {
-    solver.init(bounds);
-  } catch (GRBException& e) {
+    solver.update(pattern, forcedComigrations);
+    if (!solver.isInitialized())
+    {
+      solver.init(bounds);
+      if (solver._presolve)
+      {
+        std::stringstream ss;
+        ss << outputPrefix << "\t";
+        solver.writePresolveSummary(ss);
+        std::cerr << ss.str() << std::flush;
+      }
+    }
+  } catch (MilpException& e) {
     std::cerr << e.getMessage() << std::endl;
     abort();
   }
@@ -260,24 +1179,32 @@ IntTriple IlpPmhSolver::run(IlpPmhSolver& solver,
                primary.c_str(),
                MigrationGraph::getPatternString(pattern).c_str());
       
+      solver._profiler.start("exportModel");
       solver.exportModel(buf);
+      solver._profiler.stop();
     }
   }
   
   lemon::Timer timer;
+  solver._model.setLogFilename(getLogFilename(outputDirectory,
+                                              outputPrefix,
+                                              primary,
+                                              pattern));
   bool solved = solver.solve(nrThreads, timeLimit);
   if (!solved)
   {
-    std::cout << outputPrefix << "\t"
-              << "(" << MigrationGraph::getAllowedPatternsString(pattern) << ")\t"
-              << "-" << "\t"
-              << "-" << "\t"
-              << "-" << "\t"
-              << "-" << "\t"
-              << "-" << "\t"
-              << "-" << "\t"
-              << timer.realTime()
-              << std::endl;
+    out << outputPrefix << "\t"
+        << "(" << MigrationGraph::getAllowedPatternsString(pattern) << ")\t"
+        << "-" << "\t"
+        << "-" << "\t"
+        << "-" << "\t"
+        << "-" << "\t"
+        << "-" << "\t"
+        << "-" << "\t"
+        << timer.realTime()
+        << std::endl;
+    
+    solver.writeProfile(filenameProfile);
 
     IntTriple res;
     res.first = -1;
@@ -287,13 +1214,170 @@ IntTriple IlpPmhSolver::run(IlpPmhSolver& solver,
     return res;
   }
 
+  solver._profiler.start("writeOutput");
   MigrationGraph G(solver.T(), solver.lPlus());
   
   int mu = G.getNrMigrations();
   int gamma = G.getNrComigrations(solver.T(), solver.lPlus());
   int sigma = G.getNrSeedingSites();
   
-  std::cout << outputPrefix << "\t"
+  out << outputPrefix << "\t"
+      << "(" << MigrationGraph::getAllowedPatternsString(pattern) << ")\t"
+      << mu << "\t"
+      << gamma << "\t"
+      << sigma << "\t"
+      << G.getPatternString(G.getPattern(), G.isMonoclonal()) << "\t"
+      << solver.LB() << "\t"
+      << solver.UB() << "\t"
+      << timer.realTime()
+      << std::endl;
+  
+  if (!outputDirectory.empty())
+  {
+    solver.writeSolution(G,
+                         outputDirectory,
+                         outputPrefix,
+                         primary,
+                         MigrationGraph::getPatternString(pattern),
+                         colorMap);
+    
+    AtomicOfstream outGG(filenameSearchGraph);
+    solver.writeSolutionGraphDOT(outGG, colorMap);
+    outGG.close();
+  }
+  
+  // solutions that are not proven optimal depend on the time limit
+  if (solver._pCache && solver._model.getStatus() == MilpModel::OPTIMAL)
+  {
+    solver._profiler.start("cacheStore");
+    
+    SolutionCache::Entry entry;
+    entry._mu = mu;
+    entry._gamma = gamma;
+    entry._sigma = sigma;
+    entry._pattern = G.getPatternString(G.getPattern(), G.isMonoclonal());
+    entry._LB = solver.LB();
+    entry._UB = solver.UB();
+    
+    std::stringstream ssTree, ssLeafLabeling, ssVertexLabeling;
+    solver.T().write(ssTree);
+    solver.T().writeLeafLabeling(ssLeafLabeling);
+    solver.T().writeVertexLabeling(ssVertexLabeling, solver.lPlus());
+    entry._tree = ssTree.str();
+    entry._leafLabeling = ssLeafLabeling.str();
+    entry._vertexLabeling = ssVertexLabeling.str();
+    
+    solver._pCache->store(cacheKey, entry);
+    solver._profiler.stop();
+  }
+  
+  solver.writeProfile(filenameProfile);
+  
+  IntTriple res;
+  res.first = mu;
+  res.second.first = gamma;
+  res.second.second = sigma;
+  
+  return res;
+}
+
+std::vector<IntTriple> IlpPmhSolver::runPareto(IlpPmhSolver& solver,
+                                               const CloneTree& T,
+                                               const std::string& primary,
+                                               const std::string& outputDirectory,
+                                               const std::string& outputPrefix,
+                                               const StringToIntMap& colorMap,
+                                               MigrationGraph::Pattern pattern,
+                                               int nrThreads,
+                                               int timeLimit,
+                                               const IntTriple& bounds,
+                                               const StringPairList& forcedComigrations,
+                                               std::ostream& out)
+{
+  solver._profiler.clear();
+  solver._profiler.setAttribute("primary", primary);
+  solver._profiler.setAttribute("pattern", MigrationGraph::getPatternString(pattern));
+  solver._profiler.setAttribute("backend", MilpModel::getBackendString(MilpModel::getDefaultBackend()));
+  solver._profiler.setAttribute("mode", "pareto");
+  
+  try {
+    solver.update(pattern, forcedComigrations);
+    if (!solver.isInitialized())
+    {
+      solver.init(bounds);
+    }
+  } catch (MilpException& e) {
+    std::cerr << e.getMessage() << std::endl;
+    abort();
+  }
+  
+  solver._model.setLogFilename(getLogFilename(outputDirectory,
+                                              outputPrefix,
+                                              primary,
+                                              pattern));
+  
+  // epsilon-constraint method: the lexicographic minimum subject to
+  // gamma <= gammaUB and sigma <= sigmaUB is non-dominated, and every
+  // non-dominated triple is attained for gammaUB = gamma and sigmaUB = sigma.
+  // For a fixed sigmaUB, gammaUB is decreased past every solution found;
+  // afterwards sigmaUB is decreased past the largest sigma found, as larger
+  // values of sigmaUB yield the same solutions.
+  const int nrConstrs = solver._model.getNrConstrs();
+  const MilpLinExpr comigrationNumber = solver.getComigrationNumber();
+  const MilpLinExpr seedingSiteNumber = solver.getSeedingSiteNumber();
+  
+  std::vector<IntTriple> front;
+  std::set<IntTriple> found;
+  lemon::Timer timer;
+  bool complete = true;
+  
+  int sigmaUB = bounds.second.second;
+  while (complete)
+  {
+    int gammaUB = bounds.second.first;
+    int maxSigma = -1;
+    while (complete)
+    {
+      int remainingTime = -1;
+      if (timeLimit > 0)
+      {
+        remainingTime = timeLimit - static_cast<int>(timer.realTime());
+        if (remainingTime <= 0)
+        {
+          complete = false;
+          break;
+        }
+      }
+      
+      solver._model.removeConstrs(nrConstrs);
+      if (gammaUB != -1)
+      {
+        solver._model.addConstr(comigrationNumber <= gammaUB);
+      }
+      if (sigmaUB != -1)
+      {
+        solver._model.addConstr(seedingSiteNumber <= sigmaUB);
+      }
+      
+      if (!solver.solve(nrThreads, remainingTime))
+      {
+        complete &= solver._model.getStatus() != MilpModel::TIME_LIMIT;
+        break;
+      }
+      complete &= solver._model.getStatus() == MilpModel::OPTIMAL;
+      
+      solver._profiler.start("writeOutput");
+      MigrationGraph G(solver.T(), solver.lPlus());
+      
+      const int mu = G.getNrMigrations();
+      const int gamma = G.getNrComigrations(solver.T(), solver.lPlus());
+      const int sigma = G.getNrSeedingSites();
+      const IntTriple triple(mu, IntPair(gamma, sigma));
+      
+      if (found.insert(triple).second)
+      {
+        front.push_back(triple);
+        out << outputPrefix << "\t"
             << "(" << MigrationGraph::getAllowedPatternsString(pattern) << ")\t"
             << mu << "\t"
             << gamma << "\t"
@@ -303,16 +1387,105 @@ IntTriple IlpPmhSolver::run(IlpPmhSolver& solver,
             << solver.UB() << "\t"
             << timer.realTime()
             << std::endl;
+        
+        if (!outputDirectory.empty())
+        {
+          solver.writeSolution(G,
+                               outputDirectory,
+                               outputPrefix,
+                               primary,
+                               MigrationGraph::getPatternString(pattern) + "-" + std::to_string(front.size()),
+                               colorMap);
+        }
+      }
+      solver._profiler.stop();
+      
+      maxSigma = std::max(maxSigma, sigma);
+      if (gamma == 0)
+      {
+        break;
+      }
+      gammaUB = gamma - 1;
+    }
+    
+    if (maxSigma <= 0)
+    {
+      break;
+    }
+    sigmaUB = maxSigma - 1;
+  }
+  
+  if (!complete)
+  {
+    std::cerr << "Warning: time limit reached, Pareto front of '"
+              << outputPrefix << primary << "' ("
+              << MigrationGraph::getPatternString(pattern)
+              << ") may be incomplete" << std::endl;
+  }
+  
+  // restore the model for subsequent runs
+  solver._model.removeConstrs(nrConstrs);
+  
+  solver._profiler.setCounter("nrParetoPoints", front.size());
+  solver.writeProfile(getProfileFilename(outputDirectory,
+                                         outputPrefix,
+                                         primary,
+                                         pattern));
+  
+  return front;
+}
+
+IntTriple IlpPmhSolver::runCached(IlpPmhSolver& solver,
+                                  const SolutionCache::Entry& entry,
+                                  const std::string& primary,
+                                  const std::string& outputDirectory,
+                                  const std::string& outputPrefix,
+                                  const StringToIntMap& colorMap,
+                                  MigrationGraph::Pattern pattern,
+                                  std::ostream& out)
+{
+  lemon::Timer timer;
+  
+  out << outputPrefix << "\t"
+      << "(" << MigrationGraph::getAllowedPatternsString(pattern) << ")\t"
+      << entry._mu << "\t"
+      << entry._gamma << "\t"
+      << entry._sigma << "\t"
+      << entry._pattern << "\t"
+      << entry._LB << "\t"
+      << entry._UB << "\t"
+      << timer.realTime()
+      << std::endl;
   
   if (!outputDirectory.empty())
   {
+    solver._profiler.start("writeOutput");
+    
+    CloneTree T;
+    std::stringstream ssTree(entry._tree);
+    std::stringstream ssLeafLabeling(entry._leafLabeling);
+    std::stringstream ssVertexLabeling(entry._vertexLabeling);
+    if (!T.read(ssTree) || !T.readLeafLabeling(ssLeafLabeling))
+    {
+      std::cerr << "Error: invalid cached clone tree" << std::endl;
+      return std::make_pair(-1, std::make_pair(-1, -1));
+    }
+    StringNodeMap lPlus(T.tree());
+    if (!BaseTree::readVertexLabeling(ssVertexLabeling, T, lPlus))
+    {
+      std::cerr << "Error: invalid cached vertex labeling" << std::endl;
+      return std::make_pair(-1, std::make_pair(-1, -1));
+    }
+    MigrationGraph G(T, lPlus);
+    
+    char buf[1024];
     snprintf(buf, 1024, "%s/%sT-%s-%s.dot",
              outputDirectory.c_str(),
              outputPrefix.c_str(),
              primary.c_str(),
              MigrationGraph::getPatternString(pattern).c_str());
-    std::ofstream outT(buf);
-    solver.writeCloneTree(outT, colorMap);
+    AtomicOfstream outT(buf);
+    T.writeDOT(outT, lPlus, colorMap);
     outT.close();
     
     snprintf(buf, 1024, "%s/%sG-%s-%s.dot",
@@ -320,16 +1493,16 @@ IntTriple IlpPmhSolver::run(IlpPmhSolver& solver,
              outputPrefix.c_str(),
              primary.c_str(),
              MigrationGraph::getPatternString(pattern).c_str());
-    std::ofstream outG(buf);
+    AtomicOfstream outG(buf);
     G.writeDOT(outG, colorMap);
     outG.close();
-
+    
     snprintf(buf, 1024, "%s/%sG-%s-%s.tree",
              outputDirectory.c_str(),
              outputPrefix.c_str(),
              primary.c_str(),
              MigrationGraph::getPatternString(pattern).c_str());
-    std::ofstream outGraph(buf);
+    AtomicOfstream outGraph(buf);
     G.write(outGraph);
     outGraph.close();
     
@@ -338,8 +1511,8 @@ IntTriple IlpPmhSolver::run(IlpPmhSolver& solver,
              outputPrefix.c_str(),
              primary.c_str(),
              MigrationGraph::getPatternString(pattern).c_str());
-    std::ofstream outTree(buf);
-    solver.T().write(outTree);
+    AtomicOfstream outTree(buf);
+    T.write(outTree);
     outTree.close();
     
     snprintf(buf, 1024, "%s/%sT-%s-%s.labeling",
@@ -347,19 +1520,20 @@ IntTriple IlpPmhSolver::run(IlpPmhSolver& solver,
              outputPrefix.c_str(),
              primary.c_str(),
              MigrationGraph::getPatternString(pattern).c_str());
-    std::ofstream outLabeling(buf);
-    solver.T().writeVertexLabeling(outLabeling, solver.lPlus());
+    AtomicOfstream outLabeling(buf);
+    T.writeVertexLabeling(outLabeling, lPlus);
     outLabeling.close();
-    
-    std::ofstream outGG(filenameSearchGraph.c_str());
-    solver.writeSolutionGraphDOT(outGG, colorMap);
-    outGG.close();
   }
   
+  solver.writeProfile(getProfileFilename(outputDirectory,
+                                         outputPrefix,
+                                         primary,
+                                         pattern));
+  
   IntTriple res;
-  res.first = mu;
-  res.second.first = gamma;
-  res.second.second = sigma;
+  res.first = entry._mu;
+  res.second.first = entry._gamma;
+  res.second.second = entry._sigma;
   
   return res;
 }
@@ -371,8 +1545,10 @@ void IlpPmhSolver::initCallbacks()
 void IlpPmhSolver::initConstraintsNonEdgesG()
 {
   const int nrAnatomicalSites = _anatomicalSiteToIndex.size();
+  const int nrSubLabels = getNrSubLabels();
   
-  GRBLinExpr sum;
+  // sumXX[kl] is the sum of xx[ij][s][c][t][d] over all edges (v_i,v_j)
+  std::vector<MilpLinExpr> sumXX(nrSubLabels * nrSubLabels);
   
   for (ArcIt a_ij(getTree()); a_ij != lemon::INVALID; ++a_ij)
   {
@@ -382,22 +1558,19 @@ void IlpPmhSolver::initConstraintsNonEdgesG()
     const int i = (*_pNodeToIndex)[v_i];
     const int j = (*_pNodeToIndex)[v_j];
     
-    for (int s = 0; s < nrAnatomicalSites; ++s)
+    for (int e = _xx.rowBegin(ij); e < _xx.rowEnd(ij); ++e)
     {
-      const int size_L_s = _L[s].size();
-      for (int c = 0; c < size_L_s; ++c)
-      {
-        for (int t = 0; t < nrAnatomicalSites; ++t)
-        {
-          const int size_L_t = _L[t].size();
-          for (int d = 0; d < size_L_t; ++d)
-          {
-            _model.addConstr(_xx[ij][s][c][t][d] <= _x[i][s][c]);
-            _model.addConstr(_xx[ij][s][c][t][d] <= _x[j][t][d]);
-            _model.addConstr(_xx[ij][s][c][t][d] >= _x[i][s][c] + _x[j][t][d] - 1);
-          }
-        }
-      }
+      const int kl = _xx.col(e);
+      const IntPair& sc = _indexToSubLabel[kl / nrSubLabels];
+      const IntPair& td = _indexToSubLabel[kl % nrSubLabels];
+      const MilpVar& xx = _xx.var(e);
+      const MilpVar& x_isc = _x[i][sc.first][sc.second];
+      const MilpVar& x_jtd = _x[j][td.first][td.second];
+      
+      _model.addConstr(xx <= x_isc);
+      _model.addConstr(xx <= x_jtd);
+      _model.addConstr(xx >= x_isc + x_jtd - 1);
+      sumXX[kl] += xx;
     }
   }
   
@@ -413,13 +1586,9 @@ void IlpPmhSolver::initConstraintsNonEdgesG()
         {
           if (s == t && c == d) continue;
           
-          for (ArcIt a_ij(getTree()); a_ij != lemon::INVALID; ++a_ij)
-          {
-            const int ij = (*_pArcToIndex)[a_ij];
-            sum += _xx[ij][s][c][t][d];
-          }
-          _model.addConstr(_z[s][c][t][d] <= sum);
-          sum.clear();
+          const int kl = getSubLabelPairIndex(getSubLabelIndex(s, c),
+                                              getSubLabelIndex(t, d));
+          _model.addConstr(_z[s][c][t][d] <= sumXX[kl]);
         }
       }
     }
@@ -430,7 +1599,7 @@ void IlpPmhSolver::initConstraintsG()
 {
   const int nrAnatomicalSites = _anatomicalSiteToIndex.size();
 
-  GRBLinExpr sum, sum2;
+  MilpLinExpr sum, sum2;
   
   // Every (t,d) != (P,0) has at most one incoming edge
   for (int t = 0; t < nrAnatomicalSites; ++t)
@@ -520,64 +1689,91 @@ bool IlpPmhSolver::solve(int nrThreads, int timeLimit)
   {
     if (nrThreads > 0)
     {
-      _model.getEnv().set(GRB_IntParam_Threads, nrThreads);
+      _model.setNrThreads(nrThreads);
     }
     if (timeLimit > 0)
     {
-      _model.getEnv().set(GRB_DoubleParam_TimeLimit, timeLimit);
+      _model.setTimeLimit(timeLimit);
     }
     
-    _model.getEnv().set(GRB_IntParam_LogToConsole, 0);
+    _model.setLogToConsole(false);
+    
+    // callback counters accumulate over consecutive solves of the same model
+    const MilpCallback* pCallback = _model.getCallback();
+    const long nrInvocations = pCallback ? pCallback->getNrInvocations() : 0;
+    const long nrLazyConstrs = pCallback ? pCallback->getNrLazyConstrs() : 0;
+    const double callbackTime = pCallback ? pCallback->getTime() : 0;
+    
+    _profiler.start("optimize");
     try
     {
       _model.optimize();
     }
-    catch (GRBException& e)
+    catch (MilpException& e)
     {
       std::cerr << e.getMessage() << std::endl;
       exit(1);
     }
+    _profiler.stop();
+    
+    _profiler.setCounter("nrVars", _model.getNrVars());
+    _profiler.setCounter("nrConstrs", _model.getNrConstrs());
+    _profiler.setCounter("nrPrunedVars", _nrPrunedVars);
+    _profiler.setCounter("nrContractedVars", _nrContractedVars);
+    _profiler.setCounter("nrContractedConstrs", _nrContractedConstrs);
+    _profiler.setCounter("nrSymmetryConstrs", _nrSymmetryConstrs);
+    _profiler.setCounter("nrRedundantConstrs", _model.getNrRedundantConstrs());
+    _profiler.setCounter("nrNodes", _model.getNrNodes());
+    _profiler.setCounter("nrCallbacks", pCallback ? pCallback->getNrInvocations() - nrInvocations : 0);
+    _profiler.setCounter("nrLazyConstrs", pCallback ? pCallback->getNrLazyConstrs() - nrLazyConstrs : 0);
+    _profiler.setCounter("callbackTime", pCallback ? pCallback->getTime() - callbackTime : 0);
     
-    int status = _model.get(GRB_IntAttr_Status);
-    if (status == GRB_OPTIMAL || status == GRB_SUBOPTIMAL)
+    MilpModel::Status status = _model.getStatus();
+    if (status == MilpModel::OPTIMAL || status == MilpModel::SUBOPTIMAL)
     {
-      _LB = _model.get(GRB_DoubleAttr_ObjBound);
-      _UB = _model.get(GRB_DoubleAttr_ObjVal);
+      _LB = _model.getObjBound();
+      _UB = _model.getObjVal();
+      _profiler.start("processSolution");
       processSolution();
+      _profiler.stop();
       return true;
     }
-    else if (status == GRB_INF_OR_UNBD)
+    else if (status == MilpModel::INF_OR_UNBD)
     {
       std::cerr << "Model is infeasible or unbounded" << std::endl;
       return false;
     }
-    else if (status == GRB_INFEASIBLE)
+    else if (status == MilpModel::INFEASIBLE)
     {
       //std::cerr << "Model is infeasible" << std::endl;
-//      _model.computeIIS();
-//      _model.write("/tmp/model_IIS.ilp");
       return false;
     }
-    else if (status == GRB_UNBOUNDED)
+    else if (status == MilpModel::UNBOUNDED)
     {
       std::cerr << "Model is unbounded" << std::endl;
       return false;
     }
-    else if (status == GRB_TIME_LIMIT)
+    else if (status == MilpModel::CUTOFF)
+    {
+      // dominated by the shared cutoff
+      return false;
+    }
+    else if (status == MilpModel::TIME_LIMIT)
     {
-      _LB = _model.get(GRB_DoubleAttr_ObjBound);
-      _UB = _model.get(GRB_DoubleAttr_ObjVal);
+      _LB = _model.getObjBound();
+      _UB = _model.getObjVal();
       if (_UB < std::numeric_limits<double>::max() && _UB != NAN)
       {
+        _profiler.start("processSolution");
         processSolution();
+        _profiler.stop();
         return true;
       }
       return false;
     }
   }
-  catch (const GRBException& e)
+  catch (const MilpException& e)
   {
-    std::cerr << "Error code = " << e.getErrorCode() << std::endl;
     std::cerr << e.getMessage() << std::endl;
     
     return false;
@@ -593,12 +1789,18 @@ bool IlpPmhSolver::solve(int nrThreads, int timeLimit)
 void IlpPmhSolver::initVertexLabelingConstraints()
 {
   const int nrAnatomicalSites = _anatomicalSiteToIndex.size();
-  GRBLinExpr sum;
+  MilpLinExpr sum;
   
   // Every vertex is labeled by exactly one (s,c)
   for (NodeIt v_i(getTree()); v_i != lemon::INVALID; ++v_i)
   {
     const int i = (*_pNodeToIndex)[v_i];
+    if (isContracted(i))
+    {
+      ++_nrContractedConstrs;
+      continue;
+    }
+    
     for (int s = 0; s < nrAnatomicalSites; ++s)
     {
       const int size_L_s = _L[s].size();
@@ -632,15 +1834,25 @@ void IlpPmhSolver::initLeafVariables()
       _x[i][s] = VarArray(size_L_s);
       for (int c = 0; c < size_L_s; ++c)
       {
+        double lb, ub;
+        getBoundsX(i, s, c, lb, ub);
+        
         snprintf(buf, 1024, "x;%s;%s;%d",
                  getLabel(v_i).c_str(),
                  _indexToAnatomicalSite[s].c_str(), c);
-        _x[i][s][c] = strlen(buf) > 255 ? _model.addVar(0, 1, 0, GRB_BINARY) : _model.addVar(0, 1, 0, GRB_BINARY, buf);
+        _x[i][s][c] = addBinaryVar(lb, ub, buf);
       }
     }
   }
   
-  _model.update();
+  // contracted vertices share the variables of their descendant
+  for (int i = 0; i < nrNodes; ++i)
+  {
+    if (isContracted(i))
+    {
+      _x[i] = _x[_contractedTo[i]];
+    }
+  }
 }
 
 void IlpPmhSolver::initVariables()
@@ -655,7 +1867,7 @@ void IlpPmhSolver::initVariables()
   for (int i = 0; i < nrNodes; ++i)
   {
     Node v_i = _indexToNode[i];
-    if (isLeaf(v_i)) continue;
+    if (isLeaf(v_i) || isContracted(i)) continue;
     _x[i] = VarMatrix(nrAnatomicalSites);
     for (int s = 0; s < nrAnatomicalSites; ++s)
     {
@@ -663,43 +1875,63 @@ void IlpPmhSolver::initVariables()
       _x[i][s] = VarArray(size_L_s);
       for (int c = 0; c < size_L_s; ++c)
       {
+        double lb, ub;
+        getBoundsX(i, s, c, lb, ub);
+        
         snprintf(buf, 1024, "x;%s;%s;%d",
                  getLabel(v_i).c_str(),
                  _indexToAnatomicalSite[s].c_str(), c);
-        _x[i][s][c] = strlen(buf) > 255 ? _model.addVar(0, 1, 0, GRB_BINARY) : _model.addVar(0, 1, 0, GRB_BINARY, buf);
+        _x[i][s][c] = addBinaryVar(lb, ub, buf);
       }
     }
   }
   
-  _xx = Var5Matrix(nrArcs);
+  // only pairs of sub-labels that are not fixed to 0 at the endpoints are stored
+  const int nrSubLabels = getNrSubLabels();
+  BoolVector hasXX(nrSubLabels * nrSubLabels, false);
+  _xx.clear();
   for (int ij = 0; ij < nrArcs; ++ij)
   {
     Arc a_ij = _indexToArc[ij];
     Node v_i = getTree().source(a_ij);
     Node v_j = getTree().target(a_ij);
+    const int i = _contractedTo[(*_pNodeToIndex)[v_i]];
+    const int j = _contractedTo[(*_pNodeToIndex)[v_j]];
     
-    _xx[ij] = Var4Matrix(nrAnatomicalSites);
-    for (int s = 0; s < nrAnatomicalSites; ++s)
+    _xx.addRow();
+    for (int k = 0; k < nrSubLabels; ++k)
     {
-      const int size_L_s = _L[s].size();
-      _xx[ij][s] = Var3Matrix(size_L_s);
-      for (int c = 0; c < size_L_s; ++c)
+      const int s = _indexToSubLabel[k].first;
+      const int c = _indexToSubLabel[k].second;
+      double lb_i, ub_i;
+      getBoundsX(i, s, c, lb_i, ub_i);
+      if (ub_i == 0) continue;
+      
+      for (int l = 0; l < nrSubLabels; ++l)
       {
-        _xx[ij][s][c] = VarMatrix(nrAnatomicalSites);
-        for (int t = 0; t < nrAnatomicalSites; ++t)
+        const int t = _indexToSubLabel[l].first;
+        const int d = _indexToSubLabel[l].second;
+        double lb_j, ub_j;
+        getBoundsX(j, t, d, lb_j, ub_j);
+        if (ub_j == 0) continue;
+        
+        // an edge into (P,0) leaves (P,0), and
+        // a contracted edge does not change the label
+        if (_presolve
+            && ((i == j && k != l)
+                || (t == _primaryIndex && d == 0 && (s != _primaryIndex || c != 0))))
         {
-          const int size_L_t = _L[t].size();
-          _xx[ij][s][c][t] = VarArray(size_L_t);
-          for (int d = 0; d < size_L_t; ++d)
-          {
-            snprintf(buf, 1024, "xx;(%s,%s);%s;%d;%s;%d",
-                     getLabel(v_i).c_str(),
-                     getLabel(v_j).c_str(),
-                     _indexToAnatomicalSite[s].c_str(), c,
-                     _indexToAnatomicalSite[t].c_str(), d);
-            _xx[ij][s][c][t][d] = strlen(buf) > 255 ? _model.addVar(0, 1, 0, GRB_BINARY) : _model.addVar(0, 1, 0, GRB_BINARY, buf);
-          }
+          ++_nrPrunedVars;
+          continue;
         }
+        
+        snprintf(buf, 1024, "xx;(%s,%s);%s;%d;%s;%d",
+                 getLabel(v_i).c_str(),
+                 getLabel(v_j).c_str(),
+                 _indexToAnatomicalSite[s].c_str(), c,
+                 _indexToAnatomicalSite[t].c_str(), d);
+        _xx.add(getSubLabelPairIndex(k, l), addBinaryVar(0, 1, buf));
+        hasXX[getSubLabelPairIndex(k, l)] = true;
       }
     }
   }
@@ -712,7 +1944,7 @@ void IlpPmhSolver::initVariables()
     for (int c = 0; c < size_L_s; ++c)
     {
       snprintf(buf, 1024, "y;%s;%d", _indexToAnatomicalSite[s].c_str(), c);
-      _y[s][c] = _model.addVar(0, 1, 0, GRB_BINARY, buf);
+      _y[s][c] = _model.addVar(0, 1, 0, MilpVar::BINARY, buf);
     }
   }
   
@@ -731,10 +1963,15 @@ void IlpPmhSolver::initVariables()
         _z[s][c][t] = VarArray(size_L_t);
         for (int d = 0; d < size_L_t; ++d)
         {
+          // z[s][c][t][d] <= sum of xx[ij][s][c][t][d]
+          const bool fixed = _presolve
+            && (s == t || !hasXX[getSubLabelPairIndex(getSubLabelIndex(s, c),
+                                                      getSubLabelIndex(t, d))]);
+          
           snprintf(buf, 1024, "z;%s;%d;%s;%d",
                    _indexToAnatomicalSite[s].c_str(), c,
                    _indexToAnatomicalSite[t].c_str(), d);
-          _z[s][c][t][d] = _model.addVar(0, 1, 0, GRB_BINARY, buf);
+          _z[s][c][t][d] = addBinaryVar(0, fixed ? 0 : 1, buf);
           ++_maxNrEdgesInG;
         }
       }
@@ -744,6 +1981,7 @@ void IlpPmhSolver::initVariables()
   _w = Var4Matrix(nrAnatomicalSites);
   for (int s = 0; s < nrAnatomicalSites; ++s)
   {
+    const int size_L_s = _L[s].size();
     _w[s] = Var3Matrix(nrAnatomicalSites);
     for (int t = 0; t < nrAnatomicalSites; ++t)
     {
@@ -754,11 +1992,21 @@ void IlpPmhSolver::initVariables()
         _w[s][t][d] = VarArray(size_L_t);
         for (int e = 0; e < size_L_t; ++e)
         {
+          // w[s][t][d][e] <= sum of z[s][c][t][d] and sum of z[s][c][t][e]
+          bool fixed_d = _presolve;
+          bool fixed_e = _presolve;
+          for (int c = 0; c < size_L_s; ++c)
+          {
+            fixed_d = fixed_d && _z[s][c][t][d].isNull();
+            fixed_e = fixed_e && _z[s][c][t][e].isNull();
+          }
+          const bool fixed = _presolve && (d == e || fixed_d || fixed_e);
+          
           snprintf(buf, 1024, "w;%s;%s;%d;%d",
                    _indexToAnatomicalSite[s].c_str(),
                    _indexToAnatomicalSite[t].c_str(),
                    d, e);
-          _w[s][t][d][e] = _model.addVar(0, 1, 0, GRB_BINARY, buf);
+          _w[s][t][d][e] = addBinaryVar(0, fixed ? 0 : 1, buf);
         }
       }
     }
@@ -768,28 +2016,43 @@ void IlpPmhSolver::initVariables()
   _sigma = VarArray(nrAnatomicalSites);
   for (int s = 0; s < nrAnatomicalSites; ++s)
   {
+    // sigma[s] <= sum of gamma[s][t]
+    bool fixedSigma = _presolve;
+    
+    const int size_L_s = _L[s].size();
     _gamma[s] = VarArray(nrAnatomicalSites);
     for (int t = 0; t < nrAnatomicalSites; ++t)
     {
+      // gamma[s][t] <= sum of z[s][c][t][d]
+      bool fixed = _presolve;
+      const int size_L_t = _L[t].size();
+      for (int c = 0; c < size_L_s; ++c)
+      {
+        for (int d = 0; d < size_L_t; ++d)
+        {
+          fixed = fixed && (s == t || _z[s][c][t][d].isNull());
+        }
+      }
+      fixedSigma = fixedSigma && fixed;
+      
       snprintf(buf, 1024, "gamma;%s;%s",
                _indexToAnatomicalSite[s].c_str(),
                _indexToAnatomicalSite[t].c_str());
-      _gamma[s][t] = _model.addVar(0, 1, 0, GRB_BINARY, buf);
+      _gamma[s][t] = addBinaryVar(0, fixed ? 0 : 1, buf);
     }
     
     snprintf(buf, 1024, "sigma;%s",
              _indexToAnatomicalSite[s].c_str());
-    _sigma[s] = _model.addVar(0, 1, 0, GRB_BINARY, buf);
+    _sigma[s] = addBinaryVar(0, fixedSigma ? 0 : 1, buf);
   }
   
-  _model.update();
 }
 
 void IlpPmhSolver::initLeafConstraints()
 {
   const int nrAnatomicalSites = _anatomicalSiteToIndex.size();
   
-  GRBLinExpr sum, sum2;
+  MilpLinExpr sum, sum2;
 
   // Ensure that each leaf v_i receives a unique label
   // satisfying the definition of a sublabeling
@@ -824,14 +2087,13 @@ void IlpPmhSolver::initLeafConstraints()
     _model.addConstr(sum == 0);
     sum.clear();
   }
-  _model.update();
 }
 
 void IlpPmhSolver::initConstraints()
 {
   const int nrAnatomicalSites = _anatomicalSiteToIndex.size();
   
-  GRBLinExpr sum, sum2;
+  MilpLinExpr sum, sum2;
   
   // symmetry breaking constraints
   for (int s = 0; s < nrAnatomicalSites; ++s)
@@ -855,7 +2117,7 @@ void IlpPmhSolver::initConstraints()
           const int i = (*_pNodeToIndex)[v_i];
           sum += _x[i][s][c - 1];
           sum2 += _x[i][s][c];
-          //std::cout << _x[i][s][c - 1].get(GRB_StringAttr_VarName) << "    " << _x[i][s][c].get(GRB_StringAttr_VarName) << std::endl;
+          //std::cout << _x[i][s][c - 1].getName() << "    " << _x[i][s][c].getName() << std::endl;
         }
       }
       _model.addConstr(sum2 <= sum);
@@ -964,6 +2226,12 @@ void IlpPmhSolver::initConstraints()
       for (NodeIt v_i(getTree()); v_i != lemon::INVALID; ++v_i)
       {
         const int i = (*_pNodeToIndex)[v_i];
+        if (isContracted(i))
+        {
+          ++_nrContractedConstrs;
+          continue;
+        }
+        
         _model.addConstr(_y[s][c] >= _x[i][s][c]);
         if (isLeaf(v_i))
         {
@@ -1059,7 +2327,36 @@ void IlpPmhSolver::initConstraints()
     _model.addConstr(_sigma[s] <= sum);
     sum.clear();
   }
+}
+
+void IlpPmhSolver::initSymmetryConstraints()
+{
+  MilpLinExpr sum, sum2;
+  
+  // the sub-label of v_i is at most the sub-label of v_j
+  for (const IntTriple& sij : _symmetricLeaves)
+  {
+    const int s = sij.first;
+    const int i = sij.second.first;
+    const int j = sij.second.second;
+    
+    const int size_L_s = _L[s].size();
+    for (int c = 1; c < size_L_s; ++c)
+    {
+      sum.addTerm(c, _x[i][s][c]);
+      sum2.addTerm(c, _x[j][s][c]);
+    }
+    _model.addConstr(sum <= sum2);
+    ++_nrSymmetryConstrs;
+    sum.clear();
+    sum2.clear();
+  }
+}
 
+void IlpPmhSolver::initPatternConstraints()
+{
+  const int nrAnatomicalSites = _anatomicalSiteToIndex.size();
+  
   if (_pattern == MigrationGraph::S
       || _pattern == MigrationGraph::PS)
   {
@@ -1088,14 +2385,12 @@ void IlpPmhSolver::initConstraints()
   {
     initMultiSourceSeedingConstraints();
   }
-  
-  _model.update();
 }
 
 void IlpPmhSolver::initSingleSourceSeedingConstraints()
 {
   const int nrAnatomicalSites = _indexToAnatomicalSite.size();
-  GRBLinExpr sum;
+  MilpLinExpr sum;
   
   for (Node v_i : _L[_primaryIndex])
   {
@@ -1142,6 +2437,17 @@ void IlpPmhSolver::initMultiSourceSeedingConstraints()
       if (v_i == v_j) continue;
       if (isAncestor(v_i, v_j))
       {
+        if (isContracted(i) || isContracted(j))
+        {
+          // implied by the constraints of the descendants they are contracted to
+          for (int s = 0; s < nrAnatomicalSites; ++s)
+          {
+            const int size_L_s = _L[s].size();
+            _nrContractedConstrs += size_L_s * (size_L_s - 1);
+          }
+          continue;
+        }
+        
         for (int s = 0; s < nrAnatomicalSites; ++s)
         {
           const int size_L_s = _L[s].size();
@@ -1195,12 +2501,41 @@ void IlpPmhSolver::initConstraintsLCA(int s,
   }
 }
 
-GRBLinExpr IlpPmhSolver::initObjective(const IntTriple& bounds)
+MilpLinExpr IlpPmhSolver::getComigrationNumber() const
+{
+  const int nrAnatomicalSites = _anatomicalSiteToIndex.size();
+  
+  MilpLinExpr comigrationNumber;
+  for (int s = 0; s < nrAnatomicalSites; ++s)
+  {
+    for (int t = 0; t < nrAnatomicalSites; ++t)
+    {
+      comigrationNumber += _gamma[s][t];
+    }
+  }
+  
+  return comigrationNumber;
+}
+
+MilpLinExpr IlpPmhSolver::getSeedingSiteNumber() const
+{
+  const int nrAnatomicalSites = _anatomicalSiteToIndex.size();
+  
+  MilpLinExpr seedingSiteNumber;
+  for (int s = 0; s < nrAnatomicalSites; ++s)
+  {
+    seedingSiteNumber += _sigma[s];
+  }
+  
+  return seedingSiteNumber;
+}
+
+MilpLinExpr IlpPmhSolver::initObjective(const IntTriple& bounds)
 {
   const int nrAnatomicalSites = _anatomicalSiteToIndex.size();
   
   // migration number
-  GRBLinExpr migrationNumber;
+  MilpLinExpr migrationNumber;
   for (int s = 0; s < nrAnatomicalSites; ++s)
   {
     const int size_L_s = _L[s].size();
@@ -1217,38 +2552,26 @@ GRBLinExpr IlpPmhSolver::initObjective(const IntTriple& bounds)
   }
 
   // comigration number
-  GRBLinExpr comigrationNumber;
-  for (int s = 0; s < nrAnatomicalSites; ++s)
-  {
-    for (int t = 0; t < nrAnatomicalSites; ++t)
-    {
-      comigrationNumber += _gamma[s][t];
-    }
-  }
+  MilpLinExpr comigrationNumber = getComigrationNumber();
   
   if (bounds.second.first != -1)
   {
     _model.addConstr(comigrationNumber <= bounds.second.first);
   }
   
-  GRBLinExpr seedingSiteNumber;
-  for (int s = 0; s < nrAnatomicalSites; ++s)
-  {
-    seedingSiteNumber += _sigma[s];
-  }
+  MilpLinExpr seedingSiteNumber = getSeedingSiteNumber();
   
   if (bounds.second.second != -1)
   {
     _model.addConstr(seedingSiteNumber <= bounds.second.second);
   }
   
-  GRBLinExpr obj;
+  MilpLinExpr obj;
   obj += migrationNumber
       + (1. / (nrAnatomicalSites * nrAnatomicalSites)) * comigrationNumber
       + (1. / (nrAnatomicalSites * nrAnatomicalSites)) * (1. / (nrAnatomicalSites + 1)) * seedingSiteNumber;
 
-  _model.setObjective(obj, GRB_MINIMIZE);
-  _model.update();
+  _model.setObjective(obj, MilpModel::MINIMIZE);
   
   return obj;
 }
@@ -1276,6 +2599,9 @@ void IlpPmhSolver::constructGraph()
 {
   const int nrAnatomicalSites = _indexToAnatomicalSite.size();
   
+  _G.clear();
+  _rootG = lemon::INVALID;
+  
   // Initialize _subLabelToNodeG
   _subLabelToNodeG = NodeMatrix(nrAnatomicalSites);
   for (int s = 0; s < nrAnatomicalSites; ++s)
@@ -1294,7 +2620,7 @@ void IlpPmhSolver::constructGraph()
         const int size_L_t = _L[t].size();
         for (int d = 0; d < size_L_t; ++d)
         {
-          if (_z[s][c][t][d].get(GRB_DoubleAttr_X) >= 0.4)
+          if (_z[s][c][t][d].getValue() >= 0.4)
           {
             Node v_sc = _subLabelToNodeG[s][c];
             if (v_sc == lemon::INVALID)
@@ -1375,6 +2701,7 @@ void IlpPmhSolver::processSolution()
   const int nrNodes = _indexToNode.size();
   const int nrAnatomicalSites = _anatomicalSiteToIndex.size();
   
+  delete _pLPlus;
   _pLPlus = new StringNodeMap(getTree());
 
   for (int i = 0; i < nrNodes; ++i)
@@ -1387,10 +2714,10 @@ void IlpPmhSolver::processSolution()
       int size_L_s = _L[s].size();
       for (int c = 0; c < size_L_s; ++c)
       {
-        if (_x[i][s][c].get(GRB_DoubleAttr_X) >= 0.4)
+        if (_x[i][s][c].getValue() >= 0.4)
         {
-          //std::cout << _x[i][s][c].get(GRB_StringAttr_VarName)
-          //          << " = " << _x[i][s][c].get(GRB_DoubleAttr_X) << std::endl;
+          //std::cout << _x[i][s][c].getName()
+          //          << " = " << _x[i][s][c].getValue() << std::endl;
           _pLPlus->set(v_i, sStr);
         }
       }
@@ -1421,10 +2748,10 @@ void IlpPmhSolver::processSolution()
 //    int size_L_s = _L[s].size();
 //    for (int c = 0; c < size_L_s; ++c)
 //    {
-//      if (_y[s][c].get(GRB_DoubleAttr_X) >= 0.4)
+//      if (_y[s][c].getValue() >= 0.4)
 //      {
-//        std::cout << _y[s][c].get(GRB_StringAttr_VarName)
-//                  << " = " << _y[s][c].get(GRB_DoubleAttr_X) << std::endl;
+//        std::cout << _y[s][c].getName()
+//                  << " = " << _y[s][c].getValue() << std::endl;
 //      }
 //    }
 //  }
@@ -1441,10 +2768,10 @@ void IlpPmhSolver::processSolution()
 //        const int size_L_t = _L[t].size();
 //        for (int d = 0; d < size_L_t; ++d)
 //        {
-//          if (_z[s][c][t][d].get(GRB_DoubleAttr_X) >= 0.4)
+//          if (_z[s][c][t][d].getValue() >= 0.4)
 //          {
-//            std::cout << _z[s][c][t][d].get(GRB_StringAttr_VarName)
-//                      << " = " << _z[s][c][t][d].get(GRB_DoubleAttr_X) << std::endl;
+//            std::cout << _z[s][c][t][d].getName()
+//                      << " = " << _z[s][c][t][d].getValue() << std::endl;
 //          }
 //        }
 //      }
@@ -11,7 +11,10 @@
 #include "utils.h"
 #include "clonetree.h"
 #include "migrationgraph.h"
-#include <gurobi_c++.h>
+#include "milp/milpmodel.h"
+#include "milp/milpsparsevarmatrix.h"
+#include "profiler.h"
+#include "solutioncache.h"
 
 /// This class implements an ILP for solving the Parsimonious Migration History
 /// (PMH) problem under various topological constraints (PS, S, M and R)
@@ -26,7 +29,7 @@ public:
   /// @param T Clone tree
   /// @param primary Primary tumor
   /// @param pattern Topological constraint
-  /// @param gurobiLogFilename Gurobi logging filename
+  /// @param gurobiLogFilename Solver logging filename
   /// @param forcedComigrations List of ordered pairs of anatomical sites
   /// that must be present
   IlpPmhSolver(const CloneTree& T,
@@ -64,6 +67,22 @@ public:
   /// @param bounds Upper bounds on mu, gamma and sigma
   virtual void init(const IntTriple& bounds);
   
+  /// Return whether the ILP has been initialized
+  bool isInitialized() const
+  {
+    return _nrSharedConstrs != -1;
+  }
+  
+  /// Set the topological constraint and forced comigrations. If the ILP
+  /// has been initialized, only the corresponding constraints are replaced
+  /// and the solution of the previous solve is used as initial solution.
+  ///
+  /// @param pattern Topological constraint
+  /// @param forcedComigrations List of ordered pairs of anatomical sites
+  /// that must be present
+  void update(MigrationGraph::Pattern pattern,
+              const StringPairList& forcedComigrations);
+  
   /// Return lower bound
   double LB() const
   {
@@ -90,6 +109,83 @@ public:
     return _UB;
   }
   
+  /// Set shared objective cutoff, the solve is aborted as soon as no
+  /// solution strictly better than the cutoff can be found
+  ///
+  /// @param pCutoff Cutoff (NULL: no cutoff)
+  void setCutoff(const MilpCutoff* pCutoff)
+  {
+    _model.setCutoff(pCutoff);
+  }
+  
+  /// Set whether the model is reduced before it is solved. Variables that
+  /// are determined by the leaf labeling are fixed, vertices with a single
+  /// child share the variables of their child, sibling leaves labeled by the
+  /// same anatomical site are ordered and constraints that are redundant
+  /// given the variable bounds are dropped. Must be called before init().
+  ///
+  /// @param presolve Presolve
+  void setPresolve(bool presolve)
+  {
+    _presolve = presolve;
+    _model.setPresolve(presolve);
+  }
+  
+  /// Set whether the model is warm-started from a heuristic solution.
+  /// A vertex labeling is computed by the Sankoff algorithm restricted to
+  /// several sets of allowed migrations between anatomical sites, which are
+  /// greedily reduced to lower the comigration number. The best labeling
+  /// that satisfies the topological constraint is the initial solution.
+  /// Must be called before init().
+  ///
+  /// @param warmStart Warm start
+  void setWarmStart(bool warmStart)
+  {
+    _warmStart = warmStart;
+  }
+  
+  /// Set solution cache. Runs whose instance is in the cache do not build
+  /// or solve the ILP, and optimal solutions are added to the cache.
+  ///
+  /// @param pCache Solution cache (NULL: no cache)
+  void setCache(const SolutionCache* pCache)
+  {
+    _pCache = pCache;
+  }
+  
+  /// Write number of variables and constraints before and after presolve
+  ///
+  /// @param out Output stream
+  void writePresolveSummary(std::ostream& out) const;
+  
+  /// Return log filename
+  ///
+  /// @param outputDirectory Output directory (empty: no log file)
+  /// @param outputPrefix Prefix prepended to every output filename
+  /// @param primary Primary tumor
+  /// @param pattern Topological constraint
+  static std::string getLogFilename(const std::string& outputDirectory,
+                                    const std::string& outputPrefix,
+                                    const std::string& primary,
+                                    MigrationGraph::Pattern pattern);
+  
+  /// Return profile filename
+  ///
+  /// @param outputDirectory Output directory (empty: no profile)
+  /// @param outputPrefix Prefix prepended to every output filename
+  /// @param primary Primary tumor
+  /// @param pattern Topological constraint
+  static std::string getProfileFilename(const std::string& outputDirectory,
+                                        const std::string& outputPrefix,
+                                        const std::string& primary,
+                                        MigrationGraph::Pattern pattern);
+  
+  /// Return the per-phase timings and model counters of the last run
+  const Profiler& getProfiler() const
+  {
+    return _profiler;
+  }
+  
   /// Solve PMH under a topological constraint
   ///
   /// @param T Non-binary clone tree
@@ -105,6 +201,7 @@ public:
   /// @param bounds Upper bounds on mu, gamma and sigma
   /// @param forcedComigrations List of ordered pairs of anatomical sites
   /// that must be present
+  /// @param out Output stream receiving the results
   static IntTriple run(const CloneTree& T,
                        const std::string& primary,
                        const std::string& outputDirectory,
@@ -116,12 +213,132 @@ public:
                        bool outputSearchGraph,
                        int timeLimit,
                        const IntTriple& bounds,
-                       const StringPairList& forcedComigrations);
+                       const StringPairList& forcedComigrations,
+                       std::ostream& out);
+  
+  /// Solve PMH under a topological constraint using the given solver.
+  /// The solver is initialized on the first call, subsequent calls reuse
+  /// the model and only replace the pattern constraints and forced
+  /// comigrations (bounds must remain the same). If the solver has a
+  /// solution cache, cached instances are reported without initializing
+  /// the solver and optimal solutions are added to the cache.
+  ///
+  /// @param solver Solver
+  /// @param T Non-binary clone tree
+  /// @param primary Primary tumor
+  /// @param outputDirectory Output directory
+  /// @param outputPrefix Prefix prepended to every output filename
+  /// @param colorMap Color map
+  /// @param pattern Topological constraint
+  /// @param nrThreads Number of threads
+  /// @param outputILP Output ILP model
+  /// @param outputSearchGraph Output search graph
+  /// @param timeLimit Time limit in seconds
+  /// @param bounds Upper bounds on mu, gamma and sigma
+  /// @param forcedComigrations List of ordered pairs of anatomical sites
+  /// that must be present
+  /// @param out Output stream receiving the results
+  static IntTriple run(IlpPmhSolver& solver,
+                       const CloneTree& T,
+                       const std::string& primary,
+                       const std::string& outputDirectory,
+                       const std::string& outputPrefix,
+                       const StringToIntMap& colorMap,
+                       MigrationGraph::Pattern pattern,
+                       int nrThreads,
+                       bool outputILP,
+                       bool outputSearchGraph,
+                       int timeLimit,
+                       const IntTriple& bounds,
+                       const StringPairList& forcedComigrations,
+                       std::ostream& out);
+  
+  /// Enumerate all non-dominated (mu, gamma, sigma) triples under a
+  /// topological constraint using the given solver, by iteratively
+  /// bounding gamma and sigma (epsilon-constraint method) and solving the
+  /// same model. Every triple is written to out with its vertex labeling as
+  /// soon as it is found. If the time limit, which applies to the entire
+  /// enumeration, is reached, the triples found so far are returned.
+  ///
+  /// @param solver Solver
+  /// @param T Non-binary clone tree
+  /// @param primary Primary tumor
+  /// @param outputDirectory Output directory
+  /// @param outputPrefix Prefix prepended to every output filename
+  /// @param colorMap Color map
+  /// @param pattern Topological constraint
+  /// @param nrThreads Number of threads
+  /// @param timeLimit Time limit in seconds
+  /// @param bounds Upper bounds on mu, gamma and sigma
+  /// @param forcedComigrations List of ordered pairs of anatomical sites
+  /// that must be present
+  /// @param out Output stream receiving the results
+  static std::vector<IntTriple> runPareto(IlpPmhSolver& solver,
+                                          const CloneTree& T,
+                                          const std::string& primary,
+                                          const std::string& outputDirectory,
+                                          const std::string& outputPrefix,
+                                          const StringToIntMap& colorMap,
+                                          MigrationGraph::Pattern pattern,
+                                          int nrThreads,
+                                          int timeLimit,
+                                          const IntTriple& bounds,
+                                          const StringPairList& forcedComigrations,
+                                          std::ostream& out);
   
 protected:
+  /// Write profile of the last run in JSON format
+  ///
+  /// @param filename Filename (empty: no profile)
+  void writeProfile(const std::string& filename);
+  
+  /// Write the clone tree, migration graph and vertex labeling of the
+  /// current solution to files named
+  /// outputDirectory/outputPrefix{T,G}-primary-name.{dot,tree,labeling}
+  ///
+  /// @param G Migration graph of the current solution
+  /// @param outputDirectory Output directory
+  /// @param outputPrefix Prefix prepended to every output filename
+  /// @param primary Primary tumor
+  /// @param name Suffix of every output filename
+  /// @param colorMap Color map
+  void writeSolution(const MigrationGraph& G,
+                     const std::string& outputDirectory,
+                     const std::string& outputPrefix,
+                     const std::string& primary,
+                     const std::string& name,
+                     const StringToIntMap& colorMap) const;
+  
+  /// Report a cached solution as if it was obtained by the given solver,
+  /// the search graph is not written as no ILP has been solved
+  ///
+  /// @param solver Solver
+  /// @param entry Cached solution
+  /// @param primary Primary tumor
+  /// @param outputDirectory Output directory
+  /// @param outputPrefix Prefix prepended to every output filename
+  /// @param colorMap Color map
+  /// @param pattern Topological constraint
+  /// @param out Output stream receiving the results
+  static IntTriple runCached(IlpPmhSolver& solver,
+                             const SolutionCache::Entry& entry,
+                             const std::string& primary,
+                             const std::string& outputDirectory,
+                             const std::string& outputPrefix,
+                             const StringToIntMap& colorMap,
+                             MigrationGraph::Pattern pattern,
+                             std::ostream& out);
+  
   /// Initialize indices and mappings
   virtual void initIndices();
   
+  /// Initialize sub-label indices and the anatomical sites
+  /// that occur in each subtree
+  void initReachability();
+  
+  /// Initialize the reductions of presolve
+  virtual void initPresolve();
+  
   /// Initialize ILP variables
   virtual void initVariables();
   
@@ -155,13 +372,77 @@ protected:
   /// Initialize ILP S constraints
   virtual void initSingleSourceSeedingConstraints();
   
+  /// Initialize ILP constraints that break symmetries found by presolve
+  virtual void initSymmetryConstraints();
+  
+  /// Initialize ILP constraints specific to the topological constraint
+  virtual void initPatternConstraints();
+  
   /// Initialize initial solution
   virtual void initWarmStart();
   
+  /// Initialize initial solution from a heuristic vertex labeling,
+  /// returns false if no labeling satisfying the topological constraint
+  /// was found
+  bool initHeuristicWarmStart();
+  
+  /// Label the vertices by the Sankoff algorithm, minimizing the number of
+  /// migrations subject to the allowed migrations between anatomical sites.
+  /// The state of a vertex is its anatomical site index, or the number of
+  /// anatomical sites if it is part of the subtree labeled by (P,0); leaves
+  /// that are not required are assigned state -1. Returns false if no
+  /// labeling exists.
+  ///
+  /// @param order Vertex indices in preorder
+  /// @param parent Parent vertex index (-1 for the root)
+  /// @param allowed allowed[s][t] = true iff migrations from s to t are allowed
+  /// @param state Resulting state of every vertex index
+  bool labelVertices(const IntVector& order,
+                     const IntVector& parent,
+                     const BoolMatrix& allowed,
+                     IntVector& state) const;
+  
+  /// Compute the sub-labels of the given vertex labeling, returns false
+  /// if the labeling violates the topological constraint, the forced
+  /// comigrations or the ordering of sub-labels of the ILP
+  ///
+  /// @param order Vertex indices in preorder
+  /// @param parent Parent vertex index (-1 for the root)
+  /// @param state State of every vertex index as computed by labelVertices
+  /// @param subLabel Resulting sub-label index of every vertex index
+  /// (-1 for leaves that are not required)
+  /// @param obj Resulting objective value
+  bool getSubLabeling(const IntVector& order,
+                      const IntVector& parent,
+                      const IntVector& state,
+                      IntVector& subLabel,
+                      double& obj) const;
+  
+  /// Set initial solution given the sub-label index of every vertex index
+  ///
+  /// @param subLabel Sub-label index of every vertex index
+  /// (-1 for leaves that are not required)
+  virtual void setStart(const IntVector& subLabel);
+  
+  /// Return whether the given leaf must be present in the heuristic
+  /// initial solution
+  ///
+  /// @param v_i Leaf
+  virtual bool isRequiredLeaf(Node v_i) const
+  {
+    return true;
+  }
+  
   /// Initialize ILP objective function
   ///
   /// @param bounds Upper bounds on mu, gamma and sigma
-  virtual GRBLinExpr initObjective(const IntTriple& bounds);
+  virtual MilpLinExpr initObjective(const IntTriple& bounds);
+  
+  /// Return the comigration number in terms of the model variables
+  MilpLinExpr getComigrationNumber() const;
+  
+  /// Return the seeding site number in terms of the model variables
+  MilpLinExpr getSeedingSiteNumber() const;
   
   /// Process ILP solution
   virtual void processSolution();
@@ -227,6 +508,57 @@ protected:
     return _T;
   }
   
+  /// Return bounds of variable x[i][s][c] implied by reachability and presolve
+  ///
+  /// @param i Vertex index
+  /// @param s Anatomical site index
+  /// @param c Sub-label index
+  /// @param lb Lower bound
+  /// @param ub Upper bound
+  void getBoundsX(int i, int s, int c,
+                  double& lb, double& ub) const;
+  
+  /// Add binary variable, a null variable is returned if it is fixed to 0
+  ///
+  /// @param lb Lower bound
+  /// @param ub Upper bound
+  /// @param name Name
+  MilpVar addBinaryVar(double lb, double ub, const char* name);
+  
+  /// Return the number of sub-labels (s,c)
+  int getNrSubLabels() const
+  {
+    return _indexToSubLabel.size();
+  }
+  
+  /// Return the index of sub-label (s,c)
+  ///
+  /// @param s Anatomical site index
+  /// @param c Sub-label index
+  int getSubLabelIndex(int s, int c) const
+  {
+    assert(0 <= c && c < _L[s].size());
+    return _subLabelOffset[s] + c;
+  }
+  
+  /// Return the column of variables xx[ij] and zz[i] indexed by
+  /// the given pair of sub-label indices
+  ///
+  /// @param k Sub-label index of (s,c)
+  /// @param l Sub-label index of (t,d)
+  int getSubLabelPairIndex(int k, int l) const
+  {
+    return k * getNrSubLabels() + l;
+  }
+  
+  /// Return whether vertex v_i shares the variables x[i] of another vertex
+  ///
+  /// @param i Vertex index
+  bool isContracted(int i) const
+  {
+    return _contractedTo[i] != i;
+  }
+  
   /// Construct graph
   void constructGraph();
   
@@ -235,50 +567,22 @@ protected:
                           Node v_i,
                           Node v_j);
   
-  /// Solve PMH under a topological constraint
-  ///
-  /// @param solver Solver
-  /// @param T Non-binary clone tree
-  /// @param primary Primary tumor
-  /// @param outputDirectory Output directory
-  /// @param outputPrefix Prefix prepended to every output filename
-  /// @param colorMap Color map
-  /// @param pattern Topological constraint
-  /// @param nrThreads Number of threads
-  /// @param outputILP Output ILP model
-  /// @param outputSearchGraph Output search graph
-  /// @param timeLimit Time limit in seconds
-  /// @param bounds Upper bounds on mu, gamma and sigma
-  /// @param forcedComigrations List of ordered pairs of anatomical sites
-  /// that must be present
-  static IntTriple run(IlpPmhSolver& solver,
-                       const CloneTree& T,
-                       const std::string& primary,
-                       const std::string& outputDirectory,
-                       const std::string& outputPrefix,
-                       const StringToIntMap& colorMap,
-                       MigrationGraph::Pattern pattern,
-                       int nrThreads,
-                       bool outputILP,
-                       bool outputSearchGraph,
-                       int timeLimit,
-                       const IntTriple& bounds,
-                       const StringPairList& forcedComigrations);
-  
   /// Vector of node sets
   typedef std::vector<NodeSet> NodeSetVector;
-  /// Gurobi variable array
-  typedef std::vector<GRBVar> VarArray;
-  /// Gurobi variable matrix
+  /// Variable array
+  typedef std::vector<MilpVar> VarArray;
+  /// Variable matrix
   typedef std::vector<VarArray> VarMatrix;
-  /// Gurobi variable 3D matrix
+  /// Variable 3D matrix
   typedef std::vector<VarMatrix> Var3Matrix;
-  /// Gurobi variable 4D matrix
+  /// Variable 4D matrix
   typedef std::vector<Var3Matrix> Var4Matrix;
-  /// Gurobi variable 5D matrix
+  /// Variable 5D matrix
   typedef std::vector<Var4Matrix> Var5Matrix;
   /// Node matrix
   typedef std::vector<NodeVector> NodeMatrix;
+  /// Vector of pairs
+  typedef std::vector<IntPair> IntPairVector;
 
 private:
   /// Clone tree
@@ -288,9 +592,12 @@ protected:
   /// Label of primary tumor anatomical site
   const std::string& _primary;
   /// Topological constraint
-  const MigrationGraph::Pattern _pattern;
+  MigrationGraph::Pattern _pattern;
   /// List of ordered pairs of anatomical sites that must be present
-  const StringPairList& _forcedComigrations;
+  StringPairList _forcedComigrations;
+  /// Number of constraints that do not depend on the topological constraint
+  /// and forced comigrations (-1: not initialized)
+  int _nrSharedConstrs;
   
   /// lca(s)
   NodeVector _lca;
@@ -312,15 +619,46 @@ protected:
   NodeSetVector _L;
   /// Maximum number of edges in G
   int _maxNrEdgesInG;
+  
+  /// Index of sub-label (s,0), followed by the total number of sub-labels
+  IntVector _subLabelOffset;
+  /// Sub-label (s,c) of index
+  IntPairVector _indexToSubLabel;
+  /// presentSites[i][s] = true iff the subtree rooted at v_i has a leaf
+  /// labeled by anatomical site s
+  BoolMatrix _presentSites;
+  /// Number of variables that were not created as they are fixed to 0
+  int _nrPrunedVars;
+  
+  /// Reduce the model before it is solved
+  bool _presolve;
+  /// Index of the vertex whose variables x are shared by vertex v_i
+  IntVector _contractedTo;
+  /// Pairs of sibling leaves labeled by the same anatomical site,
+  /// (s, (i, j)) denotes that the sub-label of v_i is at most that of v_j
+  std::vector<IntTriple> _symmetricLeaves;
+  /// Number of variables that were not created due to contraction
+  int _nrContractedVars;
+  /// Number of constraints that were not added due to contraction
+  int _nrContractedConstrs;
+  /// Number of symmetry breaking constraints
+  int _nrSymmetryConstrs;
+  /// Warm start from a heuristic solution
+  bool _warmStart;
+  /// Solution cache (NULL: no cache)
+  const SolutionCache* _pCache;
 
-  /// Gurobi environment
-  GRBEnv _env;
-  /// Gurobi model
-  GRBModel _model;
-  /// x[i][s][c] = 1 iff vertex v_i occurs in X_(s,c)
+  /// Model
+  MilpModel _model;
+  /// Per-phase timings and model counters
+  Profiler _profiler;
+  /// x[i][s][c] = 1 iff vertex v_i occurs in X_(s,c), null if v_i has no
+  /// descendant leaf labeled by s and (s,c) != (P,0)
   Var3Matrix _x;
-  /// xx[ij][s][c][t][d] = 1 iff vertex (v_i, v_j) in E(T), x[i][s][c] = 1 and x[j][t][d] = 1
-  Var5Matrix _xx;
+  /// xx[ij][s][c][t][d] = 1 iff vertex (v_i, v_j) in E(T), x[i][s][c] = 1 and x[j][t][d] = 1,
+  /// stored in row ij and column getSubLabelPairIndex of (s,c) and (t,d)
+  /// for variables that are not fixed to 0
+  MilpSparseVarMatrix _xx;
   /// y[s][c] = 1 iff there exists a leaf labeled by (s,c)
   VarMatrix _y;
   /// z[s][c][t][d] = 1 if and only if there exists an edge from (s,c) to (t,d)
@@ -333,9 +671,9 @@ protected:
   /// sigma[s] = 1 if and only if there exists t s.t. gamma[s][t] = 1
   VarArray _sigma;
   
-  /// Lowerbound on the optimal solution (inferred by Gurobi)
+  /// Lowerbound on the optimal solution (inferred by the solver)
   double _LB;
-  /// Upperbound on the optimal solution (inferred by Gurobi)
+  /// Upperbound on the optimal solution (inferred by the solver)
   double _UB;
   
   /// Graph
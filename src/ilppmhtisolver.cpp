@@ -6,6 +6,8 @@
  */
 
 #include "ilppmhtisolver.h"
+#include <algorithm>
+#include <limits>
 
 IlpPmhTiSolver::IlpPmhTiSolver(const CloneTree& T,
                                const FrequencyMatrix& F,
@@ -25,6 +27,7 @@ IlpPmhTiSolver::IlpPmhTiSolver(const CloneTree& T,
                        DoubleVector(F.getNrCharacters(), 0)))
   , _extT()
   , _rootExtT(lemon::INVALID)
+  , _compactExtT()
   , _labelExtT( _extT)
   , _leafAnatomicalSiteLabelExtT(_extT)
   , _TtoExtT(IlpPmhTrSolver::getTree(), lemon::INVALID)
@@ -72,7 +75,7 @@ void IlpPmhTiSolver::initLeafVariables()
                    getLabel(v_i).c_str(),
                    _indexToAnatomicalSite[s].c_str(), c);
         }
-        _x[i][s][c] = strlen(buf) > 255 ? _model.addVar(0, 1, 0, GRB_BINARY) : _model.addVar(0, 1, 0, GRB_BINARY, buf);
+        _x[i][s][c] = strlen(buf) > 255 ? _model.addVar(0, 1, 0, MilpVar::BINARY) : _model.addVar(0, 1, 0, MilpVar::BINARY, buf);
       }
     }
   }
@@ -99,12 +102,11 @@ void IlpPmhTiSolver::initLeafVariables()
                    getLabel(v_i).c_str(),
                    _indexToAnatomicalSite[s].c_str(), c);
         }
-        _r[i][s][c] = strlen(buf) > 255 ? _model.addVar(0, 1, 0, GRB_BINARY) : _model.addVar(0, 1, 0, GRB_BINARY, buf);
+        _r[i][s][c] = strlen(buf) > 255 ? _model.addVar(0, 1, 0, MilpVar::BINARY) : _model.addVar(0, 1, 0, MilpVar::BINARY, buf);
       }
     }
   }
   
-  _model.update();
 }
 
 void IlpPmhTiSolver::processSolution()
@@ -126,10 +128,10 @@ void IlpPmhTiSolver::processSolution()
 //          int size_L_t = _L[t].size();
 //          for (int d = 0; d < size_L_t; ++d)
 //          {
-//            if (_xx[ij][s][c][t][d].get(GRB_DoubleAttr_X) >= 0.4)
+//            if (_xx[ij][s][c][t][d].getValue() >= 0.4)
 //            {
-//              std::cout << _xx[ij][s][c][t][d].get(GRB_StringAttr_VarName)
-//              << " = " << _xx[ij][s][c][t][d].get(GRB_DoubleAttr_X) << std::endl;
+//              std::cout << _xx[ij][s][c][t][d].getName()
+//              << " = " << _xx[ij][s][c][t][d].getValue() << std::endl;
 //            }
 //          }
 //        }
@@ -151,10 +153,10 @@ void IlpPmhTiSolver::processSolution()
 //          int size_L_t = _L[t].size();
 //          for (int d = 0; d < size_L_t; ++d)
 //          {
-//            if (_zz[i][s][c][t][d].get(GRB_DoubleAttr_X) >= 0.4)
+//            if (_zz[i][s][c][t][d].getValue() >= 0.4)
 //            {
-//              std::cout << _zz[i][s][c][t][d].get(GRB_StringAttr_VarName)
-//              << " = " << _zz[i][s][c][t][d].get(GRB_DoubleAttr_X) << std::endl;
+//              std::cout << _zz[i][s][c][t][d].getName()
+//              << " = " << _zz[i][s][c][t][d].getValue() << std::endl;
 //            }
 //          }
 //        }
@@ -171,12 +173,12 @@ void IlpPmhTiSolver::processSolution()
 //      int size_L_s = _L[s].size();
 //      for (int c = 0; c < size_L_s; ++c)
 //      {
-//        if (_x[i][s][c].get(GRB_DoubleAttr_X) >= 0.4)
+//        if (_x[i][s][c].getValue() >= 0.4)
 //        {
-//          std::cout << _x[i][s][c].get(GRB_StringAttr_VarName)
-//                    << " = " << _x[i][s][c].get(GRB_DoubleAttr_X) << std::endl;
-//          std::cout << _r[i][s][c].get(GRB_StringAttr_VarName)
-//                    << " = " << _r[i][s][c].get(GRB_DoubleAttr_X) << std::endl;
+//          std::cout << _x[i][s][c].getName()
+//                    << " = " << _x[i][s][c].getValue() << std::endl;
+//          std::cout << _r[i][s][c].getName()
+//                    << " = " << _r[i][s][c].getValue() << std::endl;
 //        }
 //      }
 //    }
@@ -188,10 +190,10 @@ void IlpPmhTiSolver::processSolution()
 //  {
 //    if (!isLeaf(v_i)) continue;
 //    const int i = (*_pNodeToIndex)[v_i];
-//    if (_x[i][nrAnatomicalSites][0].get(GRB_DoubleAttr_X) >= 0.4)
+//    if (_x[i][nrAnatomicalSites][0].getValue() >= 0.4)
 //    {
-//      std::cout << _x[i][nrAnatomicalSites][0].get(GRB_StringAttr_VarName)
-//                << " = " << _x[i][nrAnatomicalSites][0].get(GRB_DoubleAttr_X) << std::endl;
+//      std::cout << _x[i][nrAnatomicalSites][0].getName()
+//                << " = " << _x[i][nrAnatomicalSites][0].getValue() << std::endl;
 //    }
 //  }
 //
@@ -202,10 +204,10 @@ void IlpPmhTiSolver::processSolution()
 //    int size_L_s = _L[s].size();
 //    for (int c = 0; c < size_L_s; ++c)
 //    {
-//      if (_y[s][c].get(GRB_DoubleAttr_X) >= 0.4)
+//      if (_y[s][c].getValue() >= 0.4)
 //      {
-//        std::cout << _y[s][c].get(GRB_StringAttr_VarName)
-//                  << " = " << _y[s][c].get(GRB_DoubleAttr_X) << std::endl;
+//        std::cout << _y[s][c].getName()
+//                  << " = " << _y[s][c].getValue() << std::endl;
 //      }
 //    }
 //  }
@@ -217,10 +219,10 @@ void IlpPmhTiSolver::processSolution()
 //    int mapped_i = _F.characterToIndex(getOrgT().label(v_i));
 //    for (int p = 0; p < nrSamples; ++p)
 //    {
-//      std::cout << _f[p][mapped_i].get(GRB_StringAttr_VarName)
-//                << " = " << _f[p][mapped_i].get(GRB_DoubleAttr_X) << std::endl;
-//      std::cout << _u[p][mapped_i].get(GRB_StringAttr_VarName)
-//                << " = " << _u[p][mapped_i].get(GRB_DoubleAttr_X) << std::endl;
+//      std::cout << _f[p][mapped_i].getName()
+//                << " = " << _f[p][mapped_i].getValue() << std::endl;
+//      std::cout << _u[p][mapped_i].getName()
+//                << " = " << _u[p][mapped_i].getValue() << std::endl;
 //    }
 //  }
   
@@ -239,10 +241,10 @@ void IlpPmhTiSolver::processSolution()
       int size_L_s = _L[s].size();
       for (int c = 0; c < size_L_s; ++c)
       {
-        if (_r[i][s][c].get(GRB_DoubleAttr_X) >= 0.4)
+        if (_r[i][s][c].getValue() >= 0.4)
         {
-          //          std::cout << _r[i][s][c].get(GRB_StringAttr_VarName)
-          //                    << " = " << _r[i][s][c].get(GRB_DoubleAttr_X) << std::endl;
+          //          std::cout << _r[i][s][c].getName()
+          //                    << " = " << _r[i][s][c].getValue() << std::endl;
           (*_pNodeToRootState)[v_i] = std::make_pair(s, c);
         }
       }
@@ -257,10 +259,10 @@ void IlpPmhTiSolver::processSolution()
       int size_L_s = _L[s].size();
       for (int c = 0; c < size_L_s; ++c)
       {
-        if (_x[i][s][c].get(GRB_DoubleAttr_X) >= 0.4)
+        if (_x[i][s][c].getValue() >= 0.4)
         {
-//          std::cout << _x[i][s][c].get(GRB_StringAttr_VarName)
-//                    << " = " << _x[i][s][c].get(GRB_DoubleAttr_X) << std::endl;
+//          std::cout << _x[i][s][c].getName()
+//                    << " = " << _x[i][s][c].getValue() << std::endl;
           (*_pNodeToStateSet)[v_i].insert(std::make_pair(s, c));
         }
       }
@@ -272,10 +274,10 @@ void IlpPmhTiSolver::processSolution()
     Node v_i = _indexToNode[i];
     if (isLeaf(v_i))
     {
-      if (_x[i][nrAnatomicalSites][0].get(GRB_DoubleAttr_X) >= 0.4)
+      if (_x[i][nrAnatomicalSites][0].getValue() >= 0.4)
       {
-//        std::cout << _x[i][nrAnatomicalSites][0].get(GRB_StringAttr_VarName)
-//                  << " = " << _x[i][nrAnatomicalSites][0].get(GRB_DoubleAttr_X) << std::endl;
+//        std::cout << _x[i][nrAnatomicalSites][0].getName()
+//                  << " = " << _x[i][nrAnatomicalSites][0].getValue() << std::endl;
         leafPresence[v_i] = false;
       }
     }
@@ -303,7 +305,7 @@ void IlpPmhTiSolver::processSolution()
 
     for (int p = 0; p < nrSamples; ++p)
     {
-      double val = _f[p][i].get(GRB_DoubleAttr_X);
+      double val = _f[p][i].getValue();
       if (g_tol.nonZero(val))
       {
         (*_pResF)[v_i][p] = val;
@@ -330,7 +332,7 @@ void IlpPmhTiSolver::processSolution()
     int idx = 0;
     for (int p : samples)
     {
-      double val = _u[p][mapped_i].get(GRB_DoubleAttr_X);
+      double val = _u[p][mapped_i].getValue();
       if (g_tol.nonZero(val))
       {
         (*_pResU)[v_is][idx] = val;
@@ -340,85 +342,109 @@ void IlpPmhTiSolver::processSolution()
   }
 }
 
+void IlpPmhTiSolver::setStart(const IntVector& subLabel)
+{
+  IlpPmhTrSolver::setStart(subLabel);
+  
+  const int nrAnatomicalSites = _anatomicalSiteToIndex.size();
+  
+  for (NodeIt v_i(getTree()); v_i != lemon::INVALID; ++v_i)
+  {
+    if (!isLeaf(v_i)) continue;
+    
+    const int i = (*_pNodeToIndex)[v_i];
+    _x[i][nrAnatomicalSites][0].setStart(subLabel[i] == -1 ? 1 : 0);
+    _r[i][nrAnatomicalSites][0].setStart(subLabel[i] == -1 ? 1 : 0);
+  }
+}
+
 void IlpPmhTiSolver::initIndices()
 {
   // construct _extT
-  computeFmin(getOrgT().root());
-  computeFmax(getOrgT().root());
+  computeFmin(getOrgT(), _F, getOrgT().root(), _Fmin);
+  computeFmax(getOrgT(), _F, getOrgT().root(), _Fmin, _Fmax);
   computeUmax();
   
   _pNodeToIndex = new IntNodeMap(_extT, -1);
   _pArcToIndex = new IntArcMap(_extT, -1);
   
   constructExtT(getOrgT().root());
+  _compactExtT.init(_extT, _rootExtT);
   
   IlpPmhTrSolver::initIndices();
 }
 
-void IlpPmhTiSolver::computeFmin(Node v_i)
+void IlpPmhTiSolver::computeFmin(const CloneTree& T,
+                                 const FrequencyMatrix& F,
+                                 Node v_i,
+                                 DoubleMatrix& Fmin)
 {
-  const int k = _F.getNrSamples();
-  const int i = _F.characterToIndex(getOrgT().label(v_i));
+  const int k = F.getNrSamples();
+  const int i = F.characterToIndex(T.label(v_i));
   
-  const Digraph& T = getOrgT().tree();
+  const Digraph& tree = T.tree();
   
-  if (OutArcIt(T, v_i) == lemon::INVALID)
+  if (OutArcIt(tree, v_i) == lemon::INVALID)
   {
     for (int p = 0; p < k; ++p)
     {
-      _Fmin[p][i] = _F.min(p,i);
+      Fmin[p][i] = F.min(p,i);
     }
   }
   else
   {
-    for (OutArcIt a_ij(T, v_i); a_ij != lemon::INVALID; ++a_ij)
+    for (OutArcIt a_ij(tree, v_i); a_ij != lemon::INVALID; ++a_ij)
     {
-      Node v_j = T.target(a_ij);
-      computeFmin(v_j);
+      Node v_j = tree.target(a_ij);
+      computeFmin(T, F, v_j, Fmin);
     }
     
     for (int p = 0; p < k; ++p)
     {
       double sum_p = 0;
-      for (OutArcIt a_ij(T, v_i); a_ij != lemon::INVALID; ++a_ij)
+      for (OutArcIt a_ij(tree, v_i); a_ij != lemon::INVALID; ++a_ij)
       {
-        Node v_j = T.target(a_ij);
-        int j = _F.characterToIndex(getOrgT().label(v_j));
-        sum_p += _Fmin[p][j];
+        Node v_j = tree.target(a_ij);
+        int j = F.characterToIndex(T.label(v_j));
+        sum_p += Fmin[p][j];
       }
-      _Fmin[p][i] = std::max(_F.min(p, i), sum_p);
+      Fmin[p][i] = std::max(F.min(p, i), sum_p);
     }
   }
 }
 
-void IlpPmhTiSolver::computeFmax(Node v_i)
+void IlpPmhTiSolver::computeFmax(const CloneTree& T,
+                                 const FrequencyMatrix& F,
+                                 Node v_i,
+                                 const DoubleMatrix& Fmin,
+                                 DoubleMatrix& Fmax)
 {
-  const int k = _F.getNrSamples();
-  const int i = _F.characterToIndex(getOrgT().label(v_i));
-  const Digraph& T = getOrgT().tree();
+  const int k = F.getNrSamples();
+  const int i = F.characterToIndex(T.label(v_i));
+  const Digraph& tree = T.tree();
   
-  if (v_i == getOrgT().root())
+  if (v_i == T.root())
   {
     for (int p = 0; p < k; ++p)
     {
-      _Fmax[p][i] = _F.max(p, i);
+      Fmax[p][i] = F.max(p, i);
     }
   }
   else
   {
-    Node v_pi_i = T.source(InArcIt(T, v_i));
-    int pi_i = _F.characterToIndex(getOrgT().label(v_pi_i));
+    Node v_pi_i = tree.source(InArcIt(tree, v_i));
+    int pi_i = F.characterToIndex(T.label(v_pi_i));
     
     for (int p = 0; p < k; ++p)
     {
-      double sum_p = _Fmax[p][pi_i];
-      for (OutArcIt a_pi_i_j(T, v_pi_i); a_pi_i_j != lemon::INVALID; ++a_pi_i_j)
+      double sum_p = Fmax[p][pi_i];
+      for (OutArcIt a_pi_i_j(tree, v_pi_i); a_pi_i_j != lemon::INVALID; ++a_pi_i_j)
       {
-        Node v_j = T.target(a_pi_i_j);
+        Node v_j = tree.target(a_pi_i_j);
         if (v_j == v_i) continue;
         
-        int j = _F.characterToIndex(getOrgT().label(v_j));
-        sum_p -= _Fmin[p][j];
+        int j = F.characterToIndex(T.label(v_j));
+        sum_p -= Fmin[p][j];
       }
       
       if (!g_tol.nonZero(sum_p))
@@ -426,15 +452,15 @@ void IlpPmhTiSolver::computeFmax(Node v_i)
         sum_p = 0;
       }
       
-      _Fmax[p][i] = std::min(_F.max(p, i), sum_p);
-      assert(_Fmax[p][i] >= 0);
+      Fmax[p][i] = std::min(F.max(p, i), sum_p);
+      assert(Fmax[p][i] >= 0);
     }
   }
   
-  for (OutArcIt a_ij(T, v_i); a_ij != lemon::INVALID; ++a_ij)
+  for (OutArcIt a_ij(tree, v_i); a_ij != lemon::INVALID; ++a_ij)
   {
-    Node v_j = T.target(a_ij);
-    computeFmax(v_j);
+    Node v_j = tree.target(a_ij);
+    computeFmax(T, F, v_j, Fmin, Fmax);
   }
 }
 
@@ -573,7 +599,7 @@ void IlpPmhTiSolver::initConstraints()
 //  const int nrCharacters = _F.getNrCharacters();
   const int nrAnatomicalSites = _anatomicalSiteToIndex.size();
   
-  GRBLinExpr sum, sum2;
+  MilpLinExpr sum, sum2;
   
   for (NodeIt v_i(getOrgT().tree()); v_i != lemon::INVALID; ++v_i)
   {
@@ -646,7 +672,6 @@ void IlpPmhTiSolver::initConstraints()
     }
   }
   
-  _model.update();
   
 //  for (int i = 0; i < _indexToNode.size(); ++i)
 //  {
@@ -660,7 +685,7 @@ void IlpPmhTiSolver::initConstraints()
 void IlpPmhTiSolver::initSingleSourceSeedingConstraints()
 {
   const int nrAnatomicalSites = _indexToAnatomicalSite.size();
-  GRBLinExpr sum;
+  MilpLinExpr sum;
   
   for (Node v_i : _L[_primaryIndex])
   {
@@ -699,7 +724,7 @@ void IlpPmhTiSolver::initLeafConstraints()
 {
   const int nrAnatomicalSites = _anatomicalSiteToIndex.size();
   
-  GRBLinExpr sum, sum2;
+  MilpLinExpr sum, sum2;
   
   // Ensure that each leaf v_i receives a unique label
   // satisfying the definition of a sublabeling
@@ -764,18 +789,9 @@ void IlpPmhTiSolver::initLeafConstraints()
       for (int c = 0; c < size_L_s; ++c)
       {
         sum2 += _x[i][s][c];
-        for (int t = 0; t < nrAnatomicalSites; ++t)
-        {
-          const int size_L_t = _L[t].size();
-          for (int d = 0; d < size_L_t; ++d)
-          {
-            sum += _zz[i][s][c][t][d];
-            _model.addConstr(_zz[i][s][c][t][d] <= _x[i][s][c]);
-            _model.addConstr(_zz[i][s][c][t][d] <= _x[i][t][d]);
-          }
-        }
       }
     }
+    initConstraintsZZ(i, sum);
     _model.addConstr(sum2 + _x[i][nrAnatomicalSites][0] - 1 == sum);
     sum.clear();
     sum2.clear();
@@ -801,7 +817,7 @@ void IlpPmhTiSolver::initVariables()
       snprintf(buf, 1024, "f;%s;%s",
                _F.indexToSample(p).c_str(),
                _F.indexToCharacter(c).c_str());
-      _f[p][c] = strlen(buf) > 255 ? _model.addVar(0, 1, 0, GRB_CONTINUOUS) : _model.addVar(0, 1, 0, GRB_CONTINUOUS, buf);
+      _f[p][c] = strlen(buf) > 255 ? _model.addVar(0, 1, 0, MilpVar::CONTINUOUS) : _model.addVar(0, 1, 0, MilpVar::CONTINUOUS, buf);
     }
   }
   
@@ -815,11 +831,10 @@ void IlpPmhTiSolver::initVariables()
       snprintf(buf, 1024, "u;%s;%s",
                _F.indexToSample(p).c_str(),
                _F.indexToCharacter(c).c_str());
-      _u[p][c] = strlen(buf) > 255 ? _model.addVar(0, 1, 0, GRB_CONTINUOUS) : _model.addVar(0, 1, 0, GRB_CONTINUOUS, buf);
+      _u[p][c] = strlen(buf) > 255 ? _model.addVar(0, 1, 0, MilpVar::CONTINUOUS) : _model.addVar(0, 1, 0, MilpVar::CONTINUOUS, buf);
     }
   }
   
-  _model.update();
 }
 
 IntTriple IlpPmhTiSolver::run(const CloneTree& T,
@@ -835,7 +850,10 @@ IntTriple IlpPmhTiSolver::run(const CloneTree& T,
                               int timeLimit,
                               const IntTriple& bounds,
                               const StringPairList& forcedComigrations,
-                              bool disablePolytomyResolution)
+                              bool disablePolytomyResolution,
+                              bool warmStart,
+                              const MilpCutoff* pCutoff,
+                              std::ostream& out)
 {
   std::string filenameGurobiLog;
   if (!outputDirectory.empty())
@@ -857,6 +875,8 @@ IntTriple IlpPmhTiSolver::run(const CloneTree& T,
                         filenameGurobiLog,
                         forcedComigrations,
                         disablePolytomyResolution);
+  solver.setCutoff(pCutoff);
+  solver.setWarmStart(warmStart);
   
   return IlpPmhSolver::run(solver,
                            T,
@@ -870,12 +890,125 @@ IntTriple IlpPmhTiSolver::run(const CloneTree& T,
                            outputSearchGraph,
                            timeLimit,
                            bounds,
-                           forcedComigrations);
+                           forcedComigrations,
+                           out);
+}
+
+double IlpPmhTiSolver::getCutoff(const IntTriple& res, int nrAnatomicalSites)
+{
+  // The objective is a weighted sum of the migration, comigration and
+  // seeding site number (see IlpPmhTrSolver::initObjective), in which the
+  // seeding site number has the smallest weight. The tie-breaking terms
+  // added by initObjective() sum to less than half of that weight.
+  const double k = nrAnatomicalSites;
+  const double seedingSiteWeight = 1000 * (1. / (k * k)) * (1. / (k + 1));
+  
+  return 1000 * res.first
+       + 1000 * (1. / (k * k)) * res.second.first
+       + seedingSiteWeight * (res.second.second + 0.5);
+}
+
+int IlpPmhTiSolver::computeMigrationNumberLB(const CloneTree& T,
+                                             const FrequencyMatrix& F,
+                                             const std::string& primary,
+                                             bool disablePolytomyResolution)
+{
+  const int m = F.getNrAnatomicalSites();
+  const int k = F.getNrSamples();
+  const int n = F.getNrCharacters();
+  const Digraph& tree = T.tree();
+  
+  DoubleMatrix Fmin(k, DoubleVector(n, 0));
+  DoubleMatrix Fmax(k, DoubleVector(n, 0));
+  
+  computeFmin(T, F, T.root(), Fmin);
+  for (NodeIt v_i(tree); v_i != lemon::INVALID; ++v_i)
+  {
+    const int i = F.characterToIndex(T.label(v_i));
+    for (int p = 0; p < k; ++p)
+    {
+      if (g_tol.less(F.max(p, i), Fmin[p][i]))
+      {
+        return std::numeric_limits<int>::max();
+      }
+    }
+  }
+  computeFmax(T, F, T.root(), Fmin, Fmax);
+  
+  // anatomical site s is present in clone i if u[p][i] > 0 for a sample p
+  // of s, which holds if f[p][i] exceeds the sum of the frequencies of the
+  // children of i
+  IntSetNodeMap presentSites(tree);
+  IntSet allPresentSites;
+  for (NodeIt v_i(tree); v_i != lemon::INVALID; ++v_i)
+  {
+    const int i = F.characterToIndex(T.label(v_i));
+    for (int s = 0; s < m; ++s)
+    {
+      for (int p : F.anatomicalSiteIndexToSampleIndices(s))
+      {
+        double Umin = Fmin[p][i];
+        for (OutArcIt a_ij(tree, v_i); a_ij != lemon::INVALID; ++a_ij)
+        {
+          Node v_j = tree.target(a_ij);
+          Umin -= Fmax[p][F.characterToIndex(T.label(v_j))];
+        }
+        
+        if (g_tol.positive(Umin))
+        {
+          presentSites[v_i].insert(s);
+          allPresentSites.insert(s);
+          break;
+        }
+      }
+    }
+  }
+  
+  const int primaryIndex = F.anatomicalSiteToIndex(primary);
+  if (!disablePolytomyResolution)
+  {
+    // polytomy resolution allows all clones present in an anatomical site
+    // to descend from a single migration
+    return allPresentSites.size() - allPresentSites.count(primaryIndex);
+  }
+  
+  IntVectorNodeMap cost(tree, IntVector(m, 0));
+  computeMigrationCosts(T, T.root(), presentSites, cost);
+  
+  return cost[T.root()][primaryIndex];
+}
+
+void IlpPmhTiSolver::computeMigrationCosts(const CloneTree& T,
+                                           Node v_i,
+                                           const IntSetNodeMap& presentSites,
+                                           IntVectorNodeMap& cost)
+{
+  const Digraph& tree = T.tree();
+  const int m = cost[v_i].size();
+  
+  for (OutArcIt a_ij(tree, v_i); a_ij != lemon::INVALID; ++a_ij)
+  {
+    Node v_j = tree.target(a_ij);
+    computeMigrationCosts(T, v_j, presentSites, cost);
+    
+    const int min_j = *std::min_element(cost[v_j].begin(), cost[v_j].end());
+    for (int s = 0; s < m; ++s)
+    {
+      cost[v_i][s] += std::min(cost[v_j][s], min_j + 1);
+    }
+  }
+  
+  // every present anatomical site other than the label of v_i
+  // corresponds to a migration to a leaf
+  for (int s = 0; s < m; ++s)
+  {
+    cost[v_i][s] += presentSites[v_i].size() - presentSites[v_i].count(s);
+  }
 }
 
-GRBLinExpr IlpPmhTiSolver::initObjective(const IntTriple& bounds)
+MilpLinExpr IlpPmhTiSolver::initObjective(const IntTriple& bounds)
 {
-  GRBLinExpr obj = IlpPmhTrSolver::initObjective(bounds);
+  MilpLinExpr obj = IlpPmhTrSolver::initObjective(bounds);
   
   const int nrAnatomicalSites = _anatomicalSiteToIndex.size();
   const int nrNodes = _indexToNode.size();
@@ -912,8 +1045,7 @@ GRBLinExpr IlpPmhTiSolver::initObjective(const IntTriple& bounds)
     }
   }
   
-  _model.setObjective(obj, GRB_MINIMIZE);
-  _model.update();
+  _model.setObjective(obj, MilpModel::MINIMIZE);
   
   return obj;
 }
@@ -21,7 +21,7 @@ public:
   /// @param F Frequency matrices F- and F+
   /// @param primary Primary tumor
   /// @param pattern Topological constraint
-  /// @param gurobiLogFilename Gurobi logging filename
+  /// @param gurobiLogFilename Solver logging filename
   /// @param forcedComigrations List of ordered pairs of anatomical sites
   /// that must be present
   /// @param disablePolytomyResolution No polytomy resolution
@@ -60,6 +60,9 @@ public:
   /// @param forcedComigrations List of ordered pairs of anatomical sites
   /// that must be present
   /// @param disablePolytomyResolution No polytomy resolution
+  /// @param warmStart Warm start from a heuristic solution
+  /// @param pCutoff Shared objective cutoff (NULL: no cutoff)
+  /// @param out Output stream receiving the results
   static IntTriple run(const CloneTree& T,
                        const FrequencyMatrix& F,
                        const std::string& primary,
@@ -73,7 +76,34 @@ public:
                        int timeLimit,
                        const IntTriple& bounds,
                        const StringPairList& forcedComigrations,
-                       bool disablePolytomyResolution);
+                       bool disablePolytomyResolution,
+                       bool warmStart,
+                       const MilpCutoff* pCutoff,
+                       std::ostream& out);
+  
+  /// Return the objective cutoff that prunes every solution whose weighted
+  /// migration, comigration and seeding site number is larger than that of
+  /// the given solution, while retaining solutions that attain it
+  ///
+  /// @param res Migration, comigration and seeding site number
+  /// @param nrAnatomicalSites Number of anatomical sites
+  static double getCutoff(const IntTriple& res, int nrAnatomicalSites);
+  
+  /// Return a lower bound on the migration number of every solution for the
+  /// given mutation tree, or std::numeric_limits<int>::max() if the
+  /// frequency bounds are inconsistent with the mutation tree. The bound is
+  /// derived from the anatomical sites whose presence in a clone is implied
+  /// by the frequency bounds. Without polytomy resolution, these are labeled
+  /// using Sankoff with the root labeled by the primary tumor.
+  ///
+  /// @param T Mutation tree
+  /// @param F Frequency matrix
+  /// @param primary Primary tumor
+  /// @param disablePolytomyResolution No polytomy resolution
+  static int computeMigrationNumberLB(const CloneTree& T,
+                                      const FrequencyMatrix& F,
+                                      const std::string& primary,
+                                      bool disablePolytomyResolution);
   
   /// Write search graph
   void writeSearchGraphDOT(std::ostream& out) const;
@@ -110,7 +140,7 @@ protected:
   virtual void initSingleSourceSeedingConstraints();
   
   /// Initialize ILP objective function
-  virtual GRBLinExpr initObjective(const IntTriple& bounds);
+  virtual MilpLinExpr initObjective(const IntTriple& bounds);
   
   /// Return underlying tree
   virtual const Digraph& getTree() const
@@ -146,28 +176,20 @@ protected:
   /// Return lca vertex of given leaves of underlying tree
   virtual Node getLCA(const NodeSet& vertices) const
   {
-    return BaseTree::getLCA(_extT, vertices);
+    return _compactExtT.getLCA(vertices);
   }
   
   /// Return parent of given vertex of underlying tree
   virtual Node getParent(Node v) const
   {
     assert(v != _rootExtT);
-    return _extT.source(InArcIt(_extT, v));
+    return _compactExtT.parent(v);
   }
   
   /// Return whether vertex u is an ancestor of vertex v in the underlying tree
   virtual bool isAncestor(Node u, Node v) const
   {
-    while (v != _rootExtT)
-    {
-      if (u == v)
-        return true;
-      else
-        v = _extT.source(InArcIt(_extT, v));
-    }
-    
-    return u == v;
+    return _compactExtT.isAncestor(u, v);
   }
   
   /// Return anatomical sites
@@ -179,16 +201,60 @@ protected:
   /// Process ILP solution
   virtual void processSolution();
   
+  /// Set initial solution given the sub-label index of every vertex index,
+  /// leaves that are not required are absent
+  ///
+  /// @param subLabel Sub-label index of every vertex index
+  /// (-1 for leaves that are not required)
+  virtual void setStart(const IntVector& subLabel);
+  
+  /// Return whether the given leaf must be present in the heuristic
+  /// initial solution, which holds for the anatomical sites attached
+  /// to leaves of the mutation tree
+  ///
+  /// @param v_i Leaf
+  virtual bool isRequiredLeaf(Node v_i) const
+  {
+    return _isAnatomicalSiteNodeExtT[v_i]
+      && getOrgT().isLeaf(_extTtoT[getParent(v_i)]);
+  }
+  
 private:
   /// Compute Fmin
   ///
+  /// @param T Mutation tree
+  /// @param F Frequency matrix
   /// @param v_i Node in mutation tree T
-  void computeFmin(Node v_i);
+  /// @param Fmin Inferred frequency lower bounds
+  static void computeFmin(const CloneTree& T,
+                          const FrequencyMatrix& F,
+                          Node v_i,
+                          DoubleMatrix& Fmin);
   
   /// Compute Fmax
   ///
+  /// @param T Mutation tree
+  /// @param F Frequency matrix
+  /// @param v_i Node in mutation tree T
+  /// @param Fmin Inferred frequency lower bounds
+  /// @param Fmax Inferred frequency upper bounds
+  static void computeFmax(const CloneTree& T,
+                          const FrequencyMatrix& F,
+                          Node v_i,
+                          const DoubleMatrix& Fmin,
+                          DoubleMatrix& Fmax);
+  
+  /// Compute the minimum number of migrations in the subtree rooted at
+  /// the given node, for each anatomical site labeling the node (Sankoff)
+  ///
+  /// @param T Mutation tree
   /// @param v_i Node in mutation tree T
-  void computeFmax(Node v_i);
+  /// @param presentSites Anatomical sites that are present in each clone
+  /// @param cost Minimum number of migrations indexed by site
+  static void computeMigrationCosts(const CloneTree& T,
+                                    Node v_i,
+                                    const IntSetNodeMap& presentSites,
+                                    IntVectorNodeMap& cost);
   
   /// Compute Umax
   void computeUmax();
@@ -214,6 +280,8 @@ private:
   Digraph _extT;
   /// Root of extended mutation tree
   Node _rootExtT;
+  /// Frozen array-based view of extended mutation tree
+  CompactTree _compactExtT;
   StringNodeMap _labelExtT;
   /// Anatomical site label of leaf of extT
   StringNodeMap _leafAnatomicalSiteLabelExtT;
@@ -74,10 +74,10 @@ void IlpPmhTrSolver::processSolution()
 //      int size_L_s = _L[s].size();
 //      for (int c = 0; c < size_L_s; ++c)
 //      {
-//        if (_r[i][s][c].get(GRB_DoubleAttr_X) >= 0.4)
+//        if (_r[i][s][c].getValue() >= 0.4)
 //        {
-//          std::cout << _r[i][s][c].get(GRB_StringAttr_VarName)
-//          << " = " << _r[i][s][c].get(GRB_DoubleAttr_X) << std::endl;
+//          std::cout << _r[i][s][c].getName()
+//          << " = " << _r[i][s][c].getValue() << std::endl;
 //        }
 //      }
 //    }
@@ -91,10 +91,10 @@ void IlpPmhTrSolver::processSolution()
 //      int size_L_s = _L[s].size();
 //      for (int c = 0; c < size_L_s; ++c)
 //      {
-//        if (_x[i][s][c].get(GRB_DoubleAttr_X) >= 0.4)
+//        if (_x[i][s][c].getValue() >= 0.4)
 //        {
-//          std::cout << _x[i][s][c].get(GRB_StringAttr_VarName)
-//          << " = " << _x[i][s][c].get(GRB_DoubleAttr_X) << std::endl;
+//          std::cout << _x[i][s][c].getName()
+//          << " = " << _x[i][s][c].getValue() << std::endl;
 //        }
 //      }
 //    }
@@ -112,10 +112,10 @@ void IlpPmhTrSolver::processSolution()
 //          int size_L_t = _L[t].size();
 //          for (int d = 0; d < size_L_t; ++d)
 //          {
-//            if (_zz[i][s][c][t][d].get(GRB_DoubleAttr_X) >= 0.4)
+//            if (_zz[i][s][c][t][d].getValue() >= 0.4)
 //            {
-//              std::cout << _zz[i][s][c][t][d].get(GRB_StringAttr_VarName)
-//              << " = " << _zz[i][s][c][t][d].get(GRB_DoubleAttr_X) << std::endl;
+//              std::cout << _zz[i][s][c][t][d].getName()
+//              << " = " << _zz[i][s][c][t][d].getValue() << std::endl;
 //            }
 //          }
 //        }
@@ -133,10 +133,10 @@ void IlpPmhTrSolver::processSolution()
   //          int size_L_t = _L[t].size();
   //          for (int d = 0; d < size_L_t; ++d)
   //          {
-  //            if (_zz[i][s][c][t][d].get(GRB_DoubleAttr_X) >= 0.4)
+  //            if (_zz[i][s][c][t][d].getValue() >= 0.4)
   //            {
-  //              std::cout << _zz[i][s][c][t][d].get(GRB_StringAttr_VarName)
-  //              << " = " << _zz[i][s][c][t][d].get(GRB_DoubleAttr_X) << std::endl;
+  //              std::cout << _zz[i][s][c][t][d].getName()
+  //              << " = " << _zz[i][s][c][t][d].getValue() << std::endl;
   //            }
   //          }
   //        }
@@ -159,10 +159,10 @@ void IlpPmhTrSolver::processSolution()
 //      {
 //        for (int e = 0; e < size_L_t; ++e)
 //        {
-//          if (_w[s][t][d][e].get(GRB_DoubleAttr_X) >= 0.4)
+//          if (_w[s][t][d][e].getValue() >= 0.4)
 //          {
-//            std::cout << _w[s][t][d][e].get(GRB_StringAttr_VarName)
-//            << " = " << _w[s][t][d][e].get(GRB_DoubleAttr_X) << std::endl;
+//            std::cout << _w[s][t][d][e].getName()
+//            << " = " << _w[s][t][d][e].getValue() << std::endl;
 //          }
 //        }
 //      }
@@ -177,10 +177,10 @@ void IlpPmhTrSolver::processSolution()
       int size_L_s = _L[s].size();
       for (int c = 0; c < size_L_s; ++c)
       {
-        if (_r[i][s][c].get(GRB_DoubleAttr_X) >= 0.4)
+        if (_r[i][s][c].getValue() >= 0.4)
         {
-//          std::cout << _r[i][s][c].get(GRB_StringAttr_VarName)
-//                    << " = " << _r[i][s][c].get(GRB_DoubleAttr_X) << std::endl;
+//          std::cout << _r[i][s][c].getName()
+//                    << " = " << _r[i][s][c].getValue() << std::endl;
           (*_pNodeToRootState)[v_i] = std::make_pair(s, c);
         }
       }
@@ -195,10 +195,10 @@ void IlpPmhTrSolver::processSolution()
       int size_L_s = _L[s].size();
       for (int c = 0; c < size_L_s; ++c)
       {
-        if (_x[i][s][c].get(GRB_DoubleAttr_X) >= 0.4)
+        if (_x[i][s][c].getValue() >= 0.4)
         {
-//          std::cout << _x[i][s][c].get(GRB_StringAttr_VarName)
-//                    << " = " << _x[i][s][c].get(GRB_DoubleAttr_X) << std::endl;
+//          std::cout << _x[i][s][c].getName()
+//                    << " = " << _x[i][s][c].getValue() << std::endl;
           (*_pNodeToStateSet)[v_i].insert(std::make_pair(s, c));
         }
       }
@@ -219,10 +219,10 @@ void IlpPmhTrSolver::processSolution()
 //          int size_L_t = _L[t].size();
 //          for (int d = 0; d < size_L_t; ++d)
 //          {
-//            if (_xx[ij][s][c][t][d].get(GRB_DoubleAttr_X) >= 0.4)
+//            if (_xx[ij][s][c][t][d].getValue() >= 0.4)
 //            {
-//              std::cout << _xx[ij][s][c][t][d].get(GRB_StringAttr_VarName)
-//              << " = " << _xx[ij][s][c][t][d].get(GRB_DoubleAttr_X) << std::endl;
+//              std::cout << _xx[ij][s][c][t][d].getName()
+//              << " = " << _xx[ij][s][c][t][d].getValue() << std::endl;
 //            }
 //          }
 //        }
@@ -235,6 +235,36 @@ void IlpPmhTrSolver::processSolution()
   refine(leafPresence, toMutLabel);
 }
 
+void IlpPmhTrSolver::setStart(const IntVector& subLabel)
+{
+  IlpPmhSolver::setStart(subLabel);
+  
+  const int nrNodes = _indexToNode.size();
+  const int nrSubLabels = getNrSubLabels();
+  
+  for (int i = 0; i < nrNodes; ++i)
+  {
+    for (int k = 0; k < nrSubLabels; ++k)
+    {
+      const int s = _indexToSubLabel[k].first;
+      const int c = _indexToSubLabel[k].second;
+      _r[i][s][c].setStart(subLabel[i] == k ? 1 : 0);
+    }
+  }
+  
+  for (int e = 0; e < _zz.getNrEntries(); ++e)
+  {
+    MilpVar zz = _zz.var(e);
+    zz.setStart(0);
+  }
+}
+
+void IlpPmhTrSolver::initPresolve()
+{
+  _presolve = false;
+  IlpPmhSolver::initPresolve();
+}
+
 void IlpPmhTrSolver::initVariables()
 {
   IlpPmhSolver::initVariables();
@@ -244,31 +274,34 @@ void IlpPmhTrSolver::initVariables()
   
   char buf[1024];
   
-  _zz = Var5Matrix(nrNodes);
-  for (NodeIt v_i(getTree()); v_i != lemon::INVALID; ++v_i)
+  // only pairs of sub-labels that are not fixed to 0 at v_i are stored
+  const int nrSubLabels = getNrSubLabels();
+  _zz.clear();
+  for (int i = 0; i < nrNodes; ++i)
   {
-    const int i = (*_pNodeToIndex)[v_i];
-    _zz[i] = Var4Matrix(nrAnatomicalSites);
-    for (int s = 0; s < nrAnatomicalSites; ++s)
+    Node v_i = _indexToNode[i];
+    _zz.addRow();
+    for (int k = 0; k < nrSubLabels; ++k)
     {
-      const int size_L_s = _L[s].size();
-      _zz[i][s] = Var3Matrix(size_L_s);
-      for (int c = 0; c < size_L_s; ++c)
+      const int s = _indexToSubLabel[k].first;
+      const int c = _indexToSubLabel[k].second;
+      double lb_k, ub_k;
+      getBoundsX(i, s, c, lb_k, ub_k);
+      if (ub_k == 0) continue;
+      
+      for (int l = 0; l < nrSubLabels; ++l)
       {
-        _zz[i][s][c] = VarMatrix(nrAnatomicalSites);
-        for (int t = 0; t < nrAnatomicalSites; ++t)
-        {
-          const int size_L_t = _L[t].size();
-          _zz[i][s][c][t] = VarArray(size_L_t);
-          for (int d = 0; d < size_L_t; ++d)
-          {
-            snprintf(buf, 1024, "zz;%s;%s;%d;%s;%d",
-                     getLabel(v_i).c_str(),
-                     _indexToAnatomicalSite[s].c_str(), c,
-                     _indexToAnatomicalSite[t].c_str(), d);
-            _zz[i][s][c][t][d] = strlen(buf) > 255 ? _model.addVar(0, 1, 0, GRB_BINARY) :  _model.addVar(0, 1, 0, GRB_BINARY, buf);
-          }
-        }
+        const int t = _indexToSubLabel[l].first;
+        const int d = _indexToSubLabel[l].second;
+        double lb_l, ub_l;
+        getBoundsX(i, t, d, lb_l, ub_l);
+        if (ub_l == 0) continue;
+        
+        snprintf(buf, 1024, "zz;%s;%s;%d;%s;%d",
+                 getLabel(v_i).c_str(),
+                 _indexToAnatomicalSite[s].c_str(), c,
+                 _indexToAnatomicalSite[t].c_str(), d);
+        _zz.add(getSubLabelPairIndex(k, l), addBinaryVar(0, 1, buf));
       }
     }
   }
@@ -285,22 +318,44 @@ void IlpPmhTrSolver::initVariables()
       _r[i][s] = VarArray(size_L_s);
       for (int c = 0; c < size_L_s; ++c)
       {
+        // r[i][s][c] <= x[i][s][c]
+        double lb, ub;
+        getBoundsX(i, s, c, lb, ub);
+        
         snprintf(buf, 1024, "r;%s;%s;%d",
                  getLabel(v_i).c_str(),
                  _indexToAnatomicalSite[s].c_str(), c);
-        _r[i][s][c] = strlen(buf) > 255 ? _model.addVar(0, 1, 0, GRB_BINARY) : _model.addVar(0, 1, 0, GRB_BINARY, buf);
+        _r[i][s][c] = addBinaryVar(0, ub, buf);
       }
     }
   }
   
-  _model.update();
+}
+
+void IlpPmhTrSolver::initConstraintsZZ(int i, MilpLinExpr& sum)
+{
+  const int nrSubLabels = getNrSubLabels();
+  for (int e = _zz.rowBegin(i); e < _zz.rowEnd(i); ++e)
+  {
+    const int kl = _zz.col(e);
+    const IntPair& sc = _indexToSubLabel[kl / nrSubLabels];
+    const IntPair& td = _indexToSubLabel[kl % nrSubLabels];
+    const MilpVar& zz = _zz.var(e);
+    
+    sum += zz;
+    _model.addConstr(zz <= _x[i][sc.first][sc.second]);
+    _model.addConstr(zz <= _x[i][td.first][td.second]);
+  }
 }
 
 void IlpPmhTrSolver::initConstraintsNonEdgesG()
 {
   const int nrAnatomicalSites = _anatomicalSiteToIndex.size();
+  const int nrSubLabels = getNrSubLabels();
   
-  GRBLinExpr sum;
+  // sum[kl] is the sum of xx[ij][s][c][t][d] over all edges (v_i,v_j)
+  // and zz[i][s][c][t][d] over all vertices v_i
+  std::vector<MilpLinExpr> sum(nrSubLabels * nrSubLabels);
   
   for (ArcIt a_ij(getTree()); a_ij != lemon::INVALID; ++a_ij)
   {
@@ -310,25 +365,27 @@ void IlpPmhTrSolver::initConstraintsNonEdgesG()
     const int i = (*_pNodeToIndex)[v_i];
     const int j = (*_pNodeToIndex)[v_j];
     
-    for (int s = 0; s < nrAnatomicalSites; ++s)
+    for (int e = _xx.rowBegin(ij); e < _xx.rowEnd(ij); ++e)
     {
-      const int size_L_s = _L[s].size();
-      for (int c = 0; c < size_L_s; ++c)
-      {
-        for (int t = 0; t < nrAnatomicalSites; ++t)
-        {
-          const int size_L_t = _L[t].size();
-          for (int d = 0; d < size_L_t; ++d)
-          {
-            _model.addConstr(_xx[ij][s][c][t][d] <= _x[i][s][c]);
-            _model.addConstr(_xx[ij][s][c][t][d] <= _r[j][t][d]);
-            _model.addConstr(_xx[ij][s][c][t][d] >= _x[i][s][c] + _r[j][t][d] - 1);
-          }
-        }
-      }
+      const int kl = _xx.col(e);
+      const IntPair& sc = _indexToSubLabel[kl / nrSubLabels];
+      const IntPair& td = _indexToSubLabel[kl % nrSubLabels];
+      const MilpVar& xx = _xx.var(e);
+      const MilpVar& x_isc = _x[i][sc.first][sc.second];
+      const MilpVar& r_jtd = _r[j][td.first][td.second];
+      
+      _model.addConstr(xx <= x_isc);
+      _model.addConstr(xx <= r_jtd);
+      _model.addConstr(xx >= x_isc + r_jtd - 1);
+      sum[kl] += xx;
     }
   }
   
+  for (int e = 0; e < _zz.getNrEntries(); ++e)
+  {
+    sum[_zz.col(e)] += _zz.var(e);
+  }
+  
   for (int s = 0; s < nrAnatomicalSites; ++s)
   {
     const int size_L_s = _L[s].size();
@@ -341,20 +398,9 @@ void IlpPmhTrSolver::initConstraintsNonEdgesG()
         {
           if (s == t && c == d) continue;
           
-          for (ArcIt a_ij(getTree()); a_ij != lemon::INVALID; ++a_ij)
-          {
-            const int ij = (*_pArcToIndex)[a_ij];
-            sum += _xx[ij][s][c][t][d];
-          }
-          
-          for (NodeIt v_i(getTree()); v_i != lemon::INVALID; ++v_i)
-          {
-            const int i = (*_pNodeToIndex)[v_i];
-            sum += _zz[i][s][c][t][d];
-          }
-          
-          _model.addConstr(_z[s][c][t][d] <= sum);
-          sum.clear();
+          const int kl = getSubLabelPairIndex(getSubLabelIndex(s, c),
+                                              getSubLabelIndex(t, d));
+          _model.addConstr(_z[s][c][t][d] <= sum[kl]);
         }
       }
     }
@@ -401,7 +447,6 @@ void IlpPmhTrSolver::initConstraintsNonEdgesG()
 //    while (nextCombinationStates(selectedStates));
 //  }
 
-  _model.update();
 }
 
 bool IlpPmhTrSolver::nextCombinationStates(                                          IntPairVector& states) const
@@ -450,15 +495,18 @@ void IlpPmhTrSolver::initLeafVariables()
       _r[i][s] = VarArray(size_L_s);
       for (int c = 0; c < size_L_s; ++c)
       {
+        // r[i][s][c] <= x[i][s][c]
+        double lb, ub;
+        getBoundsX(i, s, c, lb, ub);
+        
         snprintf(buf, 1024, "r;%s;%s;%d",
                  getLabel(v_i).c_str(),
                  _indexToAnatomicalSite[s].c_str(), c);
-        _r[i][s][c] = strlen(buf) > 255 ? _model.addVar(0, 1, 0, GRB_BINARY) : _model.addVar(0, 1, 0, GRB_BINARY, buf);
+        _r[i][s][c] = addBinaryVar(0, ub, buf);
       }
     }
   }
   
-  _model.update();
 }
 
 void IlpPmhTrSolver::initLeafConstraints()
@@ -466,7 +514,7 @@ void IlpPmhTrSolver::initLeafConstraints()
   IlpPmhSolver::initLeafConstraints();
   
   const int nrAnatomicalSites = _anatomicalSiteToIndex.size();
-  GRBLinExpr sum, sum2;
+  MilpLinExpr sum, sum2;
   
   // one root color
   for (NodeIt v_i(getTree()); v_i != lemon::INVALID; ++v_i)
@@ -496,33 +544,24 @@ void IlpPmhTrSolver::initLeafConstraints()
       for (int c = 0; c < size_L_s; ++c)
       {
         sum2 += _x[i][s][c];
-        for (int t = 0; t < nrAnatomicalSites; ++t)
-        {
-          const int size_L_t = _L[t].size();
-          for (int d = 0; d < size_L_t; ++d)
-          {
-            sum += _zz[i][s][c][t][d];
-            _model.addConstr(_zz[i][s][c][t][d] <= _x[i][s][c]);
-            _model.addConstr(_zz[i][s][c][t][d] <= _x[i][t][d]);
-          }
-        }
       }
     }
+    initConstraintsZZ(i, sum);
     _model.addConstr(sum2 - 1 == sum);
     sum.clear();
     sum2.clear();
   }
   
-  _model.update();
 }
 
 void IlpPmhTrSolver::initConstraintsG()
 {
   IlpPmhSolver::initConstraintsG();
   
-  GRBLinExpr sum, sum2;
+  MilpLinExpr sum, sum2;
   
   const int nrAnatomicalSites = _anatomicalSiteToIndex.size();
+  const int nrSubLabels = getNrSubLabels();
   
   // require _zz[i] to induce a subtree
   for (NodeIt v_i(getTree()); v_i != lemon::INVALID; ++v_i)
@@ -535,92 +574,59 @@ void IlpPmhTrSolver::initConstraintsG()
       for (int c = 0; c < size_L_s; ++c)
       {
         sum2 += _x[i][s][c];
-        for (int t = 0; t < nrAnatomicalSites; ++t)
-        {
-          const int size_L_t = _L[t].size();
-          for (int d = 0; d < size_L_t; ++d)
-          {
-            sum += _zz[i][s][c][t][d];
-            _model.addConstr(_zz[i][s][c][t][d] <= _x[i][s][c]);
-            _model.addConstr(_zz[i][s][c][t][d] <= _x[i][t][d]);
-          }
-        }
       }
     }
+    initConstraintsZZ(i, sum);
     _model.addConstr(sum2 - 1 == sum);
     sum.clear();
     sum2.clear();
   }
   
+  // sumIn[l] is the sum of zz[i][s][c][t][d] over all (s,c)
+  std::vector<MilpLinExpr> sumIn(nrSubLabels);
   for (NodeIt v_i(getTree()); v_i != lemon::INVALID; ++v_i)
   {
     if (isLeaf(v_i)) continue;
     const int i = (*_pNodeToIndex)[v_i];
     
-    for (int t = 0; t < nrAnatomicalSites; ++t)
+    for (int e = _zz.rowBegin(i); e < _zz.rowEnd(i); ++e)
     {
-      const int size_L_t = _L[t].size();
-      for (int d = 0; d < size_L_t; ++d)
-      {
-        for (int s = 0; s < nrAnatomicalSites; ++s)
-        {
-          const int size_L_s = _L[s].size();
-          for (int c = 0; c < size_L_s; ++c)
-          {
-            sum += _zz[i][s][c][t][d];
-          }
-        }
-        _model.addConstr(sum == _x[i][t][d] - _r[i][t][d]);
-        sum.clear();
-      }
+      sumIn[_zz.col(e) % nrSubLabels] += _zz.var(e);
     }
-  }
-  
-  // one arc in G
-  for (ArcIt a_ij(getTree()); a_ij != lemon::INVALID; ++a_ij)
-  {
-    Node v_j = getTree().target(a_ij);
-    if (isLeaf(v_j)) continue;
-    const int ij = (*_pArcToIndex)[a_ij];
-    for (int t = 0; t < nrAnatomicalSites; ++t)
+    
+    for (int l = 0; l < nrSubLabels; ++l)
     {
-      const int size_L_t = _L[t].size();
-      for (int d = 0; d < size_L_t; ++d)
-      {
-        for (int s = 0; s < nrAnatomicalSites; ++s)
-        {
-          const int size_L_s = _L[s].size();
-          for (int c = 0; c < size_L_s; ++c)
-          {
-            sum += _xx[ij][s][c][t][d];
-          }
-        }
-        
-//        _model.addConstr(sum <= 1);
-        sum.clear();
-      }
+      const int t = _indexToSubLabel[l].first;
+      const int d = _indexToSubLabel[l].second;
+      _model.addConstr(sumIn[l] == _x[i][t][d] - _r[i][t][d]);
+      sumIn[l].clear();
     }
   }
   
+  // one arc in G
+//  for (ArcIt a_ij(getTree()); a_ij != lemon::INVALID; ++a_ij)
+//  {
+//    Node v_j = getTree().target(a_ij);
+//    if (isLeaf(v_j)) continue;
+//    const int ij = (*_pArcToIndex)[a_ij];
+//    for (int e = _xx.rowBegin(ij); e < _xx.rowEnd(ij); ++e)
+//    {
+//      sumIn[_xx.col(e) % nrSubLabels] += _xx.var(e);
+//    }
+//    for (int l = 0; l < nrSubLabels; ++l)
+//    {
+//      _model.addConstr(sumIn[l] <= 1);
+//      sumIn[l].clear();
+//    }
+//  }
+  
   // relate _zz to _z
-  for (NodeIt v_i(getTree()); v_i != lemon::INVALID; ++v_i)
+  for (int e = 0; e < _zz.getNrEntries(); ++e)
   {
-    const int i = (*_pNodeToIndex)[v_i];
-    for (int s = 0; s < nrAnatomicalSites; ++s)
-    {
-      const int size_L_s = _L[s].size();
-      for (int c = 0; c < size_L_s; ++c)
-      {
-        for (int t = 0; t < nrAnatomicalSites; ++t)
-        {
-          const int size_L_t = _L[t].size();
-          for (int d = 0; d < size_L_t; ++d)
-          {
-            _model.addConstr(_z[s][c][t][d] >= _zz[i][s][c][t][d]);
-          }
-        }
-      }
-    }
+    const int kl = _zz.col(e);
+    const IntPair& sc = _indexToSubLabel[kl / nrSubLabels];
+    const IntPair& td = _indexToSubLabel[kl % nrSubLabels];
+    _model.addConstr(_z[sc.first][sc.second][td.first][td.second] >= _zz.var(e));
   }
   
   // no incoming edges to (P,0), root of _G
@@ -635,14 +641,13 @@ void IlpPmhTrSolver::initConstraintsG()
   _model.addConstr(sum == 0);
   sum.clear();
   
-  _model.update();
 }
 
 void IlpPmhTrSolver::initConstraints()
 {
   IlpPmhSolver::initConstraints();
   
-  GRBLinExpr sum;
+  MilpLinExpr sum;
   
   const int nrAnatomicalSites = _anatomicalSiteToIndex.size();
   
@@ -690,16 +695,15 @@ void IlpPmhTrSolver::initConstraints()
   }
   _model.addConstr(_r[(*_pNodeToIndex)[getRoot()]][_primaryIndex][0] == 1);
   
-  _model.update();
 }
 
-GRBLinExpr IlpPmhTrSolver::initObjective(const IntTriple& bounds)
+MilpLinExpr IlpPmhTrSolver::initObjective(const IntTriple& bounds)
 {
   const int nrAnatomicalSites = _anatomicalSiteToIndex.size();
 //  const int nrNodes = _indexToNode.size();
   
   // migration number
-  GRBLinExpr migrationNumber;
+  MilpLinExpr migrationNumber;
   for (int s = 0; s < nrAnatomicalSites; ++s)
   {
     const int size_L_s = _L[s].size();
@@ -716,21 +720,14 @@ GRBLinExpr IlpPmhTrSolver::initObjective(const IntTriple& bounds)
   }
 
   // comigration number
-  GRBLinExpr comigrationNumber;
-  for (int s = 0; s < nrAnatomicalSites; ++s)
-  {
-    for (int t = 0; t < nrAnatomicalSites; ++t)
-    {
-      comigrationNumber += _gamma[s][t];
-    }
-  }
+  MilpLinExpr comigrationNumber = getComigrationNumber();
   
   if (bounds.second.first != -1)
   {
     _model.addConstr(comigrationNumber <= bounds.second.first);
   }
   
-  GRBLinExpr obj;
+  MilpLinExpr obj;
   obj += migrationNumber
       + (1. / (nrAnatomicalSites * nrAnatomicalSites)) * comigrationNumber;
   
@@ -757,11 +754,7 @@ GRBLinExpr IlpPmhTrSolver::initObjective(const IntTriple& bounds)
 //    }
 //  }
   
-  GRBLinExpr seedingSiteNumber;
-  for (int s = 0; s < nrAnatomicalSites; ++s)
-  {
-    seedingSiteNumber += _sigma[s];
-  }
+  MilpLinExpr seedingSiteNumber = getSeedingSiteNumber();
   
   if (bounds.second.second != -1)
   {
@@ -776,8 +769,7 @@ GRBLinExpr IlpPmhTrSolver::initObjective(const IntTriple& bounds)
   
   obj = 1000 * obj;
   
-  _model.setObjective(obj, GRB_MINIMIZE);
-  _model.update();
+  _model.setObjective(obj, MilpModel::MINIMIZE);
   
   return obj;
 }
@@ -785,7 +777,7 @@ GRBLinExpr IlpPmhTrSolver::initObjective(const IntTriple& bounds)
 void IlpPmhTrSolver::initVertexLabelingConstraints()
 {
   const int nrAnatomicalSites = _anatomicalSiteToIndex.size();
-  GRBLinExpr sum, sum2;
+  MilpLinExpr sum, sum2;
   
   // Every vertex is labeled by at least one (s,c)
   for (NodeIt v_i(getTree()); v_i != lemon::INVALID; ++v_i)
@@ -827,7 +819,11 @@ IntTriple IlpPmhTrSolver::run(const CloneTree& T,
                               bool outputSearchGraph,
                               int timeLimit,
                               const IntTriple& bounds,
-                              const StringPairList& forcedComigrations)
+                              const StringPairList& forcedComigrations,
+                              bool warmStart,
+                              const SolutionCache* pCache,
+                              bool pareto,
+                              std::ostream& out)
 {
   std::string filenameGurobiLog;
   if (!outputDirectory.empty())
@@ -847,6 +843,25 @@ IntTriple IlpPmhTrSolver::run(const CloneTree& T,
                         pattern,
                         filenameGurobiLog,
                         forcedComigrations);
+  solver.setWarmStart(warmStart);
+  solver.setCache(pCache);
+  
+  if (pareto)
+  {
+    const std::vector<IntTriple> front = IlpPmhSolver::runPareto(solver,
+                                                                 T,
+                                                                 primary,
+                                                                 outputDirectory,
+                                                                 outputPrefix,
+                                                                 colorMap,
+                                                                 pattern,
+                                                                 nrThreads,
+                                                                 timeLimit,
+                                                                 bounds,
+                                                                 forcedComigrations,
+                                                                 out);
+    return front.empty() ? std::make_pair(-1, std::make_pair(-1, -1)) : front.front();
+  }
   
   return IlpPmhSolver::run(solver,
                            T,
@@ -860,7 +875,8 @@ IntTriple IlpPmhTrSolver::run(const CloneTree& T,
                            outputSearchGraph,
                            timeLimit,
                            bounds,
-                           forcedComigrations);
+                           forcedComigrations,
+                           out);
 }
 
 void IlpPmhTrSolver::refine(const BoolNodeMap& leafPresence,
@@ -1122,7 +1138,6 @@ void IlpPmhTrSolver::refine(const BoolNodeMap& leafPresence,
 
 void IlpPmhTrSolver::initCallbacks()
 {
-  _model.getEnv().set(GRB_IntParam_LazyConstraints, 1);
   _pCallback = new IlpPmhPrSolverCycleElimination(_indexToAnatomicalSite, _primaryIndex, _y, _z);
   _model.setCallback(_pCallback);
 }
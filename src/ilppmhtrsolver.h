@@ -10,7 +10,7 @@
 
 #include "utils.h"
 #include "clonetree.h"
-#include <gurobi_c++.h>
+#include "milp/milpmodel.h"
 #include "migrationgraph.h"
 #include "solutiongraph.h"
 #include "ilppmhsolver.h"
@@ -25,7 +25,7 @@ public:
   /// @param T Clone tree
   /// @param primary Primary tumor
   /// @param pattern Topological constraint
-  /// @param gurobiLogFilename Gurobi logging filename
+  /// @param gurobiLogFilename Solver logging filename
   /// @param forcedComigrations List of ordered pairs of anatomical sites
   /// that must be present
   IlpPmhTrSolver(const CloneTree& T,
@@ -51,6 +51,11 @@ public:
   /// @param bounds Upper bounds on mu, gamma and sigma
   /// @param forcedComigrations List of ordered pairs of anatomical sites
   /// that must be present
+  /// @param warmStart Warm start from a heuristic solution
+  /// @param pCache Solution cache (NULL: no cache)
+  /// @param pareto Enumerate all non-dominated (mu, gamma, sigma) triples,
+  /// of which the lexicographically smallest one is returned
+  /// @param out Output stream receiving the results
   static IntTriple run(const CloneTree& T,
                        const std::string& primary,
                        const std::string& outputDirectory,
@@ -62,7 +67,11 @@ public:
                        bool outputSearchGraph,
                        int timeLimit,
                        const IntTriple& bounds,
-                       const StringPairList& forcedComigrations);
+                       const StringPairList& forcedComigrations,
+                       bool warmStart,
+                       const SolutionCache* pCache,
+                       bool pareto,
+                       std::ostream& out);
   
   /// Return refined clone tree of provided solution index
   virtual const CloneTree& T() const
@@ -73,6 +82,10 @@ public:
 protected:
   typedef std::map<std::string, std::string> StringToStringMap;
   
+  /// Initialize the reductions of presolve, which are disabled as they
+  /// assume that the labeling of the clone tree is not refined
+  virtual void initPresolve();
+  
   /// Initialize ILP variables
   virtual void initVariables();
   
@@ -97,15 +110,29 @@ protected:
   /// Initialize ILP constraints regarding non-edges of G
   virtual void initConstraintsNonEdgesG();
   
+  /// Initialize ILP constraints zz[i][s][c][t][d] <= x[i][s][c] and
+  /// zz[i][s][c][t][d] <= x[i][t][d], and add the variables zz[i] to sum
+  ///
+  /// @param i Vertex index
+  /// @param sum Linear expression
+  void initConstraintsZZ(int i, MilpLinExpr& sum);
+  
   /// Intialize ILP M constraints
   virtual void initMultiSourceSeedingConstraints();
   
   /// Initialize ILP objective function
-  virtual GRBLinExpr initObjective(const IntTriple& bounds);
+  virtual MilpLinExpr initObjective(const IntTriple& bounds);
   
   /// Process ILP solution
   virtual void processSolution();
   
+  /// Set initial solution given the sub-label index of every vertex index,
+  /// every vertex is colored by its sub-label only
+  ///
+  /// @param subLabel Sub-label index of every vertex index
+  /// (-1 for leaves that are not required)
+  virtual void setStart(const IntVector& subLabel);
+  
   /// Refine clone tree according to identified _G
   void refine(const BoolNodeMap& leafPresence,
               StringToStringMap& toMutLabel);
@@ -138,8 +165,6 @@ protected:
   /// @param subset Current set of anatomical sites
   bool nextCombinationAnatomicalSites(BoolVector& subset) const;
   
-  typedef std::vector<IntPair> IntPairVector;
-  
   /// Compute next combination of states
   ///
   /// @param states Current combination of states
@@ -152,8 +177,9 @@ protected:
   IntPairNodeMap* _pNodeToRootState;
   /// Refined clone tree
   CloneTree* _pTprime;
-  /// _z[i][s][c][t][d]
-  Var5Matrix _zz;
+  /// _z[i][s][c][t][d], stored in row i and column getSubLabelPairIndex
+  /// of (s,c) and (t,d) for variables that are not fixed to 0
+  MilpSparseVarMatrix _zz;
   /// _r[i][s][c], root color
   Var3Matrix _r;
   /// Callback class
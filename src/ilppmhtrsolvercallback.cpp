@@ -24,9 +24,9 @@ IlpPmhPrSolverCycleElimination::IlpPmhPrSolverCycleElimination(const StringVecto
   , _stateToNodeG()
   , _nodeToState(_G)
   , _sccMap(_G)
-  , _arcLookUp(_G)
-  , _costMap(_G)
-  , _mmc(_subG, _costMap)
+  , _arcToZ()
+  , _pred()
+  , _queue()
 {
   // initialize graph
   const int nrAnatomicalSites = _indexToAnatomicalSite.size();
@@ -49,6 +49,31 @@ IlpPmhPrSolverCycleElimination::IlpPmhPrSolverCycleElimination(const StringVecto
       }
     }
   }
+  
+  // the arcs are fixed, only their filter changes between callbacks
+  for (int s = 0; s < nrAnatomicalSites; ++s)
+  {
+    const int size_L_s = _z[s].size();
+    for (int c = 0; c < size_L_s; ++c)
+    {
+      for (int t = 0; t < nrAnatomicalSites; ++t)
+      {
+        const int size_L_t = _z[t].size();
+        for (int d = 0; d < size_L_t; ++d)
+        {
+          const MilpVar& z_sctd = _z[s][c][t][d];
+          if (z_sctd.isNull() || (s == t && c == d)) continue;
+          
+          Arc a_sctd = _G.addArc(_stateToNodeG[s][c], _stateToNodeG[t][d]);
+          assert(_G.id(a_sctd) == _arcToZ.size());
+          _arcToZ.push_back(z_sctd);
+          _filterArcs[a_sctd] = false;
+        }
+      }
+    }
+  }
+  
+  _pred.assign(_G.maxNodeId() + 1, lemon::INVALID);
 }
 
 void IlpPmhPrSolverCycleElimination::updateG()
@@ -60,72 +85,93 @@ void IlpPmhPrSolverCycleElimination::updateG()
     for (int c = 0; c < size_L_s; ++c)
     {
       Node v_sc = _stateToNodeG[s][c];
-      double sol = getSolution(_y[s][c]);
-      _filterNodes[v_sc] = (sol >= 0.4);
+      _filterNodes[v_sc] = (getSolution(_y[s][c]) >= 0.4);
     }
   }
   
-  lemon::mapFill(_G, _filterArcs, false);
-  for (int s = 0; s < nrAnatomicalSites; ++s)
+  for (ArcIt a(_G); a != lemon::INVALID; ++a)
   {
-    const int size_L_s = _z[s].size();
-    for (int c = 0; c < size_L_s; ++c)
-    {
-      Node v_sc = _stateToNodeG[s][c];
+    _filterArcs[a] = (getSolution(_arcToZ[_G.id(a)]) >= 0.4);
+  }
+}
 
-      for (int t = 0; t < nrAnatomicalSites; ++t)
+bool IlpPmhPrSolverCycleElimination::findCycle(Node v,
+                                               ArcVector& cycle)
+{
+  const int scc = _sccMap[v];
+  
+  // BFS from v in its strongly connected component until v is reached again
+  std::fill(_pred.begin(), _pred.end(), lemon::INVALID);
+  _queue.clear();
+  _queue.push_back(v);
+  for (int head = 0; head < _queue.size(); ++head)
+  {
+    Node u = _queue[head];
+    for (SubOutArcIt a(_subG, u); a != lemon::INVALID; ++a)
+    {
+      Node w = _subG.target(a);
+      if (_sccMap[w] != scc || _pred[_G.id(w)] != lemon::INVALID) continue;
+      
+      _pred[_G.id(w)] = a;
+      if (w == v)
       {
-        const int size_L_t = _z[t].size();
-        for (int d = 0; d < size_L_t; ++d)
+        cycle.clear();
+        for (Arc b = a; ; b = _pred[_G.id(_G.source(b))])
         {
-          Node v_td = _stateToNodeG[t][d];
-          double sol = getSolution(_z[s][c][t][d]);
-          if (sol >= 0.4)
-          {
-            Arc a_sctd = _arcLookUp(v_sc, v_td);
-            if (a_sctd == lemon::INVALID)
-            {
-              a_sctd = _G.addArc(v_sc, v_td);
-              _costMap[a_sctd] = 1;
-            }
-            _filterArcs[a_sctd] = true;
-//            std::cout << "" << _indexToAnatomicalSite[s] << "_" << c <<" -> " << _indexToAnatomicalSite[t] << "_" << d << "" << std::endl;
-          }
+          cycle.push_back(b);
+          if (_G.source(b) == v) break;
         }
+        return true;
       }
+      _queue.push_back(w);
     }
   }
+  
+  return false;
 }
 
 void IlpPmhPrSolverCycleElimination::callback()
 {
-  if (where == GRB_CB_MIPSOL)
+  updateG();
+  
+  const int nrSCCs = lemon::stronglyConnectedComponents(_subG, _sccMap);
+  if (nrSCCs == lemon::countNodes(_subG))
+  {
+    // acyclic
+    return;
+  }
+  
+  IntVector sccSize(nrSCCs, 0);
+  for (SubNodeIt v(_subG); v != lemon::INVALID; ++v)
   {
-    updateG();
+    ++sccSize[_sccMap[v]];
+  }
+  
+  // a shortest cycle through every node of a nontrivial strongly
+  // connected component, each distinct cycle is cut once
+  std::set<IntVector> cuts;
+  ArcVector cycle;
+  for (SubNodeIt v(_subG); v != lemon::INVALID; ++v)
+  {
+    if (sccSize[_sccMap[v]] < 2 || !findCycle(v, cycle)) continue;
     
-    if (_mmc.run())
+    IntVector key;
+    for (Arc a : cycle)
     {
-      GRBLinExpr sum;
-      
-      const lemon::Path<SubDigraph>& cycle = _mmc.cycle();
-      const int n = cycle.length();
-      if (n > 1)
-      {
-        for (int i = 0; i < n; ++i)
-        {
-          Arc a_sctd = cycle.nth(i);
-          Node v_sc = _G.source(a_sctd);
-          Node v_td = _G.target(a_sctd);
-          const IntPair& sc = _nodeToState[v_sc];
-          const IntPair& td = _nodeToState[v_td];
-          
-//          std::cout << "" << _indexToAnatomicalSite[sc.first] << "_" << sc.second <<" -> " << _indexToAnatomicalSite[td.first] << "_" << td.second << "" << "\t";
-          sum += _z[sc.first][sc.second][td.first][td.second];
-        }
-//        std::cout << std::endl;
-      }
-      addLazy(sum <= n - 1);
-      sum.clear();
+      key.push_back(_G.id(a));
+    }
+    std::sort(key.begin(), key.end());
+    if (!cuts.insert(key).second) continue;
+    
+    MilpLinExpr sum;
+    for (Arc a : cycle)
+    {
+//      const IntPair& sc = _nodeToState[_G.source(a)];
+//      const IntPair& td = _nodeToState[_G.target(a)];
+//      std::cout << "" << _indexToAnatomicalSite[sc.first] << "_" << sc.second <<" -> " << _indexToAnatomicalSite[td.first] << "_" << td.second << "" << "\t";
+      sum += _arcToZ[_G.id(a)];
     }
+//    std::cout << std::endl;
+    addLazy(sum <= static_cast<int>(cycle.size()) - 1);
   }
 }
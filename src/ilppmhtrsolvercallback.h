@@ -8,24 +8,23 @@
 #ifndef ILPPMHPRSOLVERCYCLEELIMNATION
 #define ILPPMHPRSOLVERCYCLEELIMNATION
 
-#include "gurobi_c++.h"
+#include "milp/milpmodel.h"
 #include "utils.h"
-#include <lemon/hartmann_orlin_mmc.h>
 
-class IlpPmhPrSolverCycleElimination : public GRBCallback
+class IlpPmhPrSolverCycleElimination : public MilpCallback
 {
 public:
   /// Vector of node sets
   typedef std::vector<NodeSet> NodeSetVector;
-  /// Gurobi variable array
-  typedef std::vector<GRBVar> VarArray;
-  /// Gurobi variable matrix
+  /// Variable array
+  typedef std::vector<MilpVar> VarArray;
+  /// Variable matrix
   typedef std::vector<VarArray> VarMatrix;
-  /// Gurobi variable 3D matrix
+  /// Variable 3D matrix
   typedef std::vector<VarMatrix> Var3Matrix;
-  /// Gurobi variable 4D matrix
+  /// Variable 4D matrix
   typedef std::vector<Var3Matrix> Var4Matrix;
-  /// Gurobi variable 5D matrix
+  /// Variable 5D matrix
   typedef std::vector<Var4Matrix> Var5Matrix;
   /// Node matrix
   typedef std::vector<NodeVector> NodeMatrix;
@@ -39,8 +38,18 @@ public:
 protected:
   void callback();
   
+  /// Update the node and arc filters of the support graph
+  /// to the new solution
   void updateG();
   
+  /// Find a shortest cycle through the given node that is contained in
+  /// its strongly connected component, returns false if there is none
+  ///
+  /// @param v Node
+  /// @param cycle Arcs of the cycle
+  bool findCycle(Node v,
+                 ArcVector& cycle);
+  
 private:
   const StringVector& _indexToAnatomicalSite;
   const int _primaryIndex;
@@ -54,9 +63,13 @@ private:
   NodeMatrix _stateToNodeG;
   IntPairNodeMap _nodeToState;
   IntNodeMap _sccMap;
-  lemon::DynArcLookUp<Digraph> _arcLookUp;
-  IntArcMap _costMap;
-  lemon::HartmannOrlinMmc<SubDigraph, IntArcMap> _mmc;
+  /// Variable z of an arc indexed by arc id, the arcs of all variables
+  /// that are not fixed to 0 are added once upon construction
+  VarArray _arcToZ;
+  /// BFS predecessor arc indexed by node id
+  ArcVector _pred;
+  /// BFS queue
+  NodeVector _queue;
 };
 
 #endif // ILPPMHPRSOLVERCYCLEELIMNATION
@@ -0,0 +1,144 @@
+/*
+ * jobscheduler.cpp
+ *
+ *  Created on: 18-oct-2026
+ *      Author: M. El-Kebir
+ */
+
+#include "jobscheduler.h"
+#include <algorithm>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <sstream>
+#include <thread>
+
+JobScheduler::JobScheduler(int nrWorkers)
+  : _nrWorkers(nrWorkers <= 0 ? getNrCores() : nrWorkers)
+  , _jobs()
+{
+}
+
+void JobScheduler::addJob(const Job& job)
+{
+  _jobs.push_back(job);
+}
+
+int JobScheduler::getNrCores()
+{
+  int nrCores = std::thread::hardware_concurrency();
+  return nrCores > 0 ? nrCores : 1;
+}
+
+int JobScheduler::getNrThreadsPerJob(int nrThreads, int nrWorkers)
+{
+  if (nrWorkers <= 1)
+  {
+    return nrThreads;
+  }
+
+  if (nrThreads <= 0)
+  {
+    nrThreads = getNrCores();
+  }
+
+  return std::max(1, nrThreads / nrWorkers);
+}
+
+void JobScheduler::run(std::ostream& out)
+{
+  JobVector jobs;
+  jobs.swap(_jobs);
+
+  const int nrJobs = jobs.size();
+  const int nrWorkers = std::min(_nrWorkers, nrJobs);
+  if (nrWorkers <= 1)
+  {
+    // no need for buffering, output is written as it is produced
+    for (const Job& job : jobs)
+    {
+      job(out);
+    }
+    return;
+  }
+
+  std::mutex mutex;
+  std::condition_variable jobDone;
+  std::vector<std::string> output(nrJobs);
+  std::vector<bool> done(nrJobs, false);
+  std::exception_ptr error;
+  int nextJob = 0;
+  int nrRunning = 0;
+
+  auto worker = [&]()
+  {
+    while (true)
+    {
+      int i;
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (error || nextJob == nrJobs)
+        {
+          return;
+        }
+        i = nextJob++;
+        ++nrRunning;
+      }
+
+      std::ostringstream jobOut;
+      std::exception_ptr jobError;
+      try
+      {
+        jobs[i](jobOut);
+      }
+      catch (...)
+      {
+        jobError = std::current_exception();
+      }
+
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        output[i] = jobOut.str();
+        done[i] = true;
+        --nrRunning;
+        if (jobError && !error)
+        {
+          error = jobError;
+        }
+      }
+      jobDone.notify_one();
+    }
+  };
+
+  std::vector<std::thread> workers;
+  for (int k = 0; k < nrWorkers; ++k)
+  {
+    workers.push_back(std::thread(worker));
+  }
+
+  // flush completed output in job order
+  for (int i = 0; i < nrJobs; ++i)
+  {
+    std::string jobOutput;
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      jobDone.wait(lock, [&]() { return done[i] || (error && nrRunning == 0); });
+      if (!done[i])
+      {
+        break;
+      }
+      jobOutput.swap(output[i]);
+    }
+    out << jobOutput << std::flush;
+  }
+
+  for (std::thread& thread : workers)
+  {
+    thread.join();
+  }
+
+  if (error)
+  {
+    std::rethrow_exception(error);
+  }
+}
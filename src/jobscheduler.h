@@ -0,0 +1,74 @@
+/*
+ * jobscheduler.h
+ *
+ *  Created on: 18-oct-2026
+ *      Author: M. El-Kebir
+ */
+
+#ifndef JOBSCHEDULER_H
+#define JOBSCHEDULER_H
+
+#include <functional>
+#include <iostream>
+#include <vector>
+
+/// This class implements a bounded pool of worker threads that executes
+/// independent jobs concurrently. Every job writes its output to its own
+/// buffer, and buffers are flushed to the output stream in the order in
+/// which the jobs were added, as soon as all preceding jobs have completed.
+/// The output is thus identical to a serial execution of the jobs.
+///
+/// Jobs must not share mutable state. In particular, LEMON graphs are not
+/// thread-safe even for read-only access, since constructing a node or arc
+/// map registers it with the graph. Jobs must therefore operate on their
+/// own copies of input trees, made prior to run().
+///
+/// \brief Deterministic parallel job scheduler
+class JobScheduler
+{
+public:
+  /// Job, writes its results to the given output stream
+  typedef std::function<void(std::ostream&)> Job;
+
+  /// Constructor
+  ///
+  /// @param nrWorkers Number of concurrent jobs (-1: number of cores)
+  JobScheduler(int nrWorkers);
+
+  /// Add job
+  ///
+  /// @param job Job
+  void addJob(const Job& job);
+
+  /// Execute all added jobs and clear the job list. If a job throws an
+  /// exception, no new jobs are started and the first exception is
+  /// rethrown once the running jobs have completed.
+  ///
+  /// @param out Output stream
+  void run(std::ostream& out);
+
+  /// Return number of concurrent jobs
+  int getNrWorkers() const
+  {
+    return _nrWorkers;
+  }
+
+  /// Return the number of threads available to each job
+  ///
+  /// @param nrThreads Total number of threads (-1: number of cores)
+  /// @param nrWorkers Number of concurrent jobs
+  static int getNrThreadsPerJob(int nrThreads, int nrWorkers);
+
+  /// Return the number of cores
+  static int getNrCores();
+
+private:
+  typedef std::vector<Job> JobVector;
+
+  /// Number of concurrent jobs
+  const int _nrWorkers;
+  /// Jobs
+  JobVector _jobs;
+};
+
+#endif // JOBSCHEDULER_H
@@ -64,28 +64,49 @@ MigrationGraph::MigrationGraph(const CloneTree& T,
   , _nodeToId(_G)
   , _idToNode()
 {
-  StringSet Sigma = T.getAnatomicalSites();
+  IntNodeMap lPlusIndex(T.tree());
+  T.getIndexLabeling(lPlus, lPlusIndex);
+  init(T, lPlusIndex);
+}
+
+MigrationGraph::MigrationGraph(const CloneTree& T,
+                               const IntNodeMap& lPlus)
+  : _G()
+  , _root(lemon::INVALID)
+  , _nodeToId(_G)
+  , _idToNode()
+{
+  init(T, lPlus);
+}
+
+void MigrationGraph::init(const CloneTree& T,
+                          const IntNodeMap& lPlus)
+{
+  const int m = T.getNrAnatomicalSites();
   
-  for (const std::string& s : Sigma)
+  NodeVector indexToNode(m, lemon::INVALID);
+  for (int s = 0; s < m; ++s)
   {
+    const std::string& sStr = T.indexToAnatomicalSite(s);
     Node x = _G.addNode();
-    _nodeToId[x] = s;
-    _idToNode[s] = x;
+    _nodeToId[x] = sStr;
+    _idToNode[sStr] = x;
+    indexToNode[s] = x;
   }
   
-  assert(_idToNode.count(lPlus[T.root()]) == 1);
-  _root = _idToNode[lPlus[T.root()]];
+  assert(0 <= lPlus[T.root()] && lPlus[T.root()] < m);
+  _root = indexToNode[lPlus[T.root()]];
   
   for (ArcIt a(T.tree()); a != lemon::INVALID; ++a)
   {
     Node u = T.tree().source(a);
     Node v = T.tree().target(a);
     
-    assert(_idToNode.count(lPlus[u]) == 1);
-    assert(_idToNode.count(lPlus[v]) == 1);
+    assert(0 <= lPlus[u] && lPlus[u] < m);
+    assert(0 <= lPlus[v] && lPlus[v] < m);
 
-    Node x = _idToNode[lPlus[u]];
-    Node y = _idToNode[lPlus[v]];
+    Node x = indexToNode[lPlus[u]];
+    Node y = indexToNode[lPlus[v]];
     
     if (x != y)
     {
@@ -55,6 +55,14 @@ public:
   MigrationGraph(const CloneTree& T,
                  const StringNodeMap& lPlus);
   
+  /// Construct migration graph given a non-binary clone tree
+  /// and vertex labeling by anatomical site indices of T
+  ///
+  /// @param T Clone tree
+  /// @param lPlus Vertex labeling
+  MigrationGraph(const CloneTree& T,
+                 const IntNodeMap& lPlus);
+  
   /// Return anatomical site label of given node
   const std::string& l(Node x) const
   {
@@ -117,6 +125,14 @@ public:
   int getNrComigrations(const CLONETREE& T,
                         const StringNodeMap& lPlus) const;
   
+  /// Return the number of comigrations in the migration graph
+  ///
+  /// @param T Clone tree
+  /// @param lPlus Vertex labeling by anatomical site indices of T
+  template <class CLONETREE>
+  int getNrComigrations(const CLONETREE& T,
+                        const IntNodeMap& lPlus) const;
+  
   /// Return the migration pattern of the migration graph
   Pattern getPattern() const;
   
@@ -243,6 +259,15 @@ public:
   /// Return whether the migration graph is connected (it should be!)
   bool isConnected() const;
 
+private:
+  /// Initialize migration graph given a clone tree and vertex labeling
+  /// by anatomical site indices of T
+  ///
+  /// @param T Clone tree
+  /// @param lPlus Vertex labeling
+  void init(const CloneTree& T,
+            const IntNodeMap& lPlus);
+  
 private:
   /// Graph
   Digraph _G;
@@ -257,60 +282,86 @@ private:
 template <class CLONETREE>
 inline int MigrationGraph::getNrComigrations(const CLONETREE& T,
                                              const StringNodeMap& lPlus) const
+{
+  IntNodeMap lPlusIndex(T.tree());
+  T.getIndexLabeling(lPlus, lPlusIndex);
+  return getNrComigrations(T, lPlusIndex);
+}
+
+template <class CLONETREE>
+inline int MigrationGraph::getNrComigrations(const CLONETREE& T,
+                                             const IntNodeMap& lPlus) const
 {
   const Digraph& TT = T.tree();
+  const int m = T.getNrAnatomicalSites();
   
-  lemon::DynArcLookUp<Digraph> arcLookUp(_G);
+  // anatomical sites of T are mapped to indices of vertices of _G
+  IntVector site(m, -1);
+  for (int s = 0; s < m; ++s)
+  {
+    StringToNodeMap::const_iterator it = _idToNode.find(T.indexToAnatomicalSite(s));
+    if (it != _idToNode.end())
+    {
+      site[s] = _G.id(it->second);
+    }
+  }
+  const int mm = _G.maxNodeId() + 1;
   
-  ArcSet migrationEdges = T.getMigrationEdges(lPlus);
+  // The comigration number of (s,t) is the maximum number of (s,t)-migration
+  // edges on a path from the root. In a single DFS, count[s*mm+t] is the
+  // number of (s,t)-migration edges on the path from the root to the
+  // current vertex, and maxCount[s*mm+t] is its maximum so far.
+  IntVector count(mm * mm, 0);
+  IntVector maxCount(mm * mm, 0);
   
-  int nrComigrations = 0;
-  for (NodeIt x(_G); x != lemon::INVALID; ++x)
+  // second component denotes whether the subtree has been visited
+  std::vector<std::pair<Node, bool> > stack;
+  stack.push_back(std::make_pair(T.root(), false));
+  while (!stack.empty())
   {
-    const std::string& l_x = l(x);
-    for (NodeIt y(_G); y != lemon::INVALID; ++y)
+    const Node v = stack.back().first;
+    const bool visited = stack.back().second;
+    stack.pop_back();
+    
+    int st = -1;
+    if (v != T.root())
+    {
+      const Node u = TT.source(InArcIt(TT, v));
+      const int s = site[lPlus[u]];
+      const int t = site[lPlus[v]];
+      assert(s != -1 && t != -1);
+      if (s != t)
+      {
+        st = s * mm + t;
+      }
+    }
+    
+    if (visited)
     {
-      const std::string& l_y = l(y);
-      if (arcLookUp(x, y) != lemon::INVALID)
+      if (st != -1)
       {
-        // 1. collect all migration edges between (x,y)
-        //        ++nrComigrations;
-        
-        ArcSet migrationEdges_xy;
-        for (Arc uv : migrationEdges)
-        {
-          Node u = TT.source(uv);
-          Node v = TT.target(uv);
-          
-          if (lPlus[u] == l_x && lPlus[v] == l_y)
-          {
-            migrationEdges_xy.insert(uv);
-          }
-        }
-        
-        // 2. now for each migration edge (u,v) count the number of ancestral migration edges it has
-        int nrAncestralMigrationEdges = 0;
-        for (Arc uv : migrationEdges_xy)
-        {
-          int count = 0;
-          
-          Arc prevArc = uv;
-          while (prevArc != lemon::INVALID)
-          {
-            if (migrationEdges_xy.count(prevArc) == 1)
-            {
-              ++count;
-            }
-            prevArc = InArcIt(TT, TT.source(prevArc));
-          }
-          if (count > nrAncestralMigrationEdges)
-          {
-            nrAncestralMigrationEdges = count;
-          }
-        }
-        nrComigrations += nrAncestralMigrationEdges;
+        --count[st];
       }
     }
+    else
+    {
+      if (st != -1)
+      {
+        maxCount[st] = std::max(maxCount[st], ++count[st]);
+      }
+      
+      stack.push_back(std::make_pair(v, true));
+      for (OutArcIt a(TT, v); a != lemon::INVALID; ++a)
+      {
+        stack.push_back(std::make_pair(TT.target(a), false));
+      }
+    }
+  }
+  
+  int nrComigrations = 0;
+  for (int c : maxCount)
+  {
+    nrComigrations += c;
   }
   
   assert(nrComigrations >= (_idToNode.size() - 1));
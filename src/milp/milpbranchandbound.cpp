@@ -0,0 +1,1030 @@
+/*
+ * milpbranchandbound.cpp
+ *
+ *  Created on: 18-oct-2026
+ *      Author: M. El-Kebir
+ */
+
+#include "milpbranchandbound.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+
+const double MilpBranchAndBound::_bigBound = 1e6;
+const double MilpBranchAndBound::_primalTol = 1e-7;
+const double MilpBranchAndBound::_dualTol = 1e-7;
+const double MilpBranchAndBound::_pivotTol = 1e-7;
+const double MilpBranchAndBound::_intTol = 1e-6;
+const int MilpBranchAndBound::_maxKernelSize = 5000;
+
+MilpBranchAndBound::MilpBranchAndBound(MilpModel& model)
+  : _model(model)
+  , _n(model.getNrVars())
+  , _m(0)
+  , _col(_n)
+  , _row()
+  , _c(_n, 0.)
+  , _lb(_n, 0.)
+  , _ub(_n, 0.)
+  , _rootLb(_n, 0.)
+  , _rootUb(_n, 0.)
+  , _x(_n, 0.)
+  , _d(_n, 0.)
+  , _atUpper(_n, false)
+  , _kernelCol()
+  , _colIndex(_n, -1)
+  , _kernelRow()
+  , _rowIndex()
+  , _Kinv()
+  , _stride(0)
+  , _nrPivotsSinceRefactor(0)
+  , _intVars()
+  , _sign(model._sense == MilpModel::MINIMIZE ? 1 : -1)
+  , _incumbent()
+  , _incumbentObj(MilpModel::INF)
+  , _nrNodes(0)
+  , _nrIterations(0)
+  , _start()
+  , _timeLimitReached(false)
+  , _cutoffReached(false)
+{
+  for (int j = 0; j < _n; ++j)
+  {
+    double lb = std::max(model._lb[j], -_bigBound);
+    double ub = std::min(model._ub[j], _bigBound);
+    if (model._type[j] != MilpVar::CONTINUOUS)
+    {
+      lb = std::ceil(lb - _intTol);
+      ub = std::floor(ub + _intTol);
+      _intVars.push_back(j);
+    }
+    _rootLb[j] = _lb[j] = lb;
+    _rootUb[j] = _ub[j] = ub;
+    _c[j] = _sign * model._obj[j];
+
+    // the initial basis consists of logicals only, so the reduced cost
+    // of a structural equals its cost
+    _d[j] = _c[j];
+    _atUpper[j] = _c[j] < 0;
+    _x[j] = _atUpper[j] ? ub : lb;
+  }
+
+  // the initial basis consists of logicals only, so the kernel is empty
+  _m = model.getNrConstrs();
+  _row = model._rowTerms;
+  for (int i = 0; i < _m; ++i)
+  {
+    double activity = 0;
+    for (const MilpLinExpr::Term& term : _row[i])
+    {
+      _col[term.first].push_back(MilpLinExpr::Term(i, term.second));
+      activity += term.second * _x[term.first];
+    }
+
+    _c.push_back(0);
+    _lb.push_back(model._rowLower[i]);
+    _ub.push_back(model._rowUpper[i]);
+    _x.push_back(activity);
+    _d.push_back(0);
+    _atUpper.push_back(false);
+    _rowIndex.push_back(-1);
+  }
+}
+
+double MilpBranchAndBound::getSharedCutoff() const
+{
+  if (!_model._pCutoff)
+  {
+    return MilpModel::INF;
+  }
+  return _sign * (_model._pCutoff->get() - _model._objConstant);
+}
+
+double MilpBranchAndBound::getCutoff() const
+{
+  const double cutoff = std::min(_incumbentObj, getSharedCutoff());
+  return cutoff - 1e-6 * std::max(1., std::fabs(cutoff));
+}
+
+bool MilpBranchAndBound::timeLimitReached()
+{
+  if (!_timeLimitReached && _model._timeLimit >= 0)
+  {
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - _start;
+    _timeLimitReached = elapsed.count() > _model._timeLimit;
+  }
+  return _timeLimitReached;
+}
+
+void MilpBranchAndBound::addRow(const TermVector& terms,
+                                double lower,
+                                double upper)
+{
+  // the logical of the new row is basic, so the kernel does not change
+  const int i = _m;
+  double activity = 0;
+  for (const MilpLinExpr::Term& term : terms)
+  {
+    _col[term.first].push_back(MilpLinExpr::Term(i, term.second));
+    activity += term.second * _x[term.first];
+  }
+  _row.push_back(terms);
+
+  _c.push_back(0);
+  _lb.push_back(lower);
+  _ub.push_back(upper);
+  _x.push_back(activity);
+  _d.push_back(0);
+  _atUpper.push_back(false);
+  _rowIndex.push_back(-1);
+  ++_m;
+}
+
+void MilpBranchAndBound::placeNonbasic()
+{
+  for (int j = 0; j < _n + _m; ++j)
+  {
+    if (isBasic(j) || _lb[j] == _ub[j]) continue;
+
+    if (!_atUpper[j] && _d[j] < -_dualTol && _ub[j] != MilpModel::INF)
+    {
+      _atUpper[j] = true;
+    }
+    else if (_atUpper[j] && _d[j] > _dualTol && _lb[j] != -MilpModel::INF)
+    {
+      _atUpper[j] = false;
+    }
+    _x[j] = _atUpper[j] ? _ub[j] : _lb[j];
+  }
+}
+
+void MilpBranchAndBound::computePrimal()
+{
+  // B x_B + N x_N = 0
+  DoubleVector w(_m, 0.);
+  for (int j = 0; j < _n + _m; ++j)
+  {
+    if (isBasic(j) || _x[j] == 0) continue;
+
+    if (j < _n)
+    {
+      for (const MilpLinExpr::Term& term : _col[j])
+      {
+        w[term.first] -= term.second * _x[j];
+      }
+    }
+    else
+    {
+      w[j - _n] += _x[j];
+    }
+  }
+
+  ftran(w, _x);
+}
+
+void MilpBranchAndBound::computeDual()
+{
+  // y^T = c_B^T B^-1, where only the kernel contributes as logicals
+  // have zero cost
+  const int k = _kernelCol.size();
+  DoubleVector y(_m, 0.);
+  for (int b = 0; b < k; ++b)
+  {
+    const double c_b = _c[_kernelCol[b]];
+    if (c_b == 0) continue;
+
+    const double* Kinv_b = &_Kinv[b * _stride];
+    for (int a = 0; a < k; ++a)
+    {
+      y[_kernelRow[a]] += c_b * Kinv_b[a];
+    }
+  }
+
+  for (int j = 0; j < _n + _m; ++j)
+  {
+    if (isBasic(j))
+    {
+      _d[j] = 0;
+    }
+    else if (j < _n)
+    {
+      double d = _c[j];
+      for (const MilpLinExpr::Term& term : _col[j])
+      {
+        d -= y[term.first] * term.second;
+      }
+      _d[j] = d;
+    }
+    else
+    {
+      _d[j] = y[j - _n];
+    }
+  }
+}
+
+void MilpBranchAndBound::ftran(const DoubleVector& a, DoubleVector& x) const
+{
+  // kernel rows: K x_S = a_R
+  const int k = _kernelCol.size();
+  DoubleVector xS(k, 0.);
+  for (int r = 0; r < k; ++r)
+  {
+    const double a_r = a[_kernelRow[r]];
+    if (a_r == 0) continue;
+
+    for (int b = 0; b < k; ++b)
+    {
+      xS[b] += _Kinv[b * _stride + r] * a_r;
+    }
+  }
+
+  // remaining rows: A_LS x_S - x_L = a_L
+  DoubleVector activity(_m, 0.);
+  for (int b = 0; b < k; ++b)
+  {
+    const int j = _kernelCol[b];
+    x[j] = xS[b];
+    if (xS[b] == 0) continue;
+
+    for (const MilpLinExpr::Term& term : _col[j])
+    {
+      activity[term.first] += term.second * xS[b];
+    }
+  }
+  for (int i = 0; i < _m; ++i)
+  {
+    if (_rowIndex[i] == -1)
+    {
+      x[_n + i] = activity[i] - a[i];
+    }
+  }
+}
+
+void MilpBranchAndBound::btran(int p, DoubleVector& rho) const
+{
+  // B^-1 = [ K^-1, 0 ; A_LS K^-1, -I ]
+  const int k = _kernelCol.size();
+  rho.assign(_m, 0.);
+  if (p < _n)
+  {
+    const double* Kinv_b = &_Kinv[_colIndex[p] * _stride];
+    for (int a = 0; a < k; ++a)
+    {
+      rho[_kernelRow[a]] = Kinv_b[a];
+    }
+  }
+  else
+  {
+    for (const MilpLinExpr::Term& term : _row[p - _n])
+    {
+      const int b = _colIndex[term.first];
+      if (b == -1) continue;
+
+      const double* Kinv_b = &_Kinv[b * _stride];
+      for (int a = 0; a < k; ++a)
+      {
+        rho[_kernelRow[a]] += term.second * Kinv_b[a];
+      }
+    }
+    rho[p - _n] = -1;
+  }
+}
+
+void MilpBranchAndBound::reserveKernel(int k)
+{
+  if (k <= _stride) return;
+  if (k > _maxKernelSize)
+  {
+    throw MilpException("Model too large for the built-in solver");
+  }
+
+  const int stride = std::min(std::max(k, std::max(2 * _stride, 16)),
+                              _maxKernelSize);
+  DoubleVector Kinv(stride * stride, 0.);
+  for (int b = 0; b < _stride; ++b)
+  {
+    std::copy(_Kinv.begin() + b * _stride,
+              _Kinv.begin() + (b + 1) * _stride,
+              Kinv.begin() + b * stride);
+  }
+  _Kinv.swap(Kinv);
+  _stride = stride;
+}
+
+void MilpBranchAndBound::updateKernel(int p,
+                                      int q,
+                                      const DoubleVector& alpha_q,
+                                      const DoubleVector& rho)
+{
+  const int k = _kernelCol.size();
+  if (q < _n && p >= _n)
+  {
+    // kernel grows by column q and row p - n: bordered inverse
+    const int i = p - _n;
+    reserveKernel(k + 1);
+
+    DoubleVector u(k), v(k);
+    for (int b = 0; b < k; ++b)
+    {
+      u[b] = alpha_q[_kernelCol[b]];
+    }
+    for (int a = 0; a < k; ++a)
+    {
+      v[a] = rho[_kernelRow[a]];
+    }
+    const double s = -alpha_q[p];
+
+    for (int b = 0; b < k; ++b)
+    {
+      double* Kinv_b = &_Kinv[b * _stride];
+      if (u[b] != 0)
+      {
+        const double f = u[b] / s;
+        for (int a = 0; a < k; ++a)
+        {
+          Kinv_b[a] += f * v[a];
+        }
+      }
+      Kinv_b[k] = -u[b] / s;
+    }
+    double* Kinv_k = &_Kinv[k * _stride];
+    for (int a = 0; a < k; ++a)
+    {
+      Kinv_k[a] = -v[a] / s;
+    }
+    Kinv_k[k] = 1 / s;
+
+    _colIndex[q] = k;
+    _kernelCol.push_back(q);
+    _rowIndex[i] = k;
+    _kernelRow.push_back(i);
+  }
+  else if (q < _n)
+  {
+    // column p of the kernel is replaced by column q
+    const int b0 = _colIndex[p];
+    double* Kinv_b0 = &_Kinv[b0 * _stride];
+    const double pivot = alpha_q[p];
+    for (int a = 0; a < k; ++a)
+    {
+      Kinv_b0[a] /= pivot;
+    }
+    for (int b = 0; b < k; ++b)
+    {
+      const double f = alpha_q[_kernelCol[b]];
+      if (b == b0 || f == 0) continue;
+
+      double* Kinv_b = &_Kinv[b * _stride];
+      for (int a = 0; a < k; ++a)
+      {
+        Kinv_b[a] -= f * Kinv_b0[a];
+      }
+    }
+
+    _kernelCol[b0] = q;
+    _colIndex[q] = b0;
+    _colIndex[p] = -1;
+  }
+  else if (p < _n)
+  {
+    // kernel shrinks by column p and row q - n
+    const int j = q - _n;
+    const int a0 = _rowIndex[j];
+    const int b0 = _colIndex[p];
+    const double* Kinv_b0 = &_Kinv[b0 * _stride];
+    const double pivot = Kinv_b0[a0];
+    for (int b = 0; b < k; ++b)
+    {
+      double* Kinv_b = &_Kinv[b * _stride];
+      const double f = Kinv_b[a0] / pivot;
+      if (b == b0 || f == 0) continue;
+
+      for (int a = 0; a < k; ++a)
+      {
+        Kinv_b[a] -= f * Kinv_b0[a];
+      }
+    }
+
+    // move the last kernel column and row into the freed positions
+    const int last = k - 1;
+    if (b0 != last)
+    {
+      std::copy(_Kinv.begin() + last * _stride,
+                _Kinv.begin() + last * _stride + k,
+                _Kinv.begin() + b0 * _stride);
+      _kernelCol[b0] = _kernelCol[last];
+      _colIndex[_kernelCol[b0]] = b0;
+    }
+    if (a0 != last)
+    {
+      for (int b = 0; b < last; ++b)
+      {
+        _Kinv[b * _stride + a0] = _Kinv[b * _stride + last];
+      }
+      _kernelRow[a0] = _kernelRow[last];
+      _rowIndex[_kernelRow[a0]] = a0;
+    }
+    _kernelCol.pop_back();
+    _kernelRow.pop_back();
+    _colIndex[p] = -1;
+    _rowIndex[j] = -1;
+  }
+  else
+  {
+    // row q - n of the kernel is replaced by row p - n
+    const int i = p - _n;
+    const int j = q - _n;
+    const int a0 = _rowIndex[j];
+
+    DoubleVector z(k);
+    for (int a = 0; a < k; ++a)
+    {
+      z[a] = rho[_kernelRow[a]];
+    }
+    const double pivot = z[a0];
+    for (int b = 0; b < k; ++b)
+    {
+      double* Kinv_b = &_Kinv[b * _stride];
+      const double f = Kinv_b[a0] / pivot;
+      if (f == 0) continue;
+
+      for (int a = 0; a < k; ++a)
+      {
+        Kinv_b[a] -= f * z[a];
+      }
+      Kinv_b[a0] = f;
+    }
+
+    _kernelRow[a0] = i;
+    _rowIndex[i] = a0;
+    _rowIndex[j] = -1;
+  }
+}
+
+void MilpBranchAndBound::refactor()
+{
+  // Gauss-Jordan elimination on [K | I], exploiting sparsity of the
+  // pivot rows
+  const int k = _kernelCol.size();
+  DoubleVector K(k * k, 0.);
+  DoubleVector Kinv(k * k, 0.);
+  for (int b = 0; b < k; ++b)
+  {
+    for (const MilpLinExpr::Term& term : _col[_kernelCol[b]])
+    {
+      const int a = _rowIndex[term.first];
+      if (a != -1)
+      {
+        K[a * k + b] = term.second;
+      }
+    }
+    Kinv[b * k + b] = 1;
+  }
+
+  IntVector nonzerosK, nonzerosKinv;
+  for (int l = 0; l < k; ++l)
+  {
+    int pivotRow = l;
+    for (int i = l + 1; i < k; ++i)
+    {
+      if (std::fabs(K[i * k + l]) > std::fabs(K[pivotRow * k + l]))
+      {
+        pivotRow = i;
+      }
+    }
+    if (std::fabs(K[pivotRow * k + l]) < 1e-11)
+    {
+      throw MilpException("Singular basis");
+    }
+    if (pivotRow != l)
+    {
+      std::swap_ranges(K.begin() + l * k, K.begin() + (l + 1) * k,
+                       K.begin() + pivotRow * k);
+      std::swap_ranges(Kinv.begin() + l * k, Kinv.begin() + (l + 1) * k,
+                       Kinv.begin() + pivotRow * k);
+    }
+
+    const double pivot = K[l * k + l];
+    nonzerosK.clear();
+    nonzerosKinv.clear();
+    for (int c = 0; c < k; ++c)
+    {
+      if (K[l * k + c] != 0)
+      {
+        K[l * k + c] /= pivot;
+        nonzerosK.push_back(c);
+      }
+      if (Kinv[l * k + c] != 0)
+      {
+        Kinv[l * k + c] /= pivot;
+        nonzerosKinv.push_back(c);
+      }
+    }
+
+    for (int i = 0; i < k; ++i)
+    {
+      const double f = K[i * k + l];
+      if (i == l || f == 0) continue;
+
+      for (int c : nonzerosK)
+      {
+        K[i * k + c] -= f * K[l * k + c];
+      }
+      for (int c : nonzerosKinv)
+      {
+        Kinv[i * k + c] -= f * Kinv[l * k + c];
+      }
+    }
+  }
+
+  for (int b = 0; b < k; ++b)
+  {
+    std::copy(Kinv.begin() + b * k, Kinv.begin() + (b + 1) * k,
+              _Kinv.begin() + b * _stride);
+  }
+  _nrPivotsSinceRefactor = 0;
+}
+
+MilpBranchAndBound::LpStatus MilpBranchAndBound::solveLp()
+{
+  const long maxIterations = 100000 + 100 * static_cast<long>(_n + _m);
+
+  DoubleVector rho;
+  DoubleVector alpha;
+  DoubleVector a_q;
+  DoubleVector alpha_q(_n + _m, 0.);
+  IntVector candidates;
+  for (long iteration = 0; ; ++iteration)
+  {
+    if (iteration >= maxIterations)
+    {
+      throw MilpException("Simplex iteration limit reached");
+    }
+    if (iteration % 100 == 99 && timeLimitReached())
+    {
+      return LP_TIME_LIMIT;
+    }
+
+    // keep the kernel inverse, primal and dual values accurate
+    if (_nrPivotsSinceRefactor >= std::max<int>(100, _kernelCol.size()))
+    {
+      refactor();
+    }
+    if (iteration % 50 == 0)
+    {
+      computeDual();
+      placeNonbasic();
+      computePrimal();
+    }
+
+    // leaving variable: basic variable with maximum primal infeasibility
+    int p = -1;
+    double maxInfeasibility = _primalTol;
+    for (int j = 0; j < _n + _m; ++j)
+    {
+      if (!isBasic(j)) continue;
+
+      double infeasibility = 0;
+      if (_x[j] < _lb[j])
+        infeasibility = _lb[j] - _x[j];
+      else if (_x[j] > _ub[j])
+        infeasibility = _x[j] - _ub[j];
+
+      if (infeasibility > maxInfeasibility)
+      {
+        maxInfeasibility = infeasibility;
+        p = j;
+      }
+    }
+    if (p == -1)
+    {
+      return LP_OPTIMAL;
+    }
+
+    const double s = _x[p] < _lb[p] ? 1 : -1;
+
+    // pivot row alpha_p = e_p^T B^-1 N
+    btran(p, rho);
+    alpha.assign(_n + _m, 0.);
+    candidates.clear();
+    double thetaMax = MilpModel::INF;
+    for (int j = 0; j < _n + _m; ++j)
+    {
+      if (isBasic(j)) continue;
+
+      double a = 0;
+      if (j < _n)
+      {
+        for (const MilpLinExpr::Term& term : _col[j])
+        {
+          a += rho[term.first] * term.second;
+        }
+      }
+      else
+      {
+        a = -rho[j - _n];
+      }
+      alpha[j] = a;
+
+      // entering candidates move x_p towards its violated bound
+      if (_lb[j] == _ub[j] || std::fabs(a) < _pivotTol) continue;
+      if (_atUpper[j] ? s * a <= 0 : s * a >= 0) continue;
+
+      candidates.push_back(j);
+      const double d = std::max(_atUpper[j] ? -_d[j] : _d[j], 0.);
+      thetaMax = std::min(thetaMax, (d + _dualTol) / std::fabs(a));
+    }
+
+    // Harris ratio test: largest pivot among the nearly minimal ratios
+    int q = -1;
+    double maxAlpha = 0;
+    for (int j : candidates)
+    {
+      const double d = std::max(_atUpper[j] ? -_d[j] : _d[j], 0.);
+      if (d / std::fabs(alpha[j]) <= thetaMax && std::fabs(alpha[j]) > maxAlpha)
+      {
+        maxAlpha = std::fabs(alpha[j]);
+        q = j;
+      }
+    }
+    if (q == -1)
+    {
+      // dual unbounded
+      return LP_INFEASIBLE;
+    }
+
+    // pivot column alpha_q = B^-1 a_q
+    a_q.assign(_m, 0.);
+    if (q < _n)
+    {
+      for (const MilpLinExpr::Term& term : _col[q])
+      {
+        a_q[term.first] = term.second;
+      }
+    }
+    else
+    {
+      a_q[q - _n] = -1;
+    }
+    alpha_q.resize(_n + _m);
+    ftran(a_q, alpha_q);
+    const double pivot = alpha_q[p];
+    if (std::fabs(pivot) < 1e-11
+        || std::fabs(pivot - alpha[q]) > 1e-5 * (1 + std::fabs(pivot)))
+    {
+      // the pivot row and column disagree, recompute from scratch
+      if (_nrPivotsSinceRefactor == 0)
+      {
+        throw MilpException("Numerically unstable basis");
+      }
+      refactor();
+      computeDual();
+      placeNonbasic();
+      computePrimal();
+      continue;
+    }
+
+    // update reduced costs
+    const double thetaD = _d[q] / alpha[q];
+    for (int j = 0; j < _n + _m; ++j)
+    {
+      if (!isBasic(j))
+      {
+        _d[j] -= thetaD * alpha[j];
+      }
+    }
+    _d[q] = 0;
+    _d[p] = -thetaD;
+
+    // update primal values, x_p leaves at its violated bound
+    const double target = s > 0 ? _lb[p] : _ub[p];
+    const double thetaP = (_x[p] - target) / pivot;
+    for (int j = 0; j < _n + _m; ++j)
+    {
+      if (isBasic(j))
+      {
+        _x[j] -= thetaP * alpha_q[j];
+      }
+    }
+    _x[q] += thetaP;
+    _x[p] = target;
+    _atUpper[p] = s < 0;
+
+    updateKernel(p, q, alpha_q, rho);
+    ++_nrPivotsSinceRefactor;
+    ++_nrIterations;
+  }
+}
+
+double MilpBranchAndBound::lpObjective() const
+{
+  double obj = 0;
+  for (int j = 0; j < _n; ++j)
+  {
+    obj += _c[j] * _x[j];
+  }
+  return obj;
+}
+
+void MilpBranchAndBound::applyBounds(const BoundChangeVector& changes)
+{
+  std::copy(_rootLb.begin(), _rootLb.end(), _lb.begin());
+  std::copy(_rootUb.begin(), _rootUb.end(), _ub.begin());
+  for (const BoundChange& change : changes)
+  {
+    _lb[change._var] = std::max(_lb[change._var], change._lb);
+    _ub[change._var] = std::min(_ub[change._var], change._ub);
+  }
+
+  // nonbasic variables remain at the same side, so the basis stays
+  // dual feasible
+  for (int j = 0; j < _n; ++j)
+  {
+    if (!isBasic(j))
+    {
+      _x[j] = _atUpper[j] ? _ub[j] : _lb[j];
+    }
+  }
+  computePrimal();
+}
+
+bool MilpBranchAndBound::isFeasible(const DoubleVector& x) const
+{
+  const double tol = 1e-6;
+  for (int j = 0; j < _n; ++j)
+  {
+    if (x[j] < _model._lb[j] - tol || x[j] > _model._ub[j] + tol)
+    {
+      return false;
+    }
+  }
+  for (int j : _intVars)
+  {
+    if (std::fabs(x[j] - std::round(x[j])) > tol)
+    {
+      return false;
+    }
+  }
+  for (int i = 0; i < _m; ++i)
+  {
+    double activity = 0;
+    for (const MilpLinExpr::Term& term : _row[i])
+    {
+      activity += term.second * x[term.first];
+    }
+    const double rowTol = tol * (1 + std::fabs(activity));
+    if (activity < _lb[_n + i] - rowTol || activity > _ub[_n + i] + rowTol)
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool MilpBranchAndBound::separate(const DoubleVector& x)
+{
+  if (!_model._pCallback)
+  {
+    return false;
+  }
+
+  Context context(x);
+  _model._pCallback->invoke(context);
+
+  const int m = _m;
+  for (const MilpConstr& constr : context._lazy)
+  {
+    addRow(constr.terms(), constr.lower(), constr.upper());
+  }
+
+  // guard against lazy constraints that do not cut off x
+  return m < _m && !isFeasible(x);
+}
+
+void MilpBranchAndBound::search(const SearchNode& root,
+                                long nodeLimit,
+                                double& bound)
+{
+  SearchNodeVector stack(1, root);
+  long nrNodes = 0;
+
+  bound = MilpModel::INF;
+  while (!stack.empty())
+  {
+    if (timeLimitReached() || (nodeLimit != -1 && nrNodes >= nodeLimit))
+    {
+      break;
+    }
+
+    SearchNode node = stack.back();
+    stack.pop_back();
+
+    const double cutoff = getCutoff();
+    if (node._bound >= cutoff)
+    {
+      _cutoffReached |= node._bound < _incumbentObj;
+      continue;
+    }
+
+    applyBounds(node._changes);
+    bool empty = false;
+    for (const BoundChange& change : node._changes)
+    {
+      empty |= _lb[change._var] > _ub[change._var];
+    }
+    if (empty) continue;
+
+    const LpStatus status = solveLp();
+    ++nrNodes;
+    ++_nrNodes;
+    if (status == LP_TIME_LIMIT)
+    {
+      stack.push_back(node);
+      break;
+    }
+    else if (status == LP_INFEASIBLE)
+    {
+      continue;
+    }
+
+    const double obj = lpObjective();
+    if (obj >= cutoff)
+    {
+      _cutoffReached |= obj < _incumbentObj;
+      continue;
+    }
+
+    // branch on the most fractional integer variable
+    int branchVar = -1;
+    double maxFrac = _intTol;
+    for (int j : _intVars)
+    {
+      const double f = _x[j] - std::floor(_x[j]);
+      if (std::min(f, 1 - f) > maxFrac)
+      {
+        maxFrac = std::min(f, 1 - f);
+        branchVar = j;
+      }
+    }
+
+    if (branchVar == -1)
+    {
+      DoubleVector x(_x.begin(), _x.begin() + _n);
+      for (int j : _intVars)
+      {
+        x[j] = std::round(x[j]);
+      }
+
+      if (separate(x))
+      {
+        // resolve the same node with the lazy constraints
+        node._bound = obj;
+        stack.push_back(node);
+      }
+      else if (isFeasible(x))
+      {
+        double objX = 0;
+        for (int j = 0; j < _n; ++j)
+        {
+          objX += _c[j] * x[j];
+        }
+        if (objX < _incumbentObj)
+        {
+          _incumbent = x;
+          _incumbentObj = objX;
+          if (_model._logToConsole)
+          {
+            std::cout << "Incumbent " << _sign * objX + _model._objConstant
+                      << " found after " << _nrNodes << " nodes" << std::endl;
+          }
+        }
+      }
+      continue;
+    }
+
+    const double value = _x[branchVar];
+
+    SearchNode down = node;
+    BoundChange downChange = { branchVar, -MilpModel::INF, std::floor(value) };
+    down._changes.push_back(downChange);
+    down._bound = obj;
+
+    SearchNode up = node;
+    BoundChange upChange = { branchVar, std::ceil(value), MilpModel::INF };
+    up._changes.push_back(upChange);
+    up._bound = obj;
+
+    // explore the child nearest to the LP solution first
+    if (value - std::floor(value) < 0.5)
+    {
+      stack.push_back(up);
+      stack.push_back(down);
+    }
+    else
+    {
+      stack.push_back(down);
+      stack.push_back(up);
+    }
+  }
+
+  for (const SearchNode& node : stack)
+  {
+    bound = std::min(bound, node._bound);
+  }
+}
+
+void MilpBranchAndBound::processStart()
+{
+  SearchNode node;
+  node._bound = -MilpModel::INF;
+  for (int j : _intVars)
+  {
+    const double start = _model._start[j];
+    if (!std::isnan(start))
+    {
+      BoundChange change = { j, std::round(start), std::round(start) };
+      node._changes.push_back(change);
+    }
+  }
+
+  if (!node._changes.empty())
+  {
+    // complete the initial solution using a short dive
+    double bound;
+    search(node, 100, bound);
+  }
+}
+
+void MilpBranchAndBound::optimize()
+{
+  _start = std::chrono::steady_clock::now();
+  _timeLimitReached = false;
+  _cutoffReached = false;
+
+  bool infeasible = false;
+  for (int j = 0; j < _n; ++j)
+  {
+    infeasible |= _rootLb[j] > _rootUb[j];
+  }
+  for (int i = 0; i < _m; ++i)
+  {
+    infeasible |= _lb[_n + i] > _ub[_n + i];
+  }
+
+  double bound = MilpModel::INF;
+  if (!infeasible)
+  {
+    processStart();
+
+    SearchNode root;
+    root._bound = -MilpModel::INF;
+    search(root, -1, bound);
+  }
+
+  if (!_incumbent.empty())
+  {
+    _model._value = _incumbent;
+    _model._objVal = _sign * _incumbentObj + _model._objConstant;
+  }
+
+  if (_timeLimitReached)
+  {
+    _model._status = MilpModel::TIME_LIMIT;
+    bound = std::min(bound, _incumbentObj);
+  }
+  else if (_cutoffReached && getSharedCutoff() <= _incumbentObj)
+  {
+    // subproblems were pruned by the shared cutoff rather than by the
+    // incumbent, so the incumbent is not necessarily optimal
+    _model._status = MilpModel::CUTOFF;
+    bound = std::min(getSharedCutoff(), _incumbentObj);
+  }
+  else
+  {
+    _model._status = _incumbent.empty() ? MilpModel::INFEASIBLE : MilpModel::OPTIMAL;
+    bound = _incumbentObj;
+  }
+  _model._objBound = _sign * bound + _model._objConstant;
+  _model._nrNodes = _nrNodes;
+
+  char buf[1024];
+  std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - _start;
+  snprintf(buf, 1024,
+           "Explored %ld nodes (%ld simplex iterations) in %.2f seconds\n"
+           "Best objective %g, best bound %g\n",
+           _nrNodes, _nrIterations, elapsed.count(),
+           _model._objVal, _model._objBound);
+
+  if (_model._logToConsole)
+  {
+    std::cout << buf;
+  }
+  if (!_model._logFilename.empty())
+  {
+    std::ofstream log(_model._logFilename.c_str(), std::ios_base::app);
+    log << buf;
+  }
+}
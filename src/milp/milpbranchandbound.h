@@ -0,0 +1,271 @@
+/*
+ * milpbranchandbound.h
+ *
+ *  Created on: 18-oct-2026
+ *      Author: M. El-Kebir
+ */
+
+#ifndef MILPBRANCHANDBOUND_H
+#define MILPBRANCHANDBOUND_H
+
+#include "milpmodel.h"
+#include <chrono>
+
+/// This class implements a self-contained LP-based branch and bound
+/// algorithm for solving a MilpModel.
+///
+/// LP relaxations are solved using a bounded dual simplex algorithm.
+/// Every row has a logical variable, and the basis matrix is represented
+/// by a dense inverse of its kernel: the submatrix of the basic structural
+/// columns restricted to the rows whose logical is nonbasic. The kernel is
+/// typically much smaller than the basis, which makes this adequate for
+/// models with up to a few thousand variables. The search tree is explored
+/// depth-first, reoptimizing from the basis of the previous node after
+/// bound changes. Lazy constraints are added as new rows whenever the
+/// callback rejects an integer feasible solution. Variables without finite
+/// bounds are boxed at +/- _bigBound.
+///
+/// \brief Built-in branch and bound MILP solver
+class MilpBranchAndBound
+{
+public:
+  /// Constructor
+  ///
+  /// @param model Model, receives the solution
+  MilpBranchAndBound(MilpModel& model);
+
+  /// Solve the model
+  void optimize();
+
+private:
+  /// Bound change: variable, lower bound and upper bound
+  struct BoundChange
+  {
+    int _var;
+    double _lb;
+    double _ub;
+  };
+  typedef std::vector<BoundChange> BoundChangeVector;
+
+  /// Search tree node
+  struct SearchNode
+  {
+    /// Bound changes with respect to the root node
+    BoundChangeVector _changes;
+    /// Lower bound on the objective value of the subtree
+    double _bound;
+  };
+  typedef std::vector<SearchNode> SearchNodeVector;
+
+  /// LP status
+  enum LpStatus
+  {
+    LP_OPTIMAL,
+    LP_INFEASIBLE,
+    LP_TIME_LIMIT
+  };
+
+  typedef std::vector<double> DoubleVector;
+  typedef std::vector<int> IntVector;
+  typedef std::vector<MilpLinExpr::Term> TermVector;
+
+  /// This class implements the callback context
+  class Context : public MilpCallback::Context
+  {
+  public:
+    Context(const DoubleVector& x)
+      : _x(x)
+      , _lazy()
+    {
+    }
+
+    double getSolution(int index) const
+    {
+      return _x[index];
+    }
+
+    void addLazy(const MilpConstr& constr)
+    {
+      _lazy.push_back(constr);
+    }
+
+    /// Solution
+    const DoubleVector& _x;
+    /// Lazy constraints
+    std::vector<MilpConstr> _lazy;
+  };
+
+  /// Model
+  MilpModel& _model;
+  /// Number of structural variables
+  const int _n;
+  /// Number of rows
+  int _m;
+  /// Columns of structural variables: (row, coefficient)
+  std::vector<TermVector> _col;
+  /// Rows: (structural variable, coefficient)
+  std::vector<TermVector> _row;
+  /// Cost of every variable (structurals first, followed by logicals)
+  DoubleVector _c;
+  /// Current lower bound of every variable
+  DoubleVector _lb;
+  /// Current upper bound of every variable
+  DoubleVector _ub;
+  /// Root lower bounds of structural variables
+  DoubleVector _rootLb;
+  /// Root upper bounds of structural variables
+  DoubleVector _rootUb;
+  /// Value of every variable
+  DoubleVector _x;
+  /// Reduced cost of every variable
+  DoubleVector _d;
+  /// Indicates whether a nonbasic variable is at its upper bound
+  std::vector<bool> _atUpper;
+  /// Structural variable of each kernel column
+  IntVector _kernelCol;
+  /// Kernel column of each structural variable, -1 if nonbasic
+  IntVector _colIndex;
+  /// Row of each kernel row
+  IntVector _kernelRow;
+  /// Kernel row of each row, -1 if its logical is basic
+  IntVector _rowIndex;
+  /// Dense inverse of the kernel, whose rows correspond to kernel columns
+  /// and whose columns correspond to kernel rows
+  DoubleVector _Kinv;
+  /// Row stride of _Kinv
+  int _stride;
+  /// Number of pivots since last refactorization
+  int _nrPivotsSinceRefactor;
+  /// Structural variables that must be integral
+  IntVector _intVars;
+  /// Objective sign (1: minimize, -1: maximize)
+  double _sign;
+  /// Incumbent solution of the structural variables
+  DoubleVector _incumbent;
+  /// Incumbent objective value (in minimization form)
+  double _incumbentObj;
+  /// Number of explored nodes
+  long _nrNodes;
+  /// Number of simplex iterations
+  long _nrIterations;
+  /// Start time
+  std::chrono::steady_clock::time_point _start;
+  /// Indicates whether the time limit was reached
+  bool _timeLimitReached;
+  /// Indicates whether subproblems were pruned by the shared cutoff
+  bool _cutoffReached;
+
+  /// Bound used for variables without finite bounds
+  static const double _bigBound;
+  /// Primal feasibility tolerance
+  static const double _primalTol;
+  /// Dual feasibility tolerance
+  static const double _dualTol;
+  /// Pivot tolerance
+  static const double _pivotTol;
+  /// Integrality tolerance
+  static const double _intTol;
+  /// Maximum dimension of the kernel
+  static const int _maxKernelSize;
+
+  /// Return whether the time limit is reached
+  bool timeLimitReached();
+
+  /// Return the shared cutoff of the model (in minimization form)
+  double getSharedCutoff() const;
+
+  /// Return the objective value (in minimization form) from which on
+  /// subproblems are pruned, taking into account the incumbent and the
+  /// shared cutoff of the model
+  double getCutoff() const;
+
+  /// Add row
+  ///
+  /// @param terms Terms
+  /// @param lower Lower bound
+  /// @param upper Upper bound
+  void addRow(const TermVector& terms, double lower, double upper);
+
+  /// Move dual infeasible nonbasic variables to their opposite bound
+  void placeNonbasic();
+
+  /// Recompute values of basic variables
+  void computePrimal();
+
+  /// Recompute reduced costs
+  void computeDual();
+
+  /// Return whether the given variable is basic
+  ///
+  /// @param j Variable (structurals first, followed by logicals)
+  bool isBasic(int j) const
+  {
+    return j < _n ? _colIndex[j] != -1 : _rowIndex[j - _n] == -1;
+  }
+
+  /// Solve B x = a, where B is the basis matrix
+  ///
+  /// @param a Dense right hand side indexed by row
+  /// @param x Solution indexed by basic variable
+  void ftran(const DoubleVector& a, DoubleVector& x) const;
+
+  /// Compute row e_p^T B^-1 of the basis inverse
+  ///
+  /// @param p Basic variable
+  /// @param rho Row indexed by row
+  void btran(int p, DoubleVector& rho) const;
+
+  /// Update the kernel after basic variable p is replaced by q
+  ///
+  /// @param p Leaving variable
+  /// @param q Entering variable
+  /// @param alpha_q Column B^-1 a_q indexed by basic variable
+  /// @param rho Row e_p^T B^-1 indexed by row
+  void updateKernel(int p,
+                    int q,
+                    const DoubleVector& alpha_q,
+                    const DoubleVector& rho);
+
+  /// Ensure that the kernel inverse can hold k kernel rows and columns
+  ///
+  /// @param k Kernel size
+  void reserveKernel(int k);
+
+  /// Recompute kernel inverse from scratch
+  void refactor();
+
+  /// Solve the LP relaxation using the dual simplex algorithm
+  LpStatus solveLp();
+
+  /// Return LP objective value (in minimization form)
+  double lpObjective() const;
+
+  /// Apply the bounds of the given search node
+  ///
+  /// @param changes Bound changes with respect to the root node
+  void applyBounds(const BoundChangeVector& changes);
+
+  /// Return whether the structural part of x satisfies all rows,
+  /// bounds and integrality constraints
+  ///
+  /// @param x Values of structural variables
+  bool isFeasible(const DoubleVector& x) const;
+
+  /// Invoke callback on the given integer solution, returns true if
+  /// lazy constraints were added
+  ///
+  /// @param x Values of structural variables
+  bool separate(const DoubleVector& x);
+
+  /// Explore the search tree rooted at the given node
+  ///
+  /// @param root Root node
+  /// @param nodeLimit Maximum number of nodes (-1: no limit)
+  /// @param bound Lower bound on open nodes that were not explored
+  void search(const SearchNode& root, long nodeLimit, double& bound);
+
+  /// Try the initial solution specified by the model
+  void processStart();
+};
+
+#endif // MILPBRANCHANDBOUND_H
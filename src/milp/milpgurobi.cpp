@@ -0,0 +1,268 @@
+/*
+ * milpgurobi.cpp
+ *
+ *  Created on: 18-oct-2026
+ *      Author: M. El-Kebir
+ */
+
+#include "milpgurobi.h"
+#include <gurobi_c++.h>
+#include <cmath>
+
+/// Convert the given bound to Gurobi
+///
+/// @param value Bound
+static double toGurobi(double value)
+{
+  if (value == MilpModel::INF)
+    return GRB_INFINITY;
+  else if (value == -MilpModel::INF)
+    return -GRB_INFINITY;
+  else
+    return value;
+}
+
+/// Convert the given terms to a Gurobi linear expression
+///
+/// @param terms Terms
+/// @param vars Gurobi variables
+static GRBLinExpr toGurobi(const MilpLinExpr::TermVector& terms,
+                           const GRBVar* vars)
+{
+  GRBLinExpr expr;
+  for (const MilpLinExpr::Term& term : terms)
+  {
+    expr.addTerms(&term.second, &vars[term.first], 1);
+  }
+  return expr;
+}
+
+/// This class forwards Gurobi MIPSOL callbacks to a MilpCallback and
+/// aborts the optimization once the bound reaches the shared cutoff
+class MilpGurobiCallback : public GRBCallback, public MilpCallback::Context
+{
+public:
+  MilpGurobiCallback(MilpCallback* pCallback,
+                     const MilpCutoff* pCutoff,
+                     const GRBVar* vars)
+    : _pCallback(pCallback)
+    , _pCutoff(pCutoff)
+    , _vars(vars)
+    , _cutoffReached(false)
+  {
+  }
+
+  double getSolution(int index) const
+  {
+    return const_cast<MilpGurobiCallback*>(this)->GRBCallback::getSolution(_vars[index]);
+  }
+
+  void addLazy(const MilpConstr& constr)
+  {
+    const GRBLinExpr expr = toGurobi(constr.terms(), _vars);
+    if (constr.lower() == constr.upper())
+    {
+      GRBCallback::addLazy(expr, GRB_EQUAL, constr.upper());
+      return;
+    }
+    if (constr.lower() != -MilpModel::INF)
+    {
+      GRBCallback::addLazy(expr, GRB_GREATER_EQUAL, constr.lower());
+    }
+    if (constr.upper() != MilpModel::INF)
+    {
+      GRBCallback::addLazy(expr, GRB_LESS_EQUAL, constr.upper());
+    }
+  }
+
+  bool cutoffReached() const
+  {
+    return _cutoffReached;
+  }
+
+protected:
+  void callback()
+  {
+    if (where == GRB_CB_MIPSOL && _pCallback)
+    {
+      _pCallback->invoke(*this);
+    }
+    else if (where == GRB_CB_MIP && _pCutoff)
+    {
+      if (getDoubleInfo(GRB_CB_MIP_OBJBND) >= _pCutoff->get())
+      {
+        _cutoffReached = true;
+        abort();
+      }
+    }
+  }
+
+private:
+  MilpCallback* _pCallback;
+  const MilpCutoff* _pCutoff;
+  const GRBVar* _vars;
+  bool _cutoffReached;
+};
+
+MilpGurobi::MilpGurobi(MilpModel& model)
+  : _model(model)
+{
+}
+
+void MilpGurobi::optimize()
+{
+  const int nrVars = _model.getNrVars();
+  const int nrConstrs = _model.getNrConstrs();
+
+  GRBVar* vars = NULL;
+  try
+  {
+    GRBEnv env(_model._logFilename);
+    GRBModel model(env);
+
+    std::vector<double> lb(nrVars), ub(nrVars);
+    std::vector<char> type(nrVars);
+    for (int j = 0; j < nrVars; ++j)
+    {
+      lb[j] = toGurobi(_model._lb[j]);
+      ub[j] = toGurobi(_model._ub[j]);
+      switch (_model._type[j])
+      {
+        case MilpVar::CONTINUOUS:
+          type[j] = GRB_CONTINUOUS;
+          break;
+        case MilpVar::BINARY:
+          type[j] = GRB_BINARY;
+          break;
+        case MilpVar::INTEGER:
+          type[j] = GRB_INTEGER;
+          break;
+      }
+    }
+
+    // Gurobi limits names to 255 characters
+    std::vector<std::string> names(_model._name);
+    for (int j = 0; j < nrVars; ++j)
+    {
+      if (names[j].size() > 255)
+      {
+        names[j].clear();
+      }
+    }
+
+    vars = model.addVars(lb.data(), ub.data(), _model._obj.data(),
+                         type.data(), names.data(), nrVars);
+    model.set(GRB_IntAttr_ModelSense, _model._sense == MilpModel::MINIMIZE ? 1 : -1);
+    model.set(GRB_DoubleAttr_ObjCon, _model._objConstant);
+
+    for (int i = 0; i < nrConstrs; ++i)
+    {
+      const GRBLinExpr expr = toGurobi(_model._rowTerms[i], vars);
+      const double lower = _model._rowLower[i];
+      const double upper = _model._rowUpper[i];
+      const std::string name = _model._rowName[i].size() > 255 ? "" : _model._rowName[i];
+      if (lower == upper)
+        model.addConstr(expr, GRB_EQUAL, upper, name);
+      else if (lower == -MilpModel::INF)
+        model.addConstr(expr, GRB_LESS_EQUAL, upper, name);
+      else if (upper == MilpModel::INF)
+        model.addConstr(expr, GRB_GREATER_EQUAL, lower, name);
+      else
+        model.addRange(expr, lower, upper, name);
+    }
+
+    for (int j = 0; j < nrVars; ++j)
+    {
+      if (!std::isnan(_model._start[j]))
+      {
+        vars[j].set(GRB_DoubleAttr_Start, _model._start[j]);
+      }
+    }
+
+    if (_model._nrThreads != -1)
+    {
+      model.getEnv().set(GRB_IntParam_Threads, _model._nrThreads);
+    }
+    if (_model._timeLimit >= 0)
+    {
+      model.getEnv().set(GRB_DoubleParam_TimeLimit, _model._timeLimit);
+    }
+    model.getEnv().set(GRB_IntParam_LogToConsole, _model._logToConsole ? 1 : 0);
+
+    if (_model._pCutoff && _model._pCutoff->get() < MilpModel::INF)
+    {
+      model.getEnv().set(GRB_DoubleParam_Cutoff, _model._pCutoff->get());
+    }
+
+    MilpGurobiCallback* pCallback = NULL;
+    if (_model._pCallback || _model._pCutoff)
+    {
+      pCallback = new MilpGurobiCallback(_model._pCallback, _model._pCutoff, vars);
+      if (_model._pCallback)
+      {
+        model.getEnv().set(GRB_IntParam_LazyConstraints, 1);
+      }
+      model.setCallback(pCallback);
+    }
+
+    try
+    {
+      model.optimize();
+    }
+    catch (const GRBException&)
+    {
+      delete pCallback;
+      throw;
+    }
+    const bool cutoffReached = pCallback && pCallback->cutoffReached();
+    delete pCallback;
+
+    _model._nrNodes = static_cast<long>(model.get(GRB_DoubleAttr_NodeCount));
+
+    switch (model.get(GRB_IntAttr_Status))
+    {
+      case GRB_CUTOFF:
+        _model._status = MilpModel::CUTOFF;
+        break;
+      case GRB_OPTIMAL:
+        _model._status = MilpModel::OPTIMAL;
+        break;
+      case GRB_SUBOPTIMAL:
+        _model._status = MilpModel::SUBOPTIMAL;
+        break;
+      case GRB_INFEASIBLE:
+        _model._status = MilpModel::INFEASIBLE;
+        break;
+      case GRB_INF_OR_UNBD:
+        _model._status = MilpModel::INF_OR_UNBD;
+        break;
+      case GRB_UNBOUNDED:
+        _model._status = MilpModel::UNBOUNDED;
+        break;
+      case GRB_INTERRUPTED:
+        _model._status = cutoffReached ? MilpModel::CUTOFF : MilpModel::TIME_LIMIT;
+        break;
+      default:
+        // time limit or any other limit
+        _model._status = MilpModel::TIME_LIMIT;
+        break;
+    }
+
+    if (model.get(GRB_IntAttr_SolCount) > 0)
+    {
+      double* values = model.get(GRB_DoubleAttr_X, vars, nrVars);
+      _model._value.assign(values, values + nrVars);
+      delete[] values;
+
+      _model._objVal = model.get(GRB_DoubleAttr_ObjVal);
+      _model._objBound = model.get(GRB_DoubleAttr_ObjBound);
+    }
+
+    delete[] vars;
+  }
+  catch (const GRBException& e)
+  {
+    delete[] vars;
+    throw MilpException("Gurobi error: " + e.getMessage());
+  }
+}
@@ -0,0 +1,33 @@
+/*
+ * milpgurobi.h
+ *
+ *  Created on: 18-oct-2026
+ *      Author: M. El-Kebir
+ */
+
+#ifndef MILPGUROBI_H
+#define MILPGUROBI_H
+
+#include "milpmodel.h"
+
+/// This class solves a MilpModel using Gurobi, it is only available
+/// when compiled with HAS_GUROBI
+///
+/// \brief Gurobi backend
+class MilpGurobi
+{
+public:
+  /// Constructor
+  ///
+  /// @param model Model, receives the solution
+  MilpGurobi(MilpModel& model);
+
+  /// Solve the model
+  void optimize();
+
+private:
+  /// Model
+  MilpModel& _model;
+};
+
+#endif // MILPGUROBI_H
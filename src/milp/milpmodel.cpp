@@ -0,0 +1,568 @@
+/*
+ * milpmodel.cpp
+ *
+ *  Created on: 18-oct-2026
+ *      Author: M. El-Kebir
+ */
+
+#include "milpmodel.h"
+#include "milpbranchandbound.h"
+#ifdef HAS_GUROBI
+#include "milpgurobi.h"
+#endif
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <fstream>
+
+const double MilpModel::INF = std::numeric_limits<double>::infinity();
+
+#ifdef HAS_GUROBI
+MilpModel::Backend MilpModel::_defaultBackend = MilpModel::GUROBI;
+#else
+MilpModel::Backend MilpModel::_defaultBackend = MilpModel::BRANCH_AND_BOUND;
+#endif
+
+double MilpVar::getValue() const
+{
+  if (isNull())
+  {
+    return 0;
+  }
+  if (_pModel->_value.empty())
+  {
+    throw MilpException("No solution available");
+  }
+  return _pModel->_value[_index];
+}
+
+void MilpVar::setStart(double value)
+{
+  if (isNull())
+  {
+    assert(value == 0);
+    return;
+  }
+  _pModel->_start[_index] = value;
+}
+
+const std::string& MilpVar::getName() const
+{
+  static const std::string nullName;
+  if (isNull())
+  {
+    return nullName;
+  }
+  return _pModel->_name[_index];
+}
+
+double MilpVar::getLB() const
+{
+  if (isNull())
+  {
+    return 0;
+  }
+  return _pModel->_lb[_index];
+}
+
+double MilpVar::getUB() const
+{
+  if (isNull())
+  {
+    return 0;
+  }
+  return _pModel->_ub[_index];
+}
+
+MilpLinExpr& MilpLinExpr::operator+=(const MilpLinExpr& other)
+{
+  _terms.insert(_terms.end(), other._terms.begin(), other._terms.end());
+  _constant += other._constant;
+  return *this;
+}
+
+MilpLinExpr& MilpLinExpr::operator-=(const MilpLinExpr& other)
+{
+  for (const Term& term : other._terms)
+  {
+    _terms.push_back(Term(term.first, -term.second));
+  }
+  _constant -= other._constant;
+  return *this;
+}
+
+MilpLinExpr& MilpLinExpr::operator*=(double coeff)
+{
+  for (Term& term : _terms)
+  {
+    term.second *= coeff;
+  }
+  _constant *= coeff;
+  return *this;
+}
+
+MilpLinExpr operator+(const MilpLinExpr& a, const MilpLinExpr& b)
+{
+  MilpLinExpr res(a);
+  res += b;
+  return res;
+}
+
+MilpLinExpr operator-(const MilpLinExpr& a, const MilpLinExpr& b)
+{
+  MilpLinExpr res(a);
+  res -= b;
+  return res;
+}
+
+MilpLinExpr operator-(const MilpLinExpr& a)
+{
+  MilpLinExpr res(a);
+  res *= -1;
+  return res;
+}
+
+MilpLinExpr operator*(double coeff, const MilpLinExpr& a)
+{
+  MilpLinExpr res(a);
+  res *= coeff;
+  return res;
+}
+
+MilpLinExpr operator*(const MilpLinExpr& a, double coeff)
+{
+  MilpLinExpr res(a);
+  res *= coeff;
+  return res;
+}
+
+MilpConstr::MilpConstr(const MilpLinExpr& expr, double lower, double upper)
+  : _expr()
+  , _lower(lower - expr.constant())
+  , _upper(upper - expr.constant())
+{
+  // merge terms of the same variable and drop zero coefficients
+  MilpLinExpr::TermVector terms = expr.terms();
+  std::sort(terms.begin(), terms.end());
+
+  for (size_t i = 0; i < terms.size();)
+  {
+    const int index = terms[i].first;
+    double coeff = 0;
+    for (; i < terms.size() && terms[i].first == index; ++i)
+    {
+      coeff += terms[i].second;
+    }
+    if (coeff != 0)
+    {
+      _expr.addTerm(coeff, index);
+    }
+  }
+}
+
+MilpConstr operator<=(const MilpLinExpr& a, const MilpLinExpr& b)
+{
+  return MilpConstr(a - b, -MilpModel::INF, 0);
+}
+
+MilpConstr operator>=(const MilpLinExpr& a, const MilpLinExpr& b)
+{
+  return MilpConstr(a - b, 0, MilpModel::INF);
+}
+
+MilpConstr operator==(const MilpLinExpr& a, const MilpLinExpr& b)
+{
+  return MilpConstr(a - b, 0, 0);
+}
+
+MilpModel::MilpModel(const std::string& logFilename)
+  : _logFilename(logFilename)
+  , _lb()
+  , _ub()
+  , _obj()
+  , _type()
+  , _name()
+  , _start()
+  , _value()
+  , _rowTerms()
+  , _rowLower()
+  , _rowUpper()
+  , _rowName()
+  , _objConstant(0)
+  , _sense(MINIMIZE)
+  , _presolve(false)
+  , _nrRedundantConstrs(0)
+  , _pCallback(NULL)
+  , _pCutoff(NULL)
+  , _nrThreads(-1)
+  , _timeLimit(-1)
+  , _logToConsole(true)
+  , _status(LOADED)
+  , _objVal(INF)
+  , _objBound(-INF)
+  , _nrNodes(0)
+{
+}
+
+MilpVar MilpModel::addVar(double lb,
+                          double ub,
+                          double obj,
+                          MilpVar::Type type,
+                          const std::string& name)
+{
+  const int index = _lb.size();
+
+  if (type == MilpVar::BINARY)
+  {
+    lb = std::max(lb, 0.);
+    ub = std::min(ub, 1.);
+  }
+
+  _lb.push_back(lb);
+  _ub.push_back(ub);
+  _obj.push_back(obj);
+  _type.push_back(type);
+  _start.push_back(std::numeric_limits<double>::quiet_NaN());
+
+  if (name.empty())
+  {
+    char buf[1024];
+    snprintf(buf, 1024, "C%d", index);
+    _name.push_back(buf);
+  }
+  else
+  {
+    _name.push_back(name);
+  }
+
+  return MilpVar(this, index);
+}
+
+void MilpModel::addConstr(const MilpConstr& constr,
+                          const std::string& name)
+{
+  for (const MilpLinExpr::Term& term : constr.terms())
+  {
+    if (term.first < 0 || term.first >= getNrVars())
+    {
+      throw MilpException("Constraint refers to a variable that is not part of the model");
+    }
+  }
+
+  if (constr.terms().empty()
+      && constr.lower() <= 0 && 0 <= constr.upper())
+  {
+    // trivially satisfied, e.g. all variables are null
+    return;
+  }
+
+  if (_presolve)
+  {
+    // activity bounds of the constraint given the variable bounds,
+    // NaN (e.g. infinite bounds of opposite sign) compares false
+    double minActivity = 0;
+    double maxActivity = 0;
+    for (const MilpLinExpr::Term& term : constr.terms())
+    {
+      const double lb = term.second * _lb[term.first];
+      const double ub = term.second * _ub[term.first];
+      minActivity += std::min(lb, ub);
+      maxActivity += std::max(lb, ub);
+    }
+
+    const double eps = 1e-9;
+    if (constr.lower() - eps <= minActivity && maxActivity <= constr.upper() + eps)
+    {
+      ++_nrRedundantConstrs;
+      return;
+    }
+  }
+
+  _rowTerms.push_back(constr.terms());
+  _rowLower.push_back(constr.lower());
+  _rowUpper.push_back(constr.upper());
+
+  if (name.empty())
+  {
+    char buf[1024];
+    snprintf(buf, 1024, "R%d", (int)_rowName.size());
+    _rowName.push_back(buf);
+  }
+  else
+  {
+    _rowName.push_back(name);
+  }
+}
+
+int MilpModel::getNrFixedVars() const
+{
+  int res = 0;
+  for (int i = 0; i < getNrVars(); ++i)
+  {
+    if (_lb[i] == _ub[i])
+    {
+      ++res;
+    }
+  }
+  return res;
+}
+
+void MilpModel::removeConstrs(int first)
+{
+  assert(0 <= first && first <= getNrConstrs());
+
+  _rowTerms.resize(first);
+  _rowLower.resize(first);
+  _rowUpper.resize(first);
+  _rowName.resize(first);
+}
+
+void MilpModel::setStartFromSolution()
+{
+  if (!_value.empty())
+  {
+    _start = _value;
+  }
+}
+
+void MilpModel::setObjective(const MilpLinExpr& obj, Sense sense)
+{
+  std::fill(_obj.begin(), _obj.end(), 0.);
+  for (const MilpLinExpr::Term& term : obj.terms())
+  {
+    assert(0 <= term.first && term.first < getNrVars());
+    _obj[term.first] += term.second;
+  }
+  _objConstant = obj.constant();
+  _sense = sense;
+}
+
+void MilpModel::optimize()
+{
+  _value.clear();
+  _status = LOADED;
+  _objVal = INF;
+  _objBound = -INF;
+  _nrNodes = 0;
+
+  switch (_defaultBackend)
+  {
+    case BRANCH_AND_BOUND:
+      {
+        MilpBranchAndBound solver(*this);
+        solver.optimize();
+      }
+      break;
+    case GUROBI:
+#ifdef HAS_GUROBI
+      {
+        MilpGurobi solver(*this);
+        solver.optimize();
+      }
+      break;
+#else
+      throw MilpException("Gurobi backend is unavailable");
+#endif
+  }
+}
+
+void MilpModel::write(const std::string& filename) const
+{
+  std::ofstream out(filename.c_str());
+  if (!out.good())
+  {
+    throw MilpException("Could not open '" + filename + "' for writing");
+  }
+  write(out);
+}
+
+/// Write linear expression in LP format
+///
+/// @param out Output stream
+/// @param terms Terms
+/// @param names Variable names
+static void writeTerms(std::ostream& out,
+                       const MilpLinExpr::TermVector& terms,
+                       const std::vector<std::string>& names)
+{
+  bool first = true;
+  for (const MilpLinExpr::Term& term : terms)
+  {
+    if (term.second == 0) continue;
+
+    if (term.second < 0)
+      out << " -";
+    else if (!first)
+      out << " +";
+
+    if (std::fabs(term.second) != 1)
+      out << " " << std::fabs(term.second);
+
+    out << " " << names[term.first];
+    first = false;
+  }
+
+  if (first)
+  {
+    out << " 0";
+  }
+}
+
+void MilpModel::write(std::ostream& out) const
+{
+  const int nrVars = getNrVars();
+  const int nrConstrs = getNrConstrs();
+
+  out.precision(12);
+
+  out << (_sense == MINIMIZE ? "Minimize" : "Maximize") << std::endl;
+  MilpLinExpr::TermVector objTerms;
+  for (int j = 0; j < nrVars; ++j)
+  {
+    if (_obj[j] != 0)
+    {
+      objTerms.push_back(MilpLinExpr::Term(j, _obj[j]));
+    }
+  }
+  out << " obj:";
+  writeTerms(out, objTerms, _name);
+  out << std::endl;
+
+  out << "Subject To" << std::endl;
+  for (int i = 0; i < nrConstrs; ++i)
+  {
+    const double lower = _rowLower[i];
+    const double upper = _rowUpper[i];
+    if (lower == upper)
+    {
+      out << " " << _rowName[i] << ":";
+      writeTerms(out, _rowTerms[i], _name);
+      out << " = " << upper << std::endl;
+      continue;
+    }
+
+    // ranged constraints are written as two constraints
+    const bool ranged = lower != -INF && upper != INF;
+    if (lower != -INF)
+    {
+      out << " " << _rowName[i] << (ranged ? "_lo" : "") << ":";
+      writeTerms(out, _rowTerms[i], _name);
+      out << " >= " << lower << std::endl;
+    }
+    if (upper != INF)
+    {
+      out << " " << _rowName[i] << (ranged ? "_up" : "") << ":";
+      writeTerms(out, _rowTerms[i], _name);
+      out << " <= " << upper << std::endl;
+    }
+  }
+
+  out << "Bounds" << std::endl;
+  for (int j = 0; j < nrVars; ++j)
+  {
+    if (_type[j] == MilpVar::BINARY) continue;
+
+    if (_lb[j] == -INF && _ub[j] == INF)
+    {
+      out << " " << _name[j] << " free" << std::endl;
+    }
+    else if (_lb[j] == _ub[j])
+    {
+      out << " " << _name[j] << " = " << _lb[j] << std::endl;
+    }
+    else
+    {
+      out << " ";
+      if (_lb[j] == -INF)
+        out << "-inf";
+      else
+        out << _lb[j];
+      out << " <= " << _name[j] << " <= ";
+      if (_ub[j] == INF)
+        out << "+inf";
+      else
+        out << _ub[j];
+      out << std::endl;
+    }
+  }
+
+  bool first = true;
+  for (int j = 0; j < nrVars; ++j)
+  {
+    if (_type[j] != MilpVar::BINARY) continue;
+    if (first)
+    {
+      out << "Binaries" << std::endl;
+      first = false;
+    }
+    out << " " << _name[j] << std::endl;
+  }
+
+  first = true;
+  for (int j = 0; j < nrVars; ++j)
+  {
+    if (_type[j] != MilpVar::INTEGER) continue;
+    if (first)
+    {
+      out << "Generals" << std::endl;
+      first = false;
+    }
+    out << " " << _name[j] << std::endl;
+  }
+
+  out << "End" << std::endl;
+}
+
+bool MilpModel::isAvailable(Backend backend)
+{
+  switch (backend)
+  {
+    case BRANCH_AND_BOUND:
+      return true;
+    case GUROBI:
+#ifdef HAS_GUROBI
+      return true;
+#else
+      return false;
+#endif
+  }
+  return false;
+}
+
+bool MilpModel::setDefaultBackend(Backend backend)
+{
+  if (!isAvailable(backend))
+  {
+    return false;
+  }
+  _defaultBackend = backend;
+  return true;
+}
+
+bool MilpModel::setDefaultBackend(const std::string& backendStr)
+{
+  if (backendStr == getBackendString(BRANCH_AND_BOUND))
+  {
+    return setDefaultBackend(BRANCH_AND_BOUND);
+  }
+  else if (backendStr == getBackendString(GUROBI))
+  {
+    return setDefaultBackend(GUROBI);
+  }
+  else
+  {
+    return false;
+  }
+}
+
+std::string MilpModel::getBackendString(Backend backend)
+{
+  switch (backend)
+  {
+    case BRANCH_AND_BOUND:
+      return "bb";
+    case GUROBI:
+      return "gurobi";
+  }
+  return "ERROR";
+}
@@ -0,0 +1,709 @@
+/*
+ * milpmodel.h
+ *
+ *  Created on: 18-oct-2026
+ *      Author: M. El-Kebir
+ */
+
+#ifndef MILPMODEL_H
+#define MILPMODEL_H
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <limits>
+#include <stdexcept>
+#include <ostream>
+
+class MilpModel;
+class MilpCallback;
+
+/// This class implements a handle to a variable of a MilpModel. A default
+/// constructed handle is null: it denotes a variable that is fixed to 0 and
+/// therefore not part of the model, and it contributes nothing to expressions.
+///
+/// \brief Variable of a mixed integer linear program
+class MilpVar
+{
+public:
+  /// Variable type
+  enum Type
+  {
+    /// Continuous variable
+    CONTINUOUS,
+    /// Binary variable
+    BINARY,
+    /// Integer variable
+    INTEGER
+  };
+
+  /// Default constructor
+  MilpVar()
+    : _pModel(NULL)
+    , _index(-1)
+  {
+  }
+
+  /// Return index of the variable in its model (-1 if null)
+  int index() const
+  {
+    return _index;
+  }
+
+  /// Return whether the variable is null, i.e. fixed to 0 and not created
+  bool isNull() const
+  {
+    return _pModel == NULL;
+  }
+
+  /// Return the value of the variable in the solution
+  double getValue() const;
+
+  /// Set the value of the variable in the initial solution
+  ///
+  /// @param value Value
+  void setStart(double value);
+
+  /// Return the name of the variable
+  const std::string& getName() const;
+
+  /// Return the lower bound of the variable
+  double getLB() const;
+
+  /// Return the upper bound of the variable
+  double getUB() const;
+
+private:
+  /// Constructor
+  ///
+  /// @param pModel Model
+  /// @param index Index of the variable
+  MilpVar(MilpModel* pModel, int index)
+    : _pModel(pModel)
+    , _index(index)
+  {
+  }
+
+  /// Model
+  MilpModel* _pModel;
+  /// Index of the variable
+  int _index;
+
+  friend class MilpModel;
+};
+
+/// This class implements a linear expression over MilpVar variables
+///
+/// \brief Linear expression
+class MilpLinExpr
+{
+public:
+  /// Term: variable index and coefficient
+  typedef std::pair<int, double> Term;
+  /// Terms
+  typedef std::vector<Term> TermVector;
+
+  /// Constructor
+  ///
+  /// @param constant Constant
+  MilpLinExpr(double constant = 0)
+    : _terms()
+    , _constant(constant)
+  {
+  }
+
+  /// Constructor
+  ///
+  /// @param x Variable
+  MilpLinExpr(const MilpVar& x)
+    : _terms(x.isNull() ? 0 : 1, Term(x.index(), 1))
+    , _constant(0)
+  {
+  }
+
+  /// Return terms, a variable may occur more than once
+  const TermVector& terms() const
+  {
+    return _terms;
+  }
+
+  /// Return constant
+  double constant() const
+  {
+    return _constant;
+  }
+
+  /// Remove all terms and set the constant to zero
+  void clear()
+  {
+    _terms.clear();
+    _constant = 0;
+  }
+
+  /// Add the given term
+  ///
+  /// @param coeff Coefficient
+  /// @param x Variable
+  void addTerm(double coeff, const MilpVar& x)
+  {
+    if (!x.isNull())
+    {
+      _terms.push_back(Term(x.index(), coeff));
+    }
+  }
+
+  /// Add the given term
+  ///
+  /// @param coeff Coefficient
+  /// @param index Variable index
+  void addTerm(double coeff, int index)
+  {
+    _terms.push_back(Term(index, coeff));
+  }
+
+  MilpLinExpr& operator+=(const MilpLinExpr& other);
+
+  MilpLinExpr& operator-=(const MilpLinExpr& other);
+
+  MilpLinExpr& operator*=(double coeff);
+
+private:
+  /// Terms
+  TermVector _terms;
+  /// Constant
+  double _constant;
+};
+
+MilpLinExpr operator+(const MilpLinExpr& a, const MilpLinExpr& b);
+
+MilpLinExpr operator-(const MilpLinExpr& a, const MilpLinExpr& b);
+
+MilpLinExpr operator-(const MilpLinExpr& a);
+
+MilpLinExpr operator*(double coeff, const MilpLinExpr& a);
+
+MilpLinExpr operator*(const MilpLinExpr& a, double coeff);
+
+/// This class implements a linear constraint lower <= expr <= upper,
+/// where expr has no constant
+///
+/// \brief Linear constraint
+class MilpConstr
+{
+public:
+  /// Constructor
+  ///
+  /// @param expr Expression
+  /// @param lower Lower bound
+  /// @param upper Upper bound
+  MilpConstr(const MilpLinExpr& expr, double lower, double upper);
+
+  /// Return terms
+  const MilpLinExpr::TermVector& terms() const
+  {
+    return _expr.terms();
+  }
+
+  /// Return lower bound (-infinity if none)
+  double lower() const
+  {
+    return _lower;
+  }
+
+  /// Return upper bound (infinity if none)
+  double upper() const
+  {
+    return _upper;
+  }
+
+private:
+  /// Expression
+  MilpLinExpr _expr;
+  /// Lower bound
+  double _lower;
+  /// Upper bound
+  double _upper;
+};
+
+MilpConstr operator<=(const MilpLinExpr& a, const MilpLinExpr& b);
+
+MilpConstr operator>=(const MilpLinExpr& a, const MilpLinExpr& b);
+
+MilpConstr operator==(const MilpLinExpr& a, const MilpLinExpr& b);
+
+/// This class implements the exception thrown by MilpModel
+///
+/// \brief MILP exception
+class MilpException : public std::runtime_error
+{
+public:
+  /// Constructor
+  ///
+  /// @param msg Message
+  MilpException(const std::string& msg)
+    : std::runtime_error(msg)
+  {
+  }
+
+  /// Return message
+  std::string getMessage() const
+  {
+    return what();
+  }
+};
+
+/// This class implements the backend independent part of a callback that
+/// is invoked whenever the solver finds a new integer feasible solution
+///
+/// \brief Lazy constraint callback
+class MilpCallback
+{
+public:
+  /// This class provides access to the solver state during a callback
+  class Context
+  {
+  public:
+    /// Destructor
+    virtual ~Context()
+    {
+    }
+
+    /// Return the value of the given variable in the new solution
+    ///
+    /// @param index Variable index
+    virtual double getSolution(int index) const = 0;
+
+    /// Add lazy constraint
+    ///
+    /// @param constr Constraint
+    virtual void addLazy(const MilpConstr& constr) = 0;
+  };
+
+  /// Constructor
+  MilpCallback()
+    : _pContext(NULL)
+    , _nrInvocations(0)
+    , _nrLazyConstrs(0)
+    , _time(0)
+  {
+  }
+
+  /// Destructor
+  virtual ~MilpCallback()
+  {
+  }
+
+  /// Invoke callback in the given context
+  ///
+  /// @param context Context
+  void invoke(Context& context)
+  {
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    _pContext = &context;
+    callback();
+    _pContext = NULL;
+    ++_nrInvocations;
+    _time += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  }
+
+  /// Return the number of times the callback has been invoked
+  long getNrInvocations() const
+  {
+    return _nrInvocations;
+  }
+
+  /// Return the number of lazy constraints added by the callback
+  long getNrLazyConstrs() const
+  {
+    return _nrLazyConstrs;
+  }
+
+  /// Return the time spent in the callback in seconds
+  double getTime() const
+  {
+    return _time;
+  }
+
+protected:
+  /// Callback that is invoked for every new integer feasible solution,
+  /// which may be cut off by adding lazy constraints
+  virtual void callback() = 0;
+
+  /// Return the value of the given variable in the new solution
+  ///
+  /// @param x Variable
+  double getSolution(const MilpVar& x) const
+  {
+    return x.isNull() ? 0 : _pContext->getSolution(x.index());
+  }
+
+  /// Add lazy constraint
+  ///
+  /// @param constr Constraint
+  void addLazy(const MilpConstr& constr)
+  {
+    _pContext->addLazy(constr);
+    ++_nrLazyConstrs;
+  }
+
+private:
+  /// Context
+  Context* _pContext;
+  /// Number of invocations
+  long _nrInvocations;
+  /// Number of lazy constraints
+  long _nrLazyConstrs;
+  /// Time spent in the callback in seconds
+  double _time;
+};
+
+/// This class implements an objective cutoff that can be shared by models
+/// that are solved concurrently. A model is only interested in solutions
+/// whose objective value is strictly better than the cutoff; the cutoff may
+/// be tightened by other threads while the model is being solved, upon
+/// which subproblems that can no longer beat the cutoff are pruned.
+///
+/// \brief Shared objective cutoff
+class MilpCutoff
+{
+public:
+  /// Constructor
+  ///
+  /// @param value Initial cutoff
+  MilpCutoff(double value = std::numeric_limits<double>::infinity())
+    : _value(value)
+  {
+  }
+
+  /// Return the current cutoff
+  double get() const
+  {
+    return _value.load();
+  }
+
+  /// Lower the cutoff to the given value unless it is already lower,
+  /// returns true if the cutoff was lowered
+  ///
+  /// @param value Cutoff
+  bool tighten(double value)
+  {
+    double current = _value.load();
+    while (value < current)
+    {
+      if (_value.compare_exchange_weak(current, value))
+      {
+        return true;
+      }
+    }
+    return false;
+  }
+
+private:
+  /// Cutoff
+  std::atomic<double> _value;
+};
+
+/// This class implements a mixed integer linear program that is solved by
+/// one of several backends: a built-in branch and bound algorithm and,
+/// if available at compile time, Gurobi
+///
+/// \brief Mixed integer linear program
+class MilpModel
+{
+public:
+  /// Backend
+  enum Backend
+  {
+    /// Built-in branch and bound algorithm
+    BRANCH_AND_BOUND,
+    /// Gurobi
+    GUROBI
+  };
+
+  /// Optimization sense
+  enum Sense
+  {
+    /// Minimize
+    MINIMIZE,
+    /// Maximize
+    MAXIMIZE
+  };
+
+  /// Optimization status
+  enum Status
+  {
+    /// Not solved yet
+    LOADED,
+    /// Optimal solution found
+    OPTIMAL,
+    /// Solution found that is optimal within tolerances
+    SUBOPTIMAL,
+    /// Infeasible
+    INFEASIBLE,
+    /// Infeasible or unbounded
+    INF_OR_UNBD,
+    /// Unbounded
+    UNBOUNDED,
+    /// Time limit reached
+    TIME_LIMIT,
+    /// No solution strictly better than the cutoff exists
+    CUTOFF
+  };
+
+  /// Infinity
+  static const double INF;
+
+  /// Constructor
+  ///
+  /// @param logFilename Log filename (empty: no log file)
+  MilpModel(const std::string& logFilename = "");
+
+  /// Add variable
+  ///
+  /// @param lb Lower bound
+  /// @param ub Upper bound
+  /// @param obj Objective coefficient
+  /// @param type Variable type
+  /// @param name Variable name
+  MilpVar addVar(double lb,
+                 double ub,
+                 double obj,
+                 MilpVar::Type type,
+                 const std::string& name = "");
+
+  /// Add constraint. If presolve is enabled, constraints that are
+  /// satisfied by every assignment within the variable bounds are dropped.
+  ///
+  /// @param constr Constraint
+  /// @param name Constraint name
+  void addConstr(const MilpConstr& constr,
+                 const std::string& name = "");
+
+  /// Remove all constraints whose index is at least first, i.e. the
+  /// constraints added after getNrConstrs() returned first
+  ///
+  /// @param first Index of first constraint to remove
+  void removeConstrs(int first);
+
+  /// Use the solution of the last optimization, if any, as initial
+  /// solution of the next optimization
+  void setStartFromSolution();
+
+  /// Set objective
+  ///
+  /// @param obj Objective
+  /// @param sense Optimization sense
+  void setObjective(const MilpLinExpr& obj, Sense sense = MINIMIZE);
+
+  /// Set callback for lazy constraints, the callback is owned by the caller
+  ///
+  /// @param pCallback Callback
+  void setCallback(MilpCallback* pCallback)
+  {
+    _pCallback = pCallback;
+  }
+
+  /// Return callback (NULL if none)
+  MilpCallback* getCallback() const
+  {
+    return _pCallback;
+  }
+
+  /// Set shared objective cutoff of a minimization problem, the cutoff is
+  /// owned by the caller
+  ///
+  /// @param pCutoff Cutoff (NULL: no cutoff)
+  void setCutoff(const MilpCutoff* pCutoff)
+  {
+    _pCutoff = pCutoff;
+  }
+
+  /// Set whether constraints that are redundant given the variable bounds
+  /// are dropped when added
+  ///
+  /// @param presolve Presolve
+  void setPresolve(bool presolve)
+  {
+    _presolve = presolve;
+  }
+
+  /// Set number of threads
+  ///
+  /// @param nrThreads Number of threads (-1: all cores)
+  void setNrThreads(int nrThreads)
+  {
+    _nrThreads = nrThreads;
+  }
+
+  /// Set time limit
+  ///
+  /// @param timeLimit Time limit in seconds (-1: no time limit)
+  void setTimeLimit(double timeLimit)
+  {
+    _timeLimit = timeLimit;
+  }
+
+  /// Set log filename
+  ///
+  /// @param logFilename Log filename (empty: no log file)
+  void setLogFilename(const std::string& logFilename)
+  {
+    _logFilename = logFilename;
+  }
+
+  /// Set whether the solver logs to the console
+  ///
+  /// @param logToConsole Log to console
+  void setLogToConsole(bool logToConsole)
+  {
+    _logToConsole = logToConsole;
+  }
+
+  /// Optimize using the default backend
+  void optimize();
+
+  /// Return optimization status
+  Status getStatus() const
+  {
+    return _status;
+  }
+
+  /// Return objective value of the best solution
+  double getObjVal() const
+  {
+    return _objVal;
+  }
+
+  /// Return lower bound (when minimizing) on the optimal objective value
+  double getObjBound() const
+  {
+    return _objBound;
+  }
+
+  /// Return the number of branch-and-bound nodes explored
+  /// by the last optimization
+  long getNrNodes() const
+  {
+    return _nrNodes;
+  }
+
+  /// Write model in LP format
+  ///
+  /// @param filename Filename
+  void write(const std::string& filename) const;
+
+  /// Write model in LP format
+  ///
+  /// @param out Output stream
+  void write(std::ostream& out) const;
+
+  /// Return number of variables
+  int getNrVars() const
+  {
+    return _lb.size();
+  }
+
+  /// Return number of constraints
+  int getNrConstrs() const
+  {
+    return _rowLower.size();
+  }
+
+  /// Return number of variables whose lower and upper bounds coincide
+  int getNrFixedVars() const;
+
+  /// Return number of constraints that were dropped by presolve
+  int getNrRedundantConstrs() const
+  {
+    return _nrRedundantConstrs;
+  }
+
+  /// Return default backend
+  static Backend getDefaultBackend()
+  {
+    return _defaultBackend;
+  }
+
+  /// Set default backend, returns false if the backend is unavailable
+  ///
+  /// @param backend Backend
+  static bool setDefaultBackend(Backend backend);
+
+  /// Set default backend by name ("bb" or "gurobi"),
+  /// returns false if the backend is unknown or unavailable
+  ///
+  /// @param backendStr Backend name
+  static bool setDefaultBackend(const std::string& backendStr);
+
+  /// Return whether the given backend is available
+  ///
+  /// @param backend Backend
+  static bool isAvailable(Backend backend);
+
+  /// Return name of the given backend
+  ///
+  /// @param backend Backend
+  static std::string getBackendString(Backend backend);
+
+private:
+  /// Log filename
+  std::string _logFilename;
+  /// Variable lower bounds
+  std::vector<double> _lb;
+  /// Variable upper bounds
+  std::vector<double> _ub;
+  /// Objective coefficients
+  std::vector<double> _obj;
+  /// Variable types
+  std::vector<MilpVar::Type> _type;
+  /// Variable names
+  std::vector<std::string> _name;
+  /// Initial solution (NaN: unspecified)
+  std::vector<double> _start;
+  /// Solution
+  std::vector<double> _value;
+  /// Constraint terms
+  std::vector<MilpLinExpr::TermVector> _rowTerms;
+  /// Constraint lower bounds
+  std::vector<double> _rowLower;
+  /// Constraint upper bounds
+  std::vector<double> _rowUpper;
+  /// Constraint names
+  std::vector<std::string> _rowName;
+  /// Objective constant
+  double _objConstant;
+  /// Optimization sense
+  Sense _sense;
+  /// Drop constraints that are redundant given the variable bounds
+  bool _presolve;
+  /// Number of constraints dropped by presolve
+  int _nrRedundantConstrs;
+  /// Callback
+  MilpCallback* _pCallback;
+  /// Shared objective cutoff
+  const MilpCutoff* _pCutoff;
+  /// Number of threads
+  int _nrThreads;
+  /// Time limit
+  double _timeLimit;
+  /// Log to console
+  bool _logToConsole;
+  /// Optimization status
+  Status _status;
+  /// Objective value
+  double _objVal;
+  /// Objective bound
+  double _objBound;
+  /// Number of explored branch-and-bound nodes
+  long _nrNodes;
+
+  /// Default backend
+  static Backend _defaultBackend;
+
+  friend class MilpVar;
+  friend class MilpBranchAndBound;
+  friend class MilpGurobi;
+};
+
+#endif // MILPMODEL_H
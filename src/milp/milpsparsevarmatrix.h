@@ -0,0 +1,114 @@
+/*
+ * milpsparsevarmatrix.h
+ *
+ *  Created on: 18-oct-2026
+ *      Author: M. El-Kebir
+ */
+
+#ifndef MILPSPARSEVARMATRIX_H
+#define MILPSPARSEVARMATRIX_H
+
+#include "milpmodel.h"
+#include <cassert>
+#include <vector>
+
+/// This class implements a sparse matrix of variables in compressed sparse
+/// row format. Rows are appended one at a time and only the entries of
+/// variables that are part of the model are stored; absent entries denote
+/// variables that are fixed to 0.
+///
+/// \brief Sparse matrix of MilpVar variables
+class MilpSparseVarMatrix
+{
+public:
+  /// Constructor
+  MilpSparseVarMatrix()
+    : _rowOffset(1, 0)
+    , _col()
+    , _var()
+  {
+  }
+
+  /// Remove all rows
+  void clear()
+  {
+    _rowOffset.assign(1, 0);
+    _col.clear();
+    _var.clear();
+  }
+
+  /// Append an empty row
+  void addRow()
+  {
+    _rowOffset.push_back(_rowOffset.back());
+  }
+
+  /// Append an entry to the last row
+  ///
+  /// @param col Column
+  /// @param x Variable
+  void add(int col, const MilpVar& x)
+  {
+    assert(getNrRows() > 0);
+    assert(!x.isNull());
+    _col.push_back(col);
+    _var.push_back(x);
+    ++_rowOffset.back();
+  }
+
+  /// Return the number of rows
+  int getNrRows() const
+  {
+    return _rowOffset.size() - 1;
+  }
+
+  /// Return the number of entries
+  int getNrEntries() const
+  {
+    return _col.size();
+  }
+
+  /// Return the first entry of the given row
+  ///
+  /// @param r Row
+  int rowBegin(int r) const
+  {
+    assert(0 <= r && r < getNrRows());
+    return _rowOffset[r];
+  }
+
+  /// Return one past the last entry of the given row
+  ///
+  /// @param r Row
+  int rowEnd(int r) const
+  {
+    assert(0 <= r && r < getNrRows());
+    return _rowOffset[r + 1];
+  }
+
+  /// Return the column of the given entry
+  ///
+  /// @param e Entry
+  int col(int e) const
+  {
+    return _col[e];
+  }
+
+  /// Return the variable of the given entry
+  ///
+  /// @param e Entry
+  const MilpVar& var(int e) const
+  {
+    return _var[e];
+  }
+
+private:
+  /// Entries of row r are _rowOffset[r]..._rowOffset[r+1]-1
+  std::vector<int> _rowOffset;
+  /// Column of entry
+  std::vector<int> _col;
+  /// Variable of entry
+  std::vector<MilpVar> _var;
+};
+
+#endif // MILPSPARSEVARMATRIX_H
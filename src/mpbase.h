@@ -77,7 +77,7 @@ public:
   {
     const int nrCharacters = _T.getNrCharacters();
     
-    int res = 1;
+    unsigned long long res = 1;
     for (int c = 0; c < nrCharacters; ++c)
     {
       assert(_stateVector[c].size() > 0);
@@ -10,11 +10,17 @@
 #include "clonetree.h"
 #include <fstream>
 #include <lemon/arg_parser.h>
+#ifdef HAS_GUROBI
 #include "old_ilps/ilpsolver.h"
+#endif
 #include "ilppmhsolver.h"
+#include "combinatorialpmhsolver.h"
 #include "migrationgraph.h"
 #include <boost/algorithm/string.hpp>
 #include "migrationtree.h"
+#include "jobscheduler.h"
+#include "solutioncache.h"
+#include <memory>
 
 int main(int argc, char** argv)
 {
@@ -30,20 +36,44 @@ int main(int argc, char** argv)
   std::string primary;
   std::string pattern = "0,1,2,3";
   int nrThreads = -1;
+  int nrJobs = 1;
   int timeLimit = -1;
   IntTriple bounds = std::make_pair(-1, std::make_pair(-1, -1));
   std::string migrationTreeFile;
   bool oldMode = false;
+  bool presolve = false;
+  bool warmStart = false;
+  std::string cacheDirectory;
+  bool pareto = false;
+  std::string engine = "ilp";
+  std::string solver = MilpModel::getBackendString(MilpModel::getDefaultBackend());
   
   lemon::ArgParser ap(argc, argv);
   ap.refOption("c", "Color map file", filenameColorMap, true)
     .other("T", "Clone tree")
     .other("leaf_labeling", "Leaf labeling")
     .refOption("g", "Output search graph", outputSearchGraph)
-    .refOption("log", "Gurobi logging", gurobiLog)
+    .refOption("log", "Solver logging", gurobiLog)
     .refOption("t", "Number of threads (default: -1, #cores)", nrThreads)
+    .refOption("j", "Number of concurrent jobs, threads are divided among\n"\
+                    "     jobs (default: 1, -1: #cores)", nrJobs)
     .refOption("o", "Output prefix" , outputDirectory)
     .refOption("OLD", "Use old ILP (typically much slower)", oldMode)
+    .refOption("engine", "Solver engine (default: ilp):\n"\
+                         "       ilp           : integer linear program\n"\
+                         "       combinatorial : branch and bound, supports patterns 0 and 1 only", engine)
+    .refOption("solver", "MILP solver used by the ilp engine (default: " + solver + "):\n"\
+                         "       bb     : built-in branch and bound (slower)\n"\
+                         "       gurobi : Gurobi (if compiled with Gurobi support)", solver)
+    .refOption("presolve", "Reduce the ILP before solving it by fixing variables, contracting\n"\
+                           "     vertices with a single child and ordering sibling leaves\n"\
+                           "     labeled by the same anatomical site", presolve)
+    .refOption("warmStart", "Warm start the ILP from a heuristic solution obtained by\n"\
+                            "     Sankoff labelings with greedily restricted migrations", warmStart)
+    .refOption("cache", "Directory of the on-disk solution cache, optimal solutions are\n"\
+                        "     stored and reported without solving when queried again", cacheDirectory)
+    .refOption("pareto", "Enumerate all non-dominated (mu, gamma, sigma) triples instead of\n"\
+                         "     the lexicographic minimum (no cache)", pareto)
     .refOption("m", "Allowed migration patterns:\n"\
                     "       0 : PS\n"\
                     "       1 : PS, S\n" \
@@ -156,65 +186,81 @@ int main(int argc, char** argv)
     return 1;
   }
   
-  char buf[1024];
-  for (MigrationGraph::Pattern pattern : patterns)
+  const bool combinatorialMode = engine == "combinatorial";
+  if (engine != "ilp" && !combinatorialMode)
   {
-    if (migrationTrees.size() > 0)
+    std::cerr << "Error: unknown engine '" << engine << "'" << std::endl;
+    return 1;
+  }
+  
+  if (!MilpModel::setDefaultBackend(solver))
+  {
+    std::cerr << "Error: unknown or unavailable MILP solver '" << solver << "'" << std::endl;
+    return 1;
+  }
+  
+#ifndef HAS_GUROBI
+  if (oldMode)
+  {
+    std::cerr << "Error: -OLD requires Gurobi" << std::endl;
+    return 1;
+  }
+#endif
+  
+  if (oldMode && pareto)
+  {
+    std::cerr << "Error: -pareto cannot be combined with -OLD" << std::endl;
+    return 1;
+  }
+  
+  if (combinatorialMode)
+  {
+    if (oldMode)
     {
-      int migTreeIdx = 0;
-      for (const StringPairList& migrationTree : migrationTrees)
-      {
-        if (!oldMode)
-        {
-          snprintf(buf, 1024, "%d-%s-", migTreeIdx, primary.c_str());
-          IlpPmhSolver::run(T,
-                            primary,
-                            outputDirectory,
-                            buf,
-                            colorMap,
-                            pattern,
-                            nrThreads,
-                            outputILP,
-                            outputSearchGraph,
-                            timeLimit,
-                            bounds,
-                            migrationTree);
-        }
-        else
-        {
-          IlpSolver::run(T,
-                         primary,
-                         outputDirectory,
-                         colorMap,
-                         pattern,
-                         nrThreads,
-                         outputILP,
-                         outputSearchGraph,
-                         timeLimit,
-                         bounds,
-                         migrationTree);
-        }
-        ++migTreeIdx;
-      }
+      std::cerr << "Error: -OLD cannot be combined with the combinatorial engine" << std::endl;
+      return 1;
     }
-    else
+    
+    if (pareto)
     {
-      if (!oldMode)
+      std::cerr << "Error: -pareto cannot be combined with the combinatorial engine" << std::endl;
+      return 1;
+    }
+    
+    for (MigrationGraph::Pattern pattern : patterns)
+    {
+      if (!CombinatorialPmhSolver::isSupported(pattern))
       {
-        IlpPmhSolver::run(T,
-                          primary,
-                          outputDirectory,
-                          primary + "-",
-                          colorMap,
-                          pattern,
-                          nrThreads,
-                          outputILP,
-                          outputSearchGraph,
-                          timeLimit,
-                          bounds,
-                          StringPairList());
+        std::cerr << "Error: the combinatorial engine does not support pattern "
+                  << MigrationGraph::getPatternString(pattern) << std::endl;
+        return 1;
       }
-      else
+    }
+  }
+  
+  // without migration graphs, a single unconstrained instance is solved
+  StringVector outputPrefixes;
+  if (migrationTrees.empty())
+  {
+    migrationTrees.push_back(StringPairList());
+    outputPrefixes.push_back(primary + "-");
+  }
+  else
+  {
+    char buf[1024];
+    for (int migTreeIdx = 0; migTreeIdx < migrationTrees.size(); ++migTreeIdx)
+    {
+      snprintf(buf, 1024, "%d-%s-", migTreeIdx, primary.c_str());
+      outputPrefixes.push_back(buf);
+    }
+  }
+  
+  if (oldMode)
+  {
+#ifdef HAS_GUROBI
+    for (MigrationGraph::Pattern pattern : patterns)
+    {
+      for (const StringPairList& migrationTree : migrationTrees)
       {
         IlpSolver::run(T,
                        primary,
@@ -226,10 +272,107 @@ int main(int argc, char** argv)
                        outputSearchGraph,
                        timeLimit,
                        bounds,
-                       StringPairList());
+                       migrationTree);
       }
     }
+#endif
+    return 0;
   }
-
+  
+  // cache entries are written atomically, so the cache is shared by all jobs
+  std::unique_ptr<SolutionCache> pCache;
+  if (!cacheDirectory.empty())
+  {
+    pCache.reset(new SolutionCache(cacheDirectory, "pmh"));
+  }
+  
+  // every job operates on its own copy of T, as LEMON graphs cannot be
+  // shared between threads
+  JobScheduler scheduler(nrJobs);
+  const int nrThreadsPerJob = JobScheduler::getNrThreadsPerJob(nrThreads,
+                                                               scheduler.getNrWorkers());
+  for (int migTreeIdx = 0; migTreeIdx < migrationTrees.size(); ++migTreeIdx)
+  {
+    const StringPairList& migrationTree = migrationTrees[migTreeIdx];
+    const std::string& outputPrefix = outputPrefixes[migTreeIdx];
+    
+    if (combinatorialMode)
+    {
+      for (MigrationGraph::Pattern pattern : patterns)
+      {
+        std::shared_ptr<CloneTree> pT(new CloneTree(T));
+        scheduler.addJob([&, pT, pattern, outputPrefix, migrationTree](std::ostream& out)
+        {
+          CombinatorialPmhSolver::run(*pT,
+                                      primary,
+                                      outputDirectory,
+                                      outputPrefix,
+                                      colorMap,
+                                      pattern,
+                                      timeLimit,
+                                      bounds,
+                                      migrationTree,
+                                      out);
+        });
+      }
+    }
+    else
+    {
+      // the ILP is built once and reused for every pattern
+      std::shared_ptr<CloneTree> pT(new CloneTree(T));
+      scheduler.addJob([&, pT, outputPrefix, migrationTree](std::ostream& out)
+      {
+        IlpPmhSolver ilpSolver(*pT, primary, patterns.front(), "", StringPairList());
+        ilpSolver.setPresolve(presolve);
+        ilpSolver.setWarmStart(warmStart);
+        ilpSolver.setCache(pCache.get());
+        for (MigrationGraph::Pattern pattern : patterns)
+        {
+          if (pareto)
+          {
+            IlpPmhSolver::runPareto(ilpSolver,
+                                    *pT,
+                                    primary,
+                                    outputDirectory,
+                                    outputPrefix,
+                                    colorMap,
+                                    pattern,
+                                    nrThreadsPerJob,
+                                    timeLimit,
+                                    bounds,
+                                    migrationTree,
+                                    out);
+            continue;
+          }
+          
+          IlpPmhSolver::run(ilpSolver,
+                            *pT,
+                            primary,
+                            outputDirectory,
+                            outputPrefix,
+                            colorMap,
+                            pattern,
+                            nrThreadsPerJob,
+                            outputILP,
+                            outputSearchGraph,
+                            timeLimit,
+                            bounds,
+                            migrationTree,
+                            out);
+        }
+      });
+    }
+  }
+  
+  try
+  {
+    scheduler.run(std::cout);
+  }
+  catch (std::exception& e)
+  {
+    std::cerr << "Error: " << e.what() << std::endl;
+    return 1;
+  }
+  
   return 0;
 }
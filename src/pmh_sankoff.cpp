@@ -17,12 +17,20 @@ int main(int argc, char** argv)
   std::string primaryAnatomicalSite;
   std::string outputDirectory;
   std::string filenameColorMap;
+  std::string filenameMigrationCosts;
+  int limit = -1;
+  bool countOnly = false;
   
   lemon::ArgParser ap(argc, argv);
   ap.refOption("p", "Primary anatomical sites separated by commas (if omitted, every\n" \
                "     anatomical site will be considered iteratively as the primary)", primaryAnatomicalSite)
     .refOption("o", "Output prefix", outputDirectory)
     .refOption("c", "Color map file", filenameColorMap)
+    .refOption("limit", "Maximum number of labelings to enumerate per primary (default: -1, unlimited)", limit)
+    .refOption("w", "Migration cost file, each line is of the form\n" \
+               "     '<source site> <target site> <cost>' (default cost: 1)", filenameMigrationCosts)
+    .refOption("count", "Only count labelings per number of seeding sites and pattern\n" \
+               "     without enumerating them", countOnly)
     .other("T", "Clone tree")
     .other("leaf_labeling", "Leaf labeling");
   ap.parse();
@@ -80,6 +88,22 @@ int main(int argc, char** argv)
     colorMap = T.generateColorMap();
   }
   
+  SankoffLabeling::StringPairToIntMap migrationCosts;
+  if (!filenameMigrationCosts.empty())
+  {
+    std::ifstream inMigrationCosts(filenameMigrationCosts.c_str());
+    if (!inMigrationCosts.good())
+    {
+      std::cerr << "Could not open '" << filenameMigrationCosts << "' for reading" << std::endl;
+      return 1;
+    }
+    
+    if (!SankoffLabeling::readMigrationCosts(inMigrationCosts, migrationCosts))
+    {
+      return 1;
+    }
+  }
+  
   std::cerr << "Clone tree has " << T.getNrAnatomicalSites() << " anatomical sites" << std::endl;
 
   if (primaryVector.empty())
@@ -87,7 +111,10 @@ int main(int argc, char** argv)
     StringSet Sigma = T.getAnatomicalSites();
     for (const std::string& primary : Sigma)
     {
-      SankoffLabeling::run(T, primary, outputDirectory, colorMap);
+      if (countOnly)
+        SankoffLabeling::count(T, primary, migrationCosts);
+      else
+        SankoffLabeling::run(T, primary, outputDirectory, colorMap, migrationCosts, limit);
     }
   }
   else
@@ -98,9 +125,13 @@ int main(int argc, char** argv)
       {
         std::cerr << "Warning: primary anatomical site '" << primary << "' missing in leaf labeling. Skipping." << std::endl;
       }
+      else if (countOnly)
+      {
+        SankoffLabeling::count(T, primary, migrationCosts);
+      }
       else
       {
-        SankoffLabeling::run(T, primary, outputDirectory, colorMap);
+        SankoffLabeling::run(T, primary, outputDirectory, colorMap, migrationCosts, limit);
       }
     }
   }
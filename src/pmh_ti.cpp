@@ -11,7 +11,9 @@
 #include "frequencymatrix.h"
 #include <fstream>
 #include <lemon/arg_parser.h>
+#ifdef HAS_GUROBI
 #include "old_ilps/ilpsolverext.h"
+#endif
 #include "ilppmhtisolver.h"
 #include "migrationgraph.h"
 #include <boost/algorithm/string.hpp>
@@ -19,6 +21,12 @@
 #include "spruce/statetree.h"
 #include "spruce/perfectphylotree.h"
 #include "enumeratemutationtrees.h"
+#include "jobscheduler.h"
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <sstream>
+#include <lemon/time_measure.h>
 
 int main(int argc, char** argv)
 {
@@ -36,6 +44,7 @@ int main(int argc, char** argv)
   std::string primary;
   std::string pattern = "0,1,2,3";
   int nrThreads = -1;
+  int nrJobs = 1;
   int timeLimitILP = -1;
   int seed = 0;
   IntTriple bounds = std::make_pair(-1, std::make_pair(-1, -1));
@@ -45,18 +54,35 @@ int main(int argc, char** argv)
   bool disablePolytomyResolution = false;
   int mutationTreeIdx = -1;
   bool useBounds = false;
+  bool portfolio = false;
+  bool prune = false;
+  bool warmStart = false;
+  std::string solver = MilpModel::getBackendString(MilpModel::getDefaultBackend());
   
   lemon::ArgParser ap(argc, argv);
   ap.refOption("c", "Color map file", filenameColorMap, true)
     .refOption("barT", "Mutation trees", filenameBarT, true)
     .refOption("F", "Frequencies file", filenameFrequencies, true)
     .refOption("g", "Output search graph", outputSearchGraph)
-    .refOption("log", "Gurobi logging", gurobiLog)
+    .refOption("log", "Solver logging", gurobiLog)
     .refOption("t", "Number of threads (default: -1, #cores)", nrThreads)
+    .refOption("j", "Number of concurrent jobs, threads are divided among\n"\
+               "     jobs (default: 1, -1: #cores)", nrJobs)
     .refOption("o", "Output prefix" , outputDirectory)
     .refOption("noPR", "Disable polytomy resolution", disablePolytomyResolution)
     .refOption("useBounds", "Only retain optimal solution", useBounds)
+    .refOption("portfolio", "Solve mutation trees concurrently (see -j) while sharing\n"\
+               "     the best solution found so far, aborting trees that cannot\n"\
+               "     attain it; only optimal trees are reported", portfolio)
+    .refOption("prune", "Solve mutation trees in order of a lower bound on the\n"\
+               "     migration number, skipping trees whose bound exceeds the\n"\
+               "     best migration number found so far", prune)
     .refOption("OLD", "Use old ILP (typically much slower)", oldMode)
+    .refOption("solver", "MILP solver (default: " + solver + "):\n"\
+               "       bb     : built-in branch and bound (slower)\n"\
+               "       gurobi : Gurobi (if compiled with Gurobi support)", solver)
+    .refOption("warmStart", "Warm start the ILP from a heuristic solution obtained by\n"\
+                            "     Sankoff labelings with greedily restricted migrations", warmStart)
     .refOption("mutTreeIdx", "Mutation tree index (default: -1)", mutationTreeIdx)
     .refOption("m", "Allowed migration patterns:\n"\
                "       0 : PS\n"\
@@ -191,116 +217,286 @@ int main(int argc, char** argv)
     return 1;
   }
   
+  if (!MilpModel::setDefaultBackend(solver))
+  {
+    std::cerr << "Error: unknown or unavailable MILP solver '" << solver << "'" << std::endl;
+    return 1;
+  }
+  
+#ifndef HAS_GUROBI
+  if (oldMode)
+  {
+    std::cerr << "Error: -OLD requires Gurobi" << std::endl;
+    return 1;
+  }
+#endif
+  
+  if (useBounds && portfolio)
+  {
+    std::cerr << "Error: -useBounds and -portfolio are mutually exclusive" << std::endl;
+    return 1;
+  }
+  
+  if (useBounds && nrJobs != 1)
+  {
+    std::cerr << "Warning: -useBounds requires serial execution, ignoring -j" << std::endl;
+    nrJobs = 1;
+  }
+  
+  // without migration graphs, a single unconstrained instance is solved
+  StringVector outputPrefixes;
+  if (migrationTrees.empty())
+  {
+    migrationTrees.push_back(StringPairList());
+    outputPrefixes.push_back("");
+  }
+  else
+  {
+    char buf[1024];
+    for (int migTreeIdx = 0; migTreeIdx < migrationTrees.size(); ++migTreeIdx)
+    {
+      snprintf(buf, 1024, "%d-", migTreeIdx);
+      outputPrefixes.push_back(buf);
+    }
+  }
+  
+  // mutation trees to consider, in order of their lower bounds if pruning
+  IntVector mutTreeOrder;
+  for (int mutTreeIdx = 0; mutTreeIdx < mutationTrees.size(); ++mutTreeIdx)
+  {
+    if (mutationTreeIdx == -1 || mutTreeIdx == mutationTreeIdx)
+    {
+      mutTreeOrder.push_back(mutTreeIdx);
+    }
+  }
+  
+  IntVector mutTreeLB(mutationTrees.size(), 0);
+  double lbTime = 0;
+  if (prune)
+  {
+    lemon::Timer timer;
+    for (int mutTreeIdx : mutTreeOrder)
+    {
+      mutTreeLB[mutTreeIdx] = IlpPmhTiSolver::computeMigrationNumberLB(mutationTrees[mutTreeIdx],
+                                                                       F,
+                                                                       primary,
+                                                                       disablePolytomyResolution);
+    }
+    lbTime = timer.realTime();
+    
+    std::stable_sort(mutTreeOrder.begin(), mutTreeOrder.end(),
+                     [&mutTreeLB](int i, int j) { return mutTreeLB[i] < mutTreeLB[j]; });
+  }
+  
+  // per job, the solve time and whether it was pruned
+  const int nrInstances = patterns.size() * migrationTrees.size() * mutTreeOrder.size();
+  DoubleVector jobTime(nrInstances, 0);
+  IntVector jobPruned(nrInstances, 0);
+  int jobIdx = 0;
+  
+  auto writeUnsolved = [](std::ostream& out,
+                          const std::string& outputPrefix,
+                          MigrationGraph::Pattern pattern,
+                          double time)
+  {
+    out << outputPrefix << "\t"
+        << "(" << MigrationGraph::getAllowedPatternsString(pattern) << ")\t"
+        << "-" << "\t"
+        << "-" << "\t"
+        << "-" << "\t"
+        << "-" << "\t"
+        << "-" << "\t"
+        << "-" << "\t"
+        << time
+        << std::endl;
+  };
+  
+  // in portfolio mode, the mutation trees of every pattern and migration
+  // graph share a cutoff, and results are only reported once all trees
+  // have been solved
+  struct PortfolioEntry
+  {
+    std::shared_ptr<MilpCutoff> _pCutoff;
+    MigrationGraph::Pattern _pattern;
+    std::string _outputPrefix;
+    IntTriple _res;
+    double _time;
+    std::string _output;
+  };
+  std::vector<PortfolioEntry> portfolioEntries;
+  const int nrAnatomicalSites = F.getNrAnatomicalSites();
+  
+  // every job operates on its own copy of the mutation tree, as LEMON
+  // graphs cannot be shared between threads
+  JobScheduler scheduler(nrJobs);
+  const int nrThreadsPerJob = JobScheduler::getNrThreadsPerJob(nrThreads,
+                                                               scheduler.getNrWorkers());
   char buf[1024];
   for (MigrationGraph::Pattern pattern : patterns)
   {
-    if (migrationTrees.size() > 0)
+    for (int migTreeIdx = 0; migTreeIdx < migrationTrees.size(); ++migTreeIdx)
     {
-      int migTreeIdx = 0;
-      for (const StringPairList& migrationTree : migrationTrees)
+      const StringPairList& migrationTree = migrationTrees[migTreeIdx];
+      std::shared_ptr<MilpCutoff> pCutoff;
+      if (portfolio)
       {
-        int mutTreeIdx = 0;
-        for (const CloneTree& barT : mutationTrees)
+        pCutoff.reset(new MilpCutoff());
+      }
+      
+      // best migration number found among the mutation trees
+      std::shared_ptr<MilpCutoff> pBestMu;
+      if (prune)
+      {
+        pBestMu.reset(new MilpCutoff());
+      }
+      
+      for (int mutTreeIdx : mutTreeOrder)
+      {
+        snprintf(buf, 1024, "%s%d-", outputPrefixes[migTreeIdx].c_str(), mutTreeIdx);
+        const std::string outputPrefix = buf;
+        
+        if (oldMode)
+        {
+#ifdef HAS_GUROBI
+          IlpSolverExt::run(mutationTrees[mutTreeIdx],
+                            F,
+                            primary,
+                            outputDirectory,
+                            outputPrefix,
+                            colorMap,
+                            pattern,
+                            nrThreads,
+                            outputILP,
+                            outputSearchGraph,
+                            timeLimitILP,
+                            bounds,
+                            migrationTree);
+#endif
+          continue;
+        }
+        
+        const int entryIdx = portfolioEntries.size();
+        if (portfolio)
+        {
+          PortfolioEntry entry = { pCutoff, pattern, outputPrefix,
+                                   std::make_pair(-1, std::make_pair(-1, -1)), 0, "" };
+          portfolioEntries.push_back(entry);
+        }
+        
+        std::shared_ptr<CloneTree> pBarT(new CloneTree(mutationTrees[mutTreeIdx]));
+        const int lb = mutTreeLB[mutTreeIdx];
+        scheduler.addJob([&, pBarT, pCutoff, pBestMu, lb, pattern, outputPrefix, migrationTree, entryIdx, jobIdx](std::ostream& out)
         {
-          if (mutationTreeIdx == -1 || mutTreeIdx == mutationTreeIdx)
+          if (pBestMu && (lb == std::numeric_limits<int>::max() || lb > pBestMu->get()))
           {
-            snprintf(buf, 1024, "%d-%d-", migTreeIdx, mutTreeIdx);
-            
-            if (!oldMode)
+            jobPruned[jobIdx] = 1;
+            if (!portfolio)
             {
-              IntTriple res = IlpPmhTiSolver::run(barT,
-                                                  F,
-                                                  primary,
-                                                  outputDirectory,
-                                                  buf,
-                                                  colorMap,
-                                                  pattern,
-                                                  nrThreads,
-                                                  outputILP,
-                                                  outputSearchGraph,
-                                                  timeLimitILP,
-                                                  bounds,
-                                                  migrationTree,
-                                                  disablePolytomyResolution);
-              
-              if (res.first != -1 && useBounds)
-              {
-                bounds = res;
-              }
+              writeUnsolved(out, outputPrefix, pattern, 0);
             }
-            else
+            return;
+          }
+          
+          lemon::Timer timer;
+          std::ostringstream portfolioOut;
+          
+          // bounds is only updated when jobs are executed serially
+          IntTriple res = IlpPmhTiSolver::run(*pBarT,
+                                              F,
+                                              primary,
+                                              outputDirectory,
+                                              outputPrefix,
+                                              colorMap,
+                                              pattern,
+                                              nrThreadsPerJob,
+                                              outputILP,
+                                              outputSearchGraph,
+                                              timeLimitILP,
+                                              bounds,
+                                              migrationTree,
+                                              disablePolytomyResolution,
+                                              warmStart,
+                                              pCutoff.get(),
+                                              portfolio ? portfolioOut : out);
+          
+          if (res.first != -1 && useBounds)
+          {
+            bounds = res;
+          }
+          
+          if (res.first != -1 && pBestMu)
+          {
+            pBestMu->tighten(res.first);
+          }
+          jobTime[jobIdx] = timer.realTime();
+          
+          if (portfolio)
+          {
+            if (res.first != -1)
             {
-              IlpSolverExt::run(barT,
-                                F,
-                                primary,
-                                outputDirectory,
-                                buf,
-                                colorMap,
-                                pattern,
-                                nrThreads,
-                                outputILP,
-                                outputSearchGraph,
-                                timeLimitILP,
-                                bounds,
-                                migrationTree);
+              pCutoff->tighten(IlpPmhTiSolver::getCutoff(res, nrAnatomicalSites));
             }
+            
+            PortfolioEntry& entry = portfolioEntries[entryIdx];
+            entry._res = res;
+            entry._time = jobTime[jobIdx];
+            entry._output = portfolioOut.str();
           }
-          ++mutTreeIdx;
-        }
-        ++migTreeIdx;
+        });
+        ++jobIdx;
       }
     }
+  }
+  
+  try
+  {
+    scheduler.run(std::cout);
+  }
+  catch (std::exception& e)
+  {
+    std::cerr << "Error: " << e.what() << std::endl;
+    return 1;
+  }
+  
+  // report the trees attaining the final cutoff, which does not depend on
+  // the order in which the trees were solved
+  for (const PortfolioEntry& entry : portfolioEntries)
+  {
+    if (entry._res.first != -1
+        && IlpPmhTiSolver::getCutoff(entry._res, nrAnatomicalSites) <= entry._pCutoff->get())
+    {
+      std::cout << entry._output;
+    }
     else
     {
-      int mutTreeIdx = 0;
-      for (const CloneTree& barT : mutationTrees)
+      writeUnsolved(std::cout, entry._outputPrefix, entry._pattern, entry._time);
+    }
+  }
+  
+  if (prune)
+  {
+    int nrPruned = 0;
+    int nrSolved = 0;
+    double solveTime = 0;
+    for (int i = 0; i < jobIdx; ++i)
+    {
+      if (jobPruned[i])
       {
-        if (mutationTreeIdx == -1 || mutTreeIdx == mutationTreeIdx)
-        {
-          snprintf(buf, 1024, "%d-", mutTreeIdx);
-          if (!oldMode)
-          {
-            IntTriple res = IlpPmhTiSolver::run(barT,
-                                                F,
-                                                primary,
-                                                outputDirectory,
-                                                buf,
-                                                colorMap,
-                                                pattern,
-                                                nrThreads,
-                                                outputILP,
-                                                outputSearchGraph,
-                                                timeLimitILP,
-                                                bounds,
-                                                StringPairList(),
-                                                disablePolytomyResolution);
-            
-            if (res.first != -1 && useBounds)
-            {
-              bounds = res;
-            }
-          }
-          else
-          {
-            IlpSolverExt::run(barT,
-                              F,
-                              primary,
-                              outputDirectory,
-                              buf,
-                              colorMap,
-                              pattern,
-                              nrThreads,
-                              outputILP,
-                              outputSearchGraph,
-                              timeLimitILP,
-                              bounds,
-                              StringPairList());
-          }
-        }
-        ++mutTreeIdx;
+        ++nrPruned;
+      }
+      else
+      {
+        ++nrSolved;
+        solveTime += jobTime[i];
       }
     }
+    
+    // the time saved is estimated by the mean time of the solved trees
+    std::cerr << "Pruned " << nrPruned << " out of " << jobIdx
+              << " mutation trees using migration number lower bounds computed in "
+              << lbTime << " s (estimated time saved: "
+              << (nrSolved > 0 ? nrPruned * solveTime / nrSolved : 0) << " s)" << std::endl;
   }
-
+  
   return 0;
 }
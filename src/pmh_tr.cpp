@@ -10,11 +10,16 @@
 #include "clonetree.h"
 #include <fstream>
 #include <lemon/arg_parser.h>
+#ifdef HAS_GUROBI
 #include "old_ilps/ilpsolver.h"
 #include "old_ilps/ilpbinarizationsolver.h"
+#endif
 #include "migrationgraph.h"
 #include "migrationtree.h"
 #include "ilppmhtrsolver.h"
+#include "jobscheduler.h"
+#include "solutioncache.h"
+#include <memory>
 #include <boost/algorithm/string.hpp>
 
 int main(int argc, char** argv)
@@ -31,20 +36,36 @@ int main(int argc, char** argv)
   std::string primary;
   std::string pattern = "0,1,2,3";
   int nrThreads = -1;
+  int nrJobs = 1;
   int timeLimit = -1;
   IntTriple bounds = std::make_pair(-1, std::make_pair(-1, -1));
   std::string migrationTreeFile;
   bool oldMode = false;
+  bool warmStart = false;
+  std::string cacheDirectory;
+  bool pareto = false;
+  std::string solver = MilpModel::getBackendString(MilpModel::getDefaultBackend());
   
   lemon::ArgParser ap(argc, argv);
   ap.refOption("c", "Color map file", filenameColorMap, true)
     .other("T", "Clone tree")
     .other("leaf_labeling", "Leaf labeling")
     .refOption("g", "Output search graph", outputSearchGraph)
-    .refOption("log", "Gurobi logging", gurobiLog)
+    .refOption("log", "Solver logging", gurobiLog)
     .refOption("t", "Number of threads (default: -1, #cores)", nrThreads)
+    .refOption("j", "Number of concurrent jobs, threads are divided among\n"\
+                    "     jobs (default: 1, -1: #cores)", nrJobs)
     .refOption("o", "Output prefix" , outputDirectory)
     .refOption("OLD", "Use old ILP (typically much slower)", oldMode)
+    .refOption("solver", "MILP solver (default: " + solver + "):\n"\
+               "       bb     : built-in branch and bound (slower)\n"\
+               "       gurobi : Gurobi (if compiled with Gurobi support)", solver)
+    .refOption("warmStart", "Warm start the ILP from a heuristic solution obtained by\n"\
+                            "     Sankoff labelings with greedily restricted migrations", warmStart)
+    .refOption("cache", "Directory of the on-disk solution cache, optimal solutions are\n"\
+                        "     stored and reported without solving when queried again", cacheDirectory)
+    .refOption("pareto", "Enumerate all non-dominated (mu, gamma, sigma) triples instead of\n"\
+                         "     the lexicographic minimum (no cache)", pareto)
     .refOption("m", "Allowed migration patterns:\n"\
                "       0 : PS\n"\
                "       1 : PS, S\n" \
@@ -158,65 +179,49 @@ int main(int argc, char** argv)
     return 1;
   }
   
-  char buf[1024];
-  for (MigrationGraph::Pattern pattern : patterns)
+  if (!MilpModel::setDefaultBackend(solver))
+  {
+    std::cerr << "Error: unknown or unavailable MILP solver '" << solver << "'" << std::endl;
+    return 1;
+  }
+  
+#ifndef HAS_GUROBI
+  if (oldMode)
+  {
+    std::cerr << "Error: -OLD requires Gurobi" << std::endl;
+    return 1;
+  }
+#endif
+  
+  if (oldMode && pareto)
+  {
+    std::cerr << "Error: -pareto cannot be combined with -OLD" << std::endl;
+    return 1;
+  }
+  
+  // without migration graphs, a single unconstrained instance is solved
+  StringVector outputPrefixes;
+  if (migrationTrees.empty())
+  {
+    migrationTrees.push_back(StringPairList());
+    outputPrefixes.push_back(primary + "-");
+  }
+  else
   {
-    if (migrationTrees.size() > 0)
+    char buf[1024];
+    for (int migTreeIdx = 0; migTreeIdx < migrationTrees.size(); ++migTreeIdx)
     {
-      int migTreeIdx = 0;
-      for (const StringPairList& migrationTree : migrationTrees)
-      {
-        if (!oldMode)
-        {
-          snprintf(buf, 1024, "%d-%s-", migTreeIdx, primary.c_str());
-          IlpPmhTrSolver::run(T,
-                              primary,
-                              outputDirectory,
-                              buf,
-                              colorMap,
-                              pattern,
-                              nrThreads,
-                              outputILP,
-                              outputSearchGraph,
-                              timeLimit,
-                              bounds,
-                              migrationTree);
-        }
-        else
-        {
-          IlpBinarizationSolver::run(T,
-                                     primary,
-                                     outputDirectory,
-                                     colorMap,
-                                     pattern,
-                                     nrThreads,
-                                     outputILP,
-                                     outputSearchGraph,
-                                     timeLimit,
-                                     bounds,
-                                     migrationTree);
-        }
-        ++migTreeIdx;
-      }
+      snprintf(buf, 1024, "%d-%s-", migTreeIdx, primary.c_str());
+      outputPrefixes.push_back(buf);
     }
-    else
+  }
+  
+  if (oldMode)
+  {
+#ifdef HAS_GUROBI
+    for (MigrationGraph::Pattern pattern : patterns)
     {
-      if (!oldMode)
-      {
-        IlpPmhTrSolver::run(T,
-                            primary,
-                            outputDirectory,
-                            primary + "-",
-                            colorMap,
-                            pattern,
-                            nrThreads,
-                            outputILP,
-                            outputSearchGraph,
-                            timeLimit,
-                            bounds,
-                            StringPairList());
-      }
-      else
+      for (const StringPairList& migrationTree : migrationTrees)
       {
         IlpBinarizationSolver::run(T,
                                    primary,
@@ -228,10 +233,64 @@ int main(int argc, char** argv)
                                    outputSearchGraph,
                                    timeLimit,
                                    bounds,
-                                   StringPairList());
+                                   migrationTree);
       }
     }
+#endif
+    return 0;
   }
-
+  
+  // cache entries are written atomically, so the cache is shared by all jobs
+  std::unique_ptr<SolutionCache> pCache;
+  if (!cacheDirectory.empty())
+  {
+    pCache.reset(new SolutionCache(cacheDirectory, "pmh_tr"));
+  }
+  
+  // every job operates on its own copy of T, as LEMON graphs cannot be
+  // shared between threads
+  JobScheduler scheduler(nrJobs);
+  const int nrThreadsPerJob = JobScheduler::getNrThreadsPerJob(nrThreads,
+                                                               scheduler.getNrWorkers());
+  for (MigrationGraph::Pattern pattern : patterns)
+  {
+    for (int migTreeIdx = 0; migTreeIdx < migrationTrees.size(); ++migTreeIdx)
+    {
+      const StringPairList& migrationTree = migrationTrees[migTreeIdx];
+      const std::string& outputPrefix = outputPrefixes[migTreeIdx];
+      
+      std::shared_ptr<CloneTree> pT(new CloneTree(T));
+      scheduler.addJob([&, pT, pattern, outputPrefix, migrationTree](std::ostream& out)
+      {
+        IlpPmhTrSolver::run(*pT,
+                            primary,
+                            outputDirectory,
+                            outputPrefix,
+                            colorMap,
+                            pattern,
+                            nrThreadsPerJob,
+                            outputILP,
+                            outputSearchGraph,
+                            timeLimit,
+                            bounds,
+                            migrationTree,
+                            warmStart,
+                            pCache.get(),
+                            pareto,
+                            out);
+      });
+    }
+  }
+  
+  try
+  {
+    scheduler.run(std::cout);
+  }
+  catch (std::exception& e)
+  {
+    std::cerr << "Error: " << e.what() << std::endl;
+    return 1;
+  }
+  
   return 0;
 }
@@ -0,0 +1,195 @@
+/*
+ * profiler.cpp
+ *
+ *  Created on: 18-oct-2026
+ *      Author: M. El-Kebir
+ */
+
+#include "profiler.h"
+#include <cstdio>
+#include <sys/resource.h>
+
+Profiler::Profiler()
+  : _phases()
+  , _counters()
+  , _attributes()
+  , _activePhase(-1)
+  , _timer(false)
+{
+}
+
+void Profiler::clear()
+{
+  _phases.clear();
+  _counters.clear();
+  _attributes.clear();
+  _activePhase = -1;
+  _timer.stop();
+}
+
+void Profiler::start(const std::string& phase)
+{
+  stop();
+  
+  const Entry& entry = get(_phases, phase);
+  _activePhase = &entry - &_phases.front();
+  _timer.restart();
+}
+
+void Profiler::stop()
+{
+  if (_activePhase != -1)
+  {
+    _timer.stop();
+    _phases[_activePhase].second += _timer.realTime();
+    _activePhase = -1;
+  }
+}
+
+void Profiler::setCounter(const std::string& name,
+                          double value)
+{
+  get(_counters, name).second = value;
+}
+
+void Profiler::setAttribute(const std::string& name,
+                            const std::string& value)
+{
+  for (Attribute& attribute : _attributes)
+  {
+    if (attribute.first == name)
+    {
+      attribute.second = value;
+      return;
+    }
+  }
+  _attributes.push_back(Attribute(name, value));
+}
+
+double Profiler::getTotalTime() const
+{
+  double res = 0;
+  for (const Entry& phase : _phases)
+  {
+    res += phase.second;
+  }
+  if (_activePhase != -1)
+  {
+    res += _timer.realTime();
+  }
+  return res;
+}
+
+Profiler::Entry& Profiler::get(EntryVector& entries,
+                               const std::string& name)
+{
+  for (Entry& entry : entries)
+  {
+    if (entry.first == name)
+    {
+      return entry;
+    }
+  }
+  entries.push_back(Entry(name, 0));
+  return entries.back();
+}
+
+void Profiler::writeString(std::ostream& out,
+                           const std::string& str)
+{
+  out << '"';
+  for (char c : str)
+  {
+    switch (c)
+    {
+      case '"':
+        out << "\\\"";
+        break;
+      case '\\':
+        out << "\\\\";
+        break;
+      case '\n':
+        out << "\\n";
+        break;
+      case '\t':
+        out << "\\t";
+        break;
+      default:
+        if (static_cast<unsigned char>(c) < 0x20)
+        {
+          char buf[8];
+          snprintf(buf, 8, "\\u%04x", c);
+          out << buf;
+        }
+        else
+        {
+          out << c;
+        }
+        break;
+    }
+  }
+  out << '"';
+}
+
+void Profiler::writeJSON(std::ostream& out) const
+{
+  const std::streamsize precision = out.precision(15);
+  
+  out << "{" << std::endl;
+  for (const Attribute& attribute : _attributes)
+  {
+    out << "  ";
+    writeString(out, attribute.first);
+    out << ": ";
+    writeString(out, attribute.second);
+    out << "," << std::endl;
+  }
+  
+  out << "  \"phases\": [";
+  bool first = true;
+  for (int i = 0; i < _phases.size(); ++i)
+  {
+    double time = _phases[i].second;
+    if (i == _activePhase)
+    {
+      time += _timer.realTime();
+    }
+    
+    out << (first ? "" : ",") << std::endl << "    {\"name\": ";
+    writeString(out, _phases[i].first);
+    out << ", \"time\": " << time << "}";
+    first = false;
+  }
+  out << std::endl << "  ]," << std::endl;
+  out << "  \"totalTime\": " << getTotalTime() << "," << std::endl;
+  
+  out << "  \"counters\": {";
+  first = true;
+  for (const Entry& counter : _counters)
+  {
+    out << (first ? "" : ",") << std::endl << "    ";
+    writeString(out, counter.first);
+    out << ": " << counter.second;
+    first = false;
+  }
+  out << std::endl << "  }" << std::endl;
+  out << "}" << std::endl;
+  
+  out.precision(precision);
+}
+
+long Profiler::getPeakMemory()
+{
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0)
+  {
+    return -1;
+  }
+#ifdef __APPLE__
+  // bytes on macOS
+  return usage.ru_maxrss / 1024;
+#else
+  // kilobytes on Linux
+  return usage.ru_maxrss;
+#endif
+}
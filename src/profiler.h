@@ -0,0 +1,100 @@
+/*
+ * profiler.h
+ *
+ *  Created on: 18-oct-2026
+ *      Author: M. El-Kebir
+ */
+
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <lemon/time_measure.h>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+/// This class records the wall-clock time spent in consecutive phases
+/// together with named counters, and writes them as a JSON report.
+/// At most one phase is active at any time; starting a phase stops the
+/// active one. Phases that are started multiple times accumulate.
+///
+/// \brief Per-phase timing and counter report
+class Profiler
+{
+public:
+  /// Constructor
+  Profiler();
+  
+  /// Remove all phases, counters and attributes
+  void clear();
+  
+  /// Stop the active phase (if any) and start the given phase
+  ///
+  /// @param phase Phase name
+  void start(const std::string& phase);
+  
+  /// Stop the active phase (if any)
+  void stop();
+  
+  /// Set counter
+  ///
+  /// @param name Counter name
+  /// @param value Value
+  void setCounter(const std::string& name,
+                  double value);
+  
+  /// Set attribute
+  ///
+  /// @param name Attribute name
+  /// @param value Value
+  void setAttribute(const std::string& name,
+                    const std::string& value);
+  
+  /// Return the total time of all phases in seconds
+  double getTotalTime() const;
+  
+  /// Write report in JSON format
+  ///
+  /// @param out Output stream
+  void writeJSON(std::ostream& out) const;
+  
+  /// Return the peak resident set size of the process in kilobytes
+  /// (-1 if unavailable). Note that this is a process-wide high-water mark,
+  /// which also covers concurrently solved instances.
+  static long getPeakMemory();
+  
+private:
+  typedef std::pair<std::string, double> Entry;
+  typedef std::vector<Entry> EntryVector;
+  typedef std::pair<std::string, std::string> Attribute;
+  typedef std::vector<Attribute> AttributeVector;
+  
+  /// Return the entry with the given name, which is added if absent
+  ///
+  /// @param entries Entries
+  /// @param name Name
+  static Entry& get(EntryVector& entries,
+                    const std::string& name);
+  
+  /// Write string as a JSON string literal
+  ///
+  /// @param out Output stream
+  /// @param str String
+  static void writeString(std::ostream& out,
+                          const std::string& str);
+  
+private:
+  /// Time in seconds of each phase in order of first occurrence
+  EntryVector _phases;
+  /// Counters in order of first occurrence
+  EntryVector _counters;
+  /// Attributes in order of first occurrence
+  AttributeVector _attributes;
+  /// Index of the active phase (-1 if none)
+  int _activePhase;
+  /// Timer of the active phase
+  lemon::Timer _timer;
+};
+
+#endif // PROFILER_H
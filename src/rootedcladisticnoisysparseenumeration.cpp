@@ -18,8 +18,7 @@ RootedCladisticNoisySparseEnumeration::RootedCladisticNoisySparseEnumeration(con
                                       bool fixTrunk,
                                       const IntSet& whiteList)
   : RootedCladisticNoisyEnumeration(G, limit, timeLimit, threads, lowerbound, monoclonal, fixTrunk, whiteList)
-  , _env()
-  , _model(_env)
+  , _model()
   , _f()
   , _u()
   , _z()
@@ -27,49 +26,27 @@ RootedCladisticNoisySparseEnumeration::RootedCladisticNoisySparseEnumeration(con
 {
 };
   
-void RootedCladisticNoisySparseEnumeration::initF(int solIdx,
+void RootedCladisticNoisySparseEnumeration::initF(const SubDigraph& T,
                                                   RealTensor& F) const
 {
   const int m = _G.F().m();
   const int n = _G.F().n();
   const int k = _G.F().k();
   
-  const Digraph& G = _G.G();
-  
-  // 1. Initialize solution tree
-  BoolNodeMap filterNodesT(G, false);
-  BoolArcMap filterArcsT(G, false);
-  SubDigraph T(G, filterNodesT, filterArcsT);
-  
-  ArcListList::const_iterator it = _result.begin();
-  int tmp = solIdx;
-  for (; tmp > 0; --tmp, ++it);
-  
-  const ArcList& arcs = *it;
-  for (ArcListIt it = arcs.begin(); it != arcs.end(); ++it)
-  {
-    Arc a_cidj = *it;
-    Node v_ci = G.source(a_cidj);
-    Node v_dj = G.target(a_cidj);
-    T.enable(v_ci);
-    T.enable(v_dj);
-    T.enable(a_cidj);
-  }
-  
-  // 2. Formulate ILP
+  // 1. Formulate ILP
+  _model = MilpModel();
   initVariables(T);
   initConstraints(T);
   initObjective(T);
   
-  // 3. Solve
+  // 2. Solve
   if (g_verbosity != VERBOSE_DEBUG)
   {
-    _model.getEnv().set(GRB_IntParam_LogToConsole, 0);
+    _model.setLogToConsole(false);
   }
   _model.optimize();
   
-  int status = _model.get(GRB_IntAttr_Status);
-  if (status == GRB_OPTIMAL)
+  if (_model.getStatus() == MilpModel::OPTIMAL)
   {
     for (int i = 0; i < k; ++i)
     {
@@ -77,7 +54,7 @@ void RootedCladisticNoisySparseEnumeration::initF(int solIdx,
       {
         for (int c = 0; c < n; ++c)
         {
-          double val = _f[i][p][c].get(GRB_DoubleAttr_X);
+          double val = _f[i][p][c].getValue();
           assert(0 <= val && val <= 1);
           F.set(i, p, c, val);
         }
@@ -122,7 +99,7 @@ void RootedCladisticNoisySparseEnumeration::initVariables(const SubDigraph& T) c
                  i,
                  _G.F().getRowLabel(p).c_str(),
                  _G.F().getColLabel(c).c_str());
-        _f[i][p][c] = _model.addVar(0, 1, 0, GRB_CONTINUOUS, buf);
+        _f[i][p][c] = _model.addVar(0, 1, 0, MilpVar::CONTINUOUS, buf);
       }
     }
   }
@@ -148,16 +125,15 @@ void RootedCladisticNoisySparseEnumeration::initVariables(const SubDigraph& T) c
       snprintf(buf, 1024, "u_%s_%d",
                _G.F().getRowLabel(p).c_str(),
                idx);
-      _u[p][idx] = _model.addVar(0, 1, 0, GRB_CONTINUOUS, buf);
+      _u[p][idx] = _model.addVar(0, 1, 0, MilpVar::CONTINUOUS, buf);
       
       snprintf(buf, 1024, "z_%s_%d",
                _G.F().getRowLabel(p).c_str(),
                idx);
-      _z[p][idx] = _model.addVar(0, 1, 0, GRB_BINARY, buf);
+      _z[p][idx] = _model.addVar(0, 1, 0, MilpVar::BINARY, buf);
     }
   }
   
-  _model.update();
 }
   
 void RootedCladisticNoisySparseEnumeration::initConstraints(const SubDigraph& T) const
@@ -198,13 +174,13 @@ void RootedCladisticNoisySparseEnumeration::initConstraints(const SubDigraph& T)
     {
       IntPair ci = *(_G.nodeToCharState(v_ci).begin());
       
-      GRBLinExpr lhs;
+      MilpLinExpr lhs;
       for (int l : _G.S(ci.first).D(ci.second))
       {
         lhs += _f[l][p][ci.first];
       }
       
-      GRBLinExpr rhs;
+      MilpLinExpr rhs;
       for (SubOutArcIt a(T, v_ci); a != lemon::INVALID; ++a)
       {
         Node v_dj = T.target(a);
@@ -222,7 +198,6 @@ void RootedCladisticNoisySparseEnumeration::initConstraints(const SubDigraph& T)
     }
   }
   
-  _model.update();
 }
   
 void RootedCladisticNoisySparseEnumeration::initObjective(const SubDigraph& T) const
@@ -230,8 +205,8 @@ void RootedCladisticNoisySparseEnumeration::initObjective(const SubDigraph& T) c
   const int m = _G.F().m();
   const int nrVertices = lemon::countNodes(T);
   
-  GRBLinExpr obj;
-  GRBLinExpr usages;
+  MilpLinExpr obj;
+  MilpLinExpr usages;
   
   for (SubNodeIt v_ci(T); v_ci != lemon::INVALID; ++v_ci)
   {
@@ -243,8 +218,7 @@ void RootedCladisticNoisySparseEnumeration::initObjective(const SubDigraph& T) c
     }
   }
   
-  _model.setObjective(obj, GRB_MINIMIZE);
-  _model.update();
+  _model.setObjective(obj, MilpModel::MINIMIZE);
 }
   
 } // namespace gm
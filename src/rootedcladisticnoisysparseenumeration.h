@@ -9,7 +9,7 @@
 #define ROOTEDCLADISTICNOISYSPARSEENUMERATION_H
 
 #include "spruce/rootedcladisticnoisyenumeration.h"
-#include <gurobi_c++.h>
+#include "milp/milpmodel.h"
 
 namespace gm {
   
@@ -25,12 +25,12 @@ public:
                                   bool fixTrunk,
                                         const IntSet& whiteList);
 private:
-  virtual void initF(int solIdx, RealTensor& F) const;
-  /// Gurobi variable array
-  typedef std::vector<GRBVar> VarArray;
-  /// Gurobi variable matrix
+  virtual void initF(const SubDigraph& T, RealTensor& F) const;
+  /// Variable array
+  typedef std::vector<MilpVar> VarArray;
+  /// Variable matrix
   typedef std::vector<VarArray> VarMatrix;
-  /// Gurobi variable 3D matrix
+  /// Variable 3D matrix
   typedef std::vector<VarMatrix> Var3Matrix;
   
   void initVariables(const SubDigraph& T) const;
@@ -40,10 +40,8 @@ private:
   void initObjective(const SubDigraph& T) const;
 
 private:
-  /// Gurobi environment
-  mutable GRBEnv _env;
-  /// Gurobi model
-  mutable GRBModel _model;
+  /// Model
+  mutable MilpModel _model;
   /// Variable f[p][c] is frequency of mutation incoming to clone i in sample p
   mutable Var3Matrix _f;
   /// Variable u[p][i] is usage of clone i in sample p
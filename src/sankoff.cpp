@@ -7,259 +7,571 @@
 
 #include "sankoff.h"
 
+const int Sankoff::_wordSize;
+const int Sankoff::_inf;
+
 Sankoff::Sankoff(const CharacterTree& T)
   : MPBase(T)
-  , _M(T.getNrCharacters(), NULL)
+  , _order()
+  , _index(T.tree(), -1)
+  , _childOffset()
+  , _children()
+  , _parent()
+  , _decisionOrder()
+  , _rootStates(T.getNrCharacters())
+  , _nrWords(T.getNrCharacters(), 0)
+  , _transitionCost(T.getNrCharacters())
+  , _cost(T.getNrCharacters())
+  , _backPtr(T.getNrCharacters())
 {
 }
 
+void Sankoff::initOrder()
+{
+  const Digraph& T = _T.tree();
+
+  // iterative post-order traversal
+  _order.clear();
+  NodeVector stack(1, _T.root());
+  NodeVector preOrder;
+  while (!stack.empty())
+  {
+    Node u = stack.back();
+    stack.pop_back();
+    preOrder.push_back(u);
+    for (OutArcIt a(T, u); a != lemon::INVALID; ++a)
+    {
+      stack.push_back(T.target(a));
+    }
+  }
+  _order.assign(preOrder.rbegin(), preOrder.rend());
+
+  const int n = _order.size();
+  for (int i = 0; i < n; ++i)
+  {
+    _index[_order[i]] = i;
+  }
+
+  // children sorted by node id, matching the original back trace order
+  _childOffset.assign(n + 1, 0);
+  _children.clear();
+  for (int i = 0; i < n; ++i)
+  {
+    Node u = _order[i];
+    _childOffset[i] = _children.size();
+    NodeVector children;
+    for (OutArcIt a(T, u); a != lemon::INVALID; ++a)
+    {
+      children.push_back(T.target(a));
+    }
+    std::sort(children.begin(), children.end());
+    for (Node v : children)
+    {
+      _children.push_back(_index[v]);
+    }
+  }
+  _childOffset[n] = _children.size();
+  
+  _parent.assign(n, -1);
+  for (int i = 0; i < n; ++i)
+  {
+    for (int k = _childOffset[i]; k < _childOffset[i + 1]; ++k)
+    {
+      _parent[_children[k]] = i;
+    }
+  }
+  
+  // pre-order of internal nodes, visiting children in decreasing node id
+  _decisionOrder.clear();
+  IntVector indexStack(1, _index[_T.root()]);
+  while (!indexStack.empty())
+  {
+    const int i = indexStack.back();
+    indexStack.pop_back();
+    if (_T.isLeaf(_order[i])) continue;
+    
+    _decisionOrder.push_back(i);
+    for (int k = _childOffset[i]; k < _childOffset[i + 1]; ++k)
+    {
+      indexStack.push_back(_children[k]);
+    }
+  }
+}
+
 void Sankoff::run(int rootState)
 {
   const int nrCharacters = _T.getNrCharacters();
   
-  // clear and initialize M
+  computeCosts(rootState);
+  
   for (int c = 0; c < nrCharacters; ++c)
   {
-    delete _M[c];
-    _M[c] = new EntryMatrix(_T.tree(), EntryVector(_T.getNrStates(c)));
+    for (SolutionIt it(*this, c); it.valid(); ++it)
+    {
+      IntNodeMap* pStateVector = new IntNodeMap(_T.tree(), -1);
+      _stateVector[c].push_back(pStateVector);
+      _homoplasyVector[c].push_back(true);
+      
+      for (NodeIt w(_T.tree()); w != lemon::INVALID; ++w)
+      {
+        assert(it.state(w) >= 0);
+        pStateVector->set(w, it.state(w));
+      }
+    }
   }
   
-  Node root =  _T.root();
+  updateHomoplasy();
+}
+
+void Sankoff::setTransitionCosts(int c, const IntMatrix& costs)
+{
+  assert(0 <= c && c < _T.getNrCharacters());
+  
+  const int nrStates = _T.getNrStates(c);
+  assert(costs.size() == nrStates);
+  
+  _transitionCost[c].assign(nrStates * nrStates, 0);
+  for (int s = 0; s < nrStates; ++s)
+  {
+    assert(costs[s].size() == nrStates);
+    assert(costs[s][s] == 0);
+    for (int t = 0; t < nrStates; ++t)
+    {
+      assert(costs[s][t] >= 0);
+      _transitionCost[c][s * nrStates + t] = costs[s][t];
+    }
+  }
+}
+
+void Sankoff::computeCosts(int rootState)
+{
+  const int nrCharacters = _T.getNrCharacters();
+
+  initOrder();
+
+  const int n = _order.size();
+  const int rootIdx = _index[_T.root()];
   for (int c = 0; c < nrCharacters; ++c)
   {
     const int nrStates = _T.getNrStates(c);
-    
-    run(c, root);
 
-    // backtrace
-    NodeStatePairList frontier;
+    // clear and initialize the dynamic programming table
+    _nrWords[c] = (nrStates + _wordSize - 1) / _wordSize;
+    _cost[c].assign(n * nrStates, _inf);
+    _backPtr[c].assign(n * nrStates * _nrWords[c], 0);
+
+    solve(c);
+
+    // determine the root states to back trace from
+    _rootStates[c].clear();
     if (rootState == -1)
     {
-      // 1. find minimum cost state for the root vertex
-      int min_cost = std::numeric_limits<int>::max();
-      int min_s = -1;
+      // find minimum cost state for the root vertex
+      int min_cost = _inf;
       for (int s = 0; s < nrStates; ++s)
       {
-        const Entry& entry_s = entry(c, root, s);
-        if (entry_s._cost < min_cost)
-        {
-          min_cost = entry_s._cost;
-          min_s = s;
-        }
+        min_cost = std::min(min_cost, cost(c, rootIdx, s));
       }
-      
-      assert(min_s != -1);
+
       for (int s = 0; s < nrStates; ++s)
       {
-        if (entry(c, root, s)._cost == min_cost)
+        if (cost(c, rootIdx, s) == min_cost)
         {
-          frontier.push_back(std::make_pair(root, s));
+          _rootStates[c].push_back(s);
         }
       }
+      assert(!_rootStates[c].empty());
     }
     else
     {
-      frontier.push_back(std::make_pair(root, rootState));
+      _rootStates[c].push_back(rootState);
     }
-    
-    IntNodeMap stateVector(_T.tree(), -1);
-    for (Node u : _T.leafSet())
+  }
+}
+
+Sankoff::SolutionIt::SolutionIt(const Sankoff& sankoff, int c)
+  : _sankoff(sankoff)
+  , _c(c)
+  , _state(sankoff._T.tree(), -1)
+  , _valid(false)
+{
+  const CharacterTree& T = _sankoff._T;
+  
+  for (Node u : T.leafSet())
+  {
+    _state[u] = T.state(u, c);
+  }
+  
+  const IntVector& rootStates = _sankoff._rootStates[c];
+  if (!rootStates.empty())
+  {
+    _state[T.root()] = rootStates.front();
+    reset(1);
+    _valid = true;
+  }
+}
+
+Sankoff::SolutionIt& Sankoff::SolutionIt::operator++()
+{
+  assert(_valid);
+  
+  // odometer: advance the last decision that has a next option
+  for (int p = _sankoff._decisionOrder.size() - 1; p >= 0; --p)
+  {
+    if (advance(p))
     {
-      stateVector[u] = _T.state(u, c);
+      reset(p + 1);
+      return *this;
     }
-    constructBackTrace(c, stateVector, frontier);
   }
   
-  updateHomoplasy();
+  _valid = false;
+  return *this;
 }
 
-void Sankoff::constructBackTrace(int c,
-                                 IntNodeMap& stateVector,
-                                 NodeStatePairList& frontier)
+bool Sankoff::SolutionIt::advance(int p)
 {
-  const Digraph& T = _T.tree();
+  const int i = _sankoff._decisionOrder[p];
+  const Node u = _sankoff._order[i];
+  const int s_u = _state[u];
   
-  if (frontier.empty())
+  if (p == 0)
   {
-    // report solution
-    IntNodeMap* pStateVector = new IntNodeMap(T, -1);
-    _stateVector[c].push_back(pStateVector);
-    _homoplasyVector[c].push_back(true);
-    
-    for (NodeIt w(_T.tree()); w != lemon::INVALID; ++w)
+    // root states are visited in increasing order
+    const IntVector& rootStates = _sankoff._rootStates[_c];
+    auto it = std::upper_bound(rootStates.begin(), rootStates.end(), s_u);
+    if (it == rootStates.end())
     {
-      assert(stateVector[w] >= 0);
-      pStateVector->set(w, stateVector[w]);
+      return false;
     }
+    _state[u] = *it;
+    return true;
   }
   else
   {
-    do
+    // remaining states are visited in decreasing order
+    const int s_parent = _state[_sankoff._order[_sankoff._parent[i]]];
+    for (int t = s_u - 1; t >= 0; --t)
     {
-      NodeStatePair vs = frontier.front();
-      stateVector[vs.first] = vs.second;
-      frontier.pop_front();
-      const Entry& entry_vs = entry(c, vs.first, vs.second);
-      
-      // remove elements from frontier with the same vertex v
-      NodeStatePairList newFrontier = frontier;
-      bool removed = false;
-      for (auto it = newFrontier.begin(); it != newFrontier.end();)
+      if (_sankoff.isOptimal(_c, i, s_parent, t))
       {
-        if (it->first == vs.first)
-        {
-          it = newFrontier.erase(it);
-          removed = true;
-        }
-        else
-        {
-          ++it;
-        }
+        _state[u] = t;
+        return true;
       }
-      
-      // add children and their options to frontier
-      for (const auto& wS : entry_vs._previousEntries)
+    }
+    return false;
+  }
+}
+
+void Sankoff::SolutionIt::reset(int p)
+{
+  const int nrDecisions = _sankoff._decisionOrder.size();
+  const int nrStates = _sankoff._T.getNrStates(_c);
+  
+  for (; p < nrDecisions; ++p)
+  {
+    const int i = _sankoff._decisionOrder[p];
+    const int s_parent = _state[_sankoff._order[_sankoff._parent[i]]];
+    
+    int t = nrStates - 1;
+    while (t >= 0 && !_sankoff.isOptimal(_c, i, s_parent, t))
+    {
+      --t;
+    }
+    assert(t >= 0);
+    _state[_sankoff._order[i]] = t;
+  }
+}
+
+void Sankoff::constructBackTrace(int c, Node u, int s)
+{
+  const int nrStates = _T.getNrStates(c);
+
+  (*_stateVector[c][0])[u] = s;
+
+  if (!_T.isLeaf(u))
+  {
+    const int i = _index[u];
+    for (int k = _childOffset[i]; k < _childOffset[i + 1]; ++k)
+    {
+      const int j = _children[k];
+
+      int t = 0;
+      while (t < nrStates && !isOptimal(c, j, s, t))
+      {
+        ++t;
+      }
+      assert(t < nrStates);
+
+      constructBackTrace(c, _order[j], t);
+    }
+  }
+}
+
+void Sankoff::solve(int c)
+{
+  const int n = _order.size();
+  const int nrStates = _T.getNrStates(c);
+  const int nrWords = _nrWords[c];
+
+  int* costs = _cost[c].data();
+  MaskWord* backPtr = _backPtr[c].data();
+  IntVector costs_vt(nrStates);
+
+  // nodes are in post-order, so children are solved before their parent
+  for (int i = 0; i < n; ++i)
+  {
+    Node u = _order[i];
+    int* costs_u = costs + i * nrStates;
+
+    if (_T.isLeaf(u))
+    {
+      const int state_u = _T.state(u, c);
+      for (int s = 0; s < nrStates; ++s)
       {
-        if (_T.isLeaf(wS.first)) continue;
-        for (int t : wS.second)
+        costs_u[s] = s == state_u ? 0 : _inf;
+      }
+      continue;
+    }
+
+    std::fill(costs_u, costs_u + nrStates, 0);
+    for (int k = _childOffset[i]; k < _childOffset[i + 1]; ++k)
+    {
+      // compute
+      // \sum_{v \in \delta_T(u)} \min_{t \in \Sigma} { c_{s,t} + M[v,t] }
+      const int j = _children[k];
+      const int* costs_v = costs + j * nrStates;
+
+      for (int s = 0; s < nrStates; ++s)
+      {
+        int minimum_cost = _inf;
+        for (int t = 0; t < nrStates; ++t)
         {
-          newFrontier.push_front(std::make_pair(wS.first, t));
+          costs_vt[t] = addCost(costs_v[t], transitionCost(c, s, t));
+          if (costs_vt[t] < minimum_cost)
+          {
+            minimum_cost = costs_vt[t];
+          }
+        }
+
+        // now update M[u][s] and the back pointers of v
+        costs_u[s] = addCost(costs_u[s], minimum_cost);
+
+        MaskWord* mask_vs = backPtr + (j * nrStates + s) * nrWords;
+        for (int t = 0; t < nrStates; ++t)
+        {
+          if (costs_vt[t] == minimum_cost)
+          {
+            mask_vs[t / _wordSize] |= MaskWord(1) << (t % _wordSize);
+          }
         }
       }
-      constructBackTrace(c, stateVector, newFrontier);
-      
-      if (!removed)
-        break;
-    } while (!frontier.empty());
+    }
   }
 }
 
-void Sankoff::constructBackTrace(int c, Node u, int s)
+Sankoff::BigInt Sankoff::countSolutions(int c) const
 {
-  const Digraph& T = _T.tree();
-  
-  (*_stateVector[c][0])[u] = s;
-  const Entry& entry_cus = entry(c, u, s);
+  const int n = _order.size();
+  const int nrStates = _T.getNrStates(c);
   
-  if (!_T.isLeaf(u))
+  // count[i * nrStates + s] is the number of optimal state assignments
+  // to the subtree rooted at i given that i has state s
+  std::vector<BigInt> count(n * nrStates, 0);
+  for (int i = 0; i < n; ++i)
   {
-    assert(!entry_cus._previousEntries.empty());
+    Node u = _order[i];
+    if (_T.isLeaf(u))
+    {
+      count[i * nrStates + _T.state(u, c)] = 1;
+      continue;
+    }
     
-    for (Digraph::OutArcIt a(T, u); a != lemon::INVALID; ++a)
+    for (int s = 0; s < nrStates; ++s)
     {
-      Node v = T.target(a);
-      assert(entry_cus._previousEntries.count(v) > 0);
-      
-      int t = *entry_cus._previousEntries.find(v)->second.begin();
-      constructBackTrace(c, v, t);
+      BigInt& count_us = count[i * nrStates + s];
+      count_us = 1;
+      for (int k = _childOffset[i]; k < _childOffset[i + 1] && count_us != 0; ++k)
+      {
+        const int j = _children[k];
+        BigInt sum = 0;
+        for (int t = 0; t < nrStates; ++t)
+        {
+          if (isOptimal(c, j, s, t))
+          {
+            sum += count[j * nrStates + t];
+          }
+        }
+        count_us *= sum;
+      }
     }
   }
+  
+  const int rootIdx = _index[_T.root()];
+  BigInt res = 0;
+  for (int s : _rootStates[c])
+  {
+    res += count[rootIdx * nrStates + s];
+  }
+  return res;
 }
 
-void Sankoff::run(int c, Node u)
+Sankoff::TransitionProfileCountMap Sankoff::countSolutionsByTransitionProfile(int c) const
 {
-  const Digraph& T = _T.tree();
+  const int n = _order.size();
   const int nrStates = _T.getNrStates(c);
+  const TransitionProfile empty(nrStates * nrStates, 0);
+  const int rootIdx = _index[_T.root()];
   
-  if (_T.isLeaf(u))
+  // only consider (node, state) pairs that occur in an optimal solution,
+  // parents precede their children in reverse post-order
+  BoolVector reachable(n * nrStates, false);
+  for (int s : _rootStates[c])
+  {
+    reachable[rootIdx * nrStates + s] = true;
+  }
+  for (int i = n - 1; i >= 0; --i)
   {
     for (int s = 0; s < nrStates; ++s)
     {
-      Entry& entry_cus = entry(c, u, s);
-      if (s == _T.state(u, c))
-      {
-        entry_cus._cost = 0;
-      }
-      else
+      if (!reachable[i * nrStates + s]) continue;
+      for (int k = _childOffset[i]; k < _childOffset[i + 1]; ++k)
       {
-        entry_cus._cost = std::numeric_limits<int>::max();
+        const int j = _children[k];
+        for (int t = 0; t < nrStates; ++t)
+        {
+          if (isOptimal(c, j, s, t))
+          {
+            reachable[j * nrStates + t] = true;
+          }
+        }
       }
     }
   }
-  else
+  
+  // table[i * nrStates + s] maps each transition profile of the subtree
+  // rooted at i given that i has state s to its number of optimal state
+  // assignments; tables of children are released once their parent is done
+  std::vector<TransitionProfileCountMap> table(n * nrStates);
+  for (int i = 0; i < n; ++i)
   {
-    // solve children
-    for (Digraph::OutArcIt a(T, u); a != lemon::INVALID; ++a)
+    Node u = _order[i];
+    if (_T.isLeaf(u))
     {
-      Node v = T.target(a);
-      run(c, v);
+      table[i * nrStates + _T.state(u, c)][empty] = 1;
+      continue;
     }
     
-    // compute _M[characterIndex][u][s]
     for (int s = 0; s < nrStates; ++s)
     {
-      Entry& entry_cus = entry(c, u, s);
-      entry_cus._cost = 0;
+      if (!reachable[i * nrStates + s]) continue;
+      
+      TransitionProfileCountMap table_us;
+      table_us[empty] = 1;
       
-      for (Digraph::OutArcIt a(T, u); a != lemon::INVALID; ++a)
+      for (int k = _childOffset[i]; k < _childOffset[i + 1] && !table_us.empty(); ++k)
       {
-        // compute
-        // \sum_{v \in \delta_T(u)} \min_{t \in \Sigma} { c_{s,t} + M[v,t] }
-        Node v = T.target(a);
+        const int j = _children[k];
         
-        int minimum_cost = std::numeric_limits<int>::max();
+        // 1. profiles of the subtree rooted at j including the arc (i, j)
+        TransitionProfileCountMap table_js;
         for (int t = 0; t < nrStates; ++t)
         {
-          int cost_vt = computeCost(c, u, s, v, t);
-          if (cost_vt < minimum_cost)
+          if (!isOptimal(c, j, s, t)) continue;
+          for (const auto& kv : table[j * nrStates + t])
           {
-            minimum_cost = cost_vt;
+            TransitionProfile profile = kv.first;
+            if (s != t)
+            {
+              int& multiplicity = profile[s * nrStates + t];
+              multiplicity = std::min(multiplicity + 1, 2);
+            }
+            table_js[profile] += kv.second;
           }
         }
         
-        // now update _M[characterIndex][u][s]
-        entry_cus._cost += minimum_cost;
-        
-        for (int t = 0; t < nrStates; ++t)
+        // 2. combine with the profiles of the previous children
+        TransitionProfileCountMap newTable_us;
+        for (const auto& kv1 : table_us)
         {
-          int cost_vt = computeCost(c, u, s, v, t);
-          if (cost_vt == minimum_cost)
+          for (const auto& kv2 : table_js)
           {
-            entry_cus._previousEntries[v].insert(t);
+            TransitionProfile profile = kv1.first;
+            for (int st = 0; st < nrStates * nrStates; ++st)
+            {
+              profile[st] = std::min(profile[st] + kv2.first[st], 2);
+            }
+            newTable_us[profile] += kv1.second * kv2.second;
           }
         }
+        table_us.swap(newTable_us);
+      }
+      table[i * nrStates + s].swap(table_us);
+    }
+    
+    for (int k = _childOffset[i]; k < _childOffset[i + 1]; ++k)
+    {
+      const int j = _children[k];
+      for (int t = 0; t < nrStates; ++t)
+      {
+        table[j * nrStates + t].clear();
       }
     }
   }
+  
+  TransitionProfileCountMap res;
+  for (int s : _rootStates[c])
+  {
+    for (const auto& kv : table[rootIdx * nrStates + s])
+    {
+      res[kv.first] += kv.second;
+    }
+  }
+  return res;
 }
 
 void Sankoff::write(int c, std::ostream& out) const
 {
   assert(0 <= c && c < _T.getNrCharacters());
-  
+
   const Digraph& T = _T.tree();
   const int nrStates = _T.getNrStates(c);
-  
+
   for (NodeIt u(T); u != lemon::INVALID; ++u)
   {
     out << _T.label(u);
     for (int s = 0; s < nrStates; ++s)
     {
-      out << "\t" << entry(c, u, s)._cost;
+      out << "\t" << cost(c, _index[u], s);
     }
     out << std::endl;
   }
-  
+
   for (NodeIt u(T); u != lemon::INVALID; ++u)
   {
+    const int i = _index[u];
     out << _T.label(u);
     for (int s = 0; s < nrStates; ++s)
     {
       out << "\t";
+      if (_T.isLeaf(u)) continue;
+
       bool first = true;
-      for (const auto& vt : entry(c, u, s)._previousEntries)
+      for (int k = _childOffset[i]; k < _childOffset[i + 1]; ++k)
       {
+        const int j = _children[k];
         if (first)
           first = false;
         else
           out << ",";
-        
-        out << "(" << _T.label(vt.first);
-        
-        const IntSet& states = vt.second;
-        for (int t : states)
+
+        out << "(" << _T.label(_order[j]);
+        for (int t = 0; t < nrStates; ++t)
         {
-          out << "," << t;
+          if (isOptimal(c, j, s, t))
+          {
+            out << "," << t;
+          }
         }
         out << ")";
       }
@@ -11,136 +11,259 @@
 #include "utils.h"
 #include "charactertree.h"
 #include "mpbase.h"
-#include <map>
+#include <cstdint>
+#include <limits>
+#include <boost/multiprecision/cpp_int.hpp>
 
 /// This class implements the Sankoff algorithm with an extension to
 /// enumerate all maximum parsimony solutions
 /// @brief This class implements the Sankoff algorithm
+///
+/// The dynamic programming table is stored in contiguous arrays.
+/// Costs are indexed by [node][state], where nodes are numbered in post-order.
+/// Back pointers are stored per child node v and parent state s as a bitmask
+/// over the states t of v that attain the minimum.
 class Sankoff : public MPBase
 {
 public:
+  /// Arbitrary precision integer
+  typedef boost::multiprecision::cpp_int BigInt;
+  /// State transition profile: entry s * nrStates + t denotes whether the
+  /// state change from s to t occurs zero, one or more than one (2) times
+  typedef IntVector TransitionProfile;
+  /// Number of solutions per state transition profile
+  typedef std::map<TransitionProfile, BigInt> TransitionProfileCountMap;
+  
   /// Constructor
   ///
   /// @param T Character-based tree T
   Sankoff(const CharacterTree& T);
-  
-  /// Destructor
-  virtual ~Sankoff()
-  {
-    int nrCharacters = _T.getNrCharacters();
-    for (int c = 0; c < nrCharacters; ++c)
-    {
-      delete _M[c];
-    }
-  }
-  
+
   /// Run the enumeration
   ///
   /// @param rootState Denotes the root state, when set to -1 all
   /// possible states are considered.
   void run(int rootState = -1);
   
+  /// Set the costs of state changes of the given character,
+  /// by default every state change has unit cost
+  ///
+  /// @param c Character
+  /// @param costs Non-negative costs, where costs[s][t] is the cost of
+  /// changing from state s to state t and costs[s][s] = 0
+  void setTransitionCosts(int c, const IntMatrix& costs);
+  
+  /// Run the dynamic programming without enumerating the solutions,
+  /// which can subsequently be enumerated lazily using SolutionIt
+  ///
+  /// @param rootState Denotes the root state, when set to -1 all
+  /// possible states are considered.
+  void computeCosts(int rootState = -1);
+
+  /// Return the minimum cost of the given character given the state
+  /// of the root, std::numeric_limits<int>::max() denotes that no
+  /// finite cost labeling exists. Requires computeCosts().
+  ///
+  /// @param c Character
+  /// @param rootState Root state
+  int getRootCost(int c, int rootState) const
+  {
+    return cost(c, _index[_T.root()], rootState);
+  }
+
+  /// Return the number of maximum parsimony solutions of the given
+  /// character without enumerating them. Requires computeCosts().
+  ///
+  /// @param c Character
+  BigInt countSolutions(int c) const;
+  
+  /// Return the number of maximum parsimony solutions of the given
+  /// character per state transition profile without enumerating them.
+  /// Requires computeCosts().
+  ///
+  /// @param c Character
+  TransitionProfileCountMap countSolutionsByTransitionProfile(int c) const;
+  
   /// Write the solution for the given character
   ///
   /// @param c Character
   /// @param out Output stream
   void write(int c, std::ostream& out) const;
   
-protected:
-  typedef std::pair<Digraph::Node, int> NodeStatePair;
-  typedef std::vector<NodeStatePair> NodeStatePairVector;
-  typedef std::map<Node, IntSet> NodeIntSetMap;
-
-  /// Dynamic programming entry
-  struct Entry {
-    /// Default constructor
-    Entry()
-      : _cost(std::numeric_limits<int>::max())
-      , _previousEntries()
+  /// This class enumerates the maximum parsimony solutions of a single
+  /// character one at a time, using memory linear in the size of the tree.
+  /// Solutions are visited in the same order as by run().
+  class SolutionIt
+  {
+  public:
+    /// Constructor
+    ///
+    /// @param sankoff Sankoff instance whose costs have been computed
+    /// @param c Character
+    SolutionIt(const Sankoff& sankoff, int c);
+    
+    /// Move to the next solution
+    SolutionIt& operator++();
+    
+    /// Return whether the iterator points to a solution
+    bool valid() const
     {
+      return _valid;
     }
     
-    /// Number of state changes
-    int _cost;
-    /// Previous entries
-    NodeIntSetMap _previousEntries;
+    /// Return the state of the given node in the current solution
+    ///
+    /// @param u Node
+    int state(Node u) const
+    {
+      return _state[u];
+    }
+    
+    /// Return the states of the current solution
+    const IntNodeMap& states() const
+    {
+      return _state;
+    }
+    
+  private:
+    /// Sankoff instance
+    const Sankoff& _sankoff;
+    /// Character
+    const int _c;
+    /// Current state of every node
+    IntNodeMap _state;
+    /// Indicates whether _state is a solution
+    bool _valid;
+    
+    /// Advance the decision at the given position to its next option
+    ///
+    /// @param p Position in decision order
+    bool advance(int p);
+    
+    /// Set the decisions at positions p and beyond to their first option
+    ///
+    /// @param p Position in decision order
+    void reset(int p);
   };
   
-  typedef std::vector<Entry> EntryVector;
-  typedef Digraph::NodeMap<EntryVector> EntryMatrix;
-  typedef std::vector<EntryMatrix*> CharacterTable;
-  
-  /// Dynamic programming table
-  CharacterTable _M;
-  
-  /// Solve for the given character and node
+protected:
+  typedef uint64_t MaskWord;
+  typedef std::vector<MaskWord> MaskWordVector;
+  typedef std::vector<MaskWordVector> MaskWordMatrix;
+
+  /// Number of bits per mask word
+  static const int _wordSize = 64;
+
+  /// Infinite cost
+  static const int _inf = std::numeric_limits<int>::max();
+
+  /// Nodes in post-order
+  NodeVector _order;
+  /// Post-order index of a node
+  IntNodeMap _index;
+  /// Offsets into _children, indexed by post-order index
+  IntVector _childOffset;
+  /// Post-order indices of the children of each node, sorted by node id
+  IntVector _children;
+  /// Post-order index of the parent of each node (-1 for the root)
+  IntVector _parent;
+  /// Post-order indices of the internal nodes in the order in which
+  /// their states are decided during enumeration (pre-order,
+  /// visiting children in decreasing node id)
+  IntVector _decisionOrder;
+  /// Character-specific optimal root states in increasing order
+  IntMatrix _rootStates;
+  /// Number of mask words per character
+  IntVector _nrWords;
+  /// Character-specific state change costs: _transitionCost[c][s * nrStates + t],
+  /// empty if unit costs are used
+  IntMatrix _transitionCost;
+  /// Character-specific cost array: _cost[c][i * nrStates + s]
+  IntMatrix _cost;
+  /// Character-specific back pointer masks:
+  /// _backPtr[c][(i * nrStates + s) * nrWords + w],
+  /// where i is the post-order index of a non-root node
+  /// and s is the state of its parent
+  MaskWordMatrix _backPtr;
+
+  /// Initialize post-order numbering, child arrays and decision order
+  void initOrder();
+
+  /// Solve for the given character
   ///
-  /// @param characterIndex Character
-  /// @param u Node
-  void run(int characterIndex, Node u);
-  
-  /// Return the dynamic programming entry corresponding to (c, u, s)
+  /// @param c Character
+  void solve(int c);
+
+  /// Return the cost of (c, i, s)
   ///
   /// @param c Character
-  /// @param u Node
+  /// @param i Post-order index of node
   /// @param s State
-  Entry& entry(int c, Node u, int s)
+  int cost(int c, int i, int s) const
   {
-    return (*_M[c])[u][s];
+    return _cost[c][i * _T.getNrStates(c) + s];
   }
 
-  /// Return the dynamic programming entry corresponding to (c, u, s)
+  /// Return the back pointer mask of child i given parent state s
   ///
   /// @param c Character
-  /// @param u Node
-  /// @param s State
-  const Entry& entry(int c, Node u, int s) const
+  /// @param i Post-order index of (child) node
+  /// @param s State of parent
+  const MaskWord* mask(int c, int i, int s) const
   {
-    return (*_M[c])[u][s];
+    return &_backPtr[c][(i * _T.getNrStates(c) + s) * _nrWords[c]];
   }
-  
-  /// Compute the cost of reaching (c, v, t) from (c, u, s)
+
+  /// Decide whether state t of child i is optimal given parent state s
+  ///
+  /// @param c Character
+  /// @param i Post-order index of (child) node
+  /// @param s State of parent
+  /// @param t State of child
+  bool isOptimal(int c, int i, int s, int t) const
+  {
+    return (mask(c, i, s)[t / _wordSize] >> (t % _wordSize)) & 1;
+  }
+
+  /// Return the cost of a state change from s to t
   ///
   /// @param c Character
-  /// @param u Node
   /// @param s State
-  /// @param v Node
   /// @param t State
-  int computeCost(int c, Node u, int s, Node v, int t) const
+  int transitionCost(int c, int s, int t) const
   {
-    int cost_vt = entry(c, v, t)._cost;
-    if (s != t)
+    if (_transitionCost[c].empty())
     {
-      if (cost_vt == std::numeric_limits<int>::max())
-      {
-        return cost_vt;
-      }
-      else
-      {
-        return cost_vt + 1;
-      }
+      return s == t ? 0 : 1;
     }
     else
     {
-      return cost_vt;
+      return _transitionCost[c][s * _T.getNrStates(c) + t];
     }
   }
-  
+
+  /// Return the sum of two costs, saturating at _inf
+  ///
+  /// @param a Cost
+  /// @param b Cost
+  static int addCost(int a, int b)
+  {
+    if (a == _inf || b == _inf || a > _inf - b)
+    {
+      return _inf;
+    }
+    else
+    {
+      return a + b;
+    }
+  }
+
   /// Construct a back trace from (c, u, s)
   ///
   /// @param c Character
   /// @param u Node
   /// @param s State
   void constructBackTrace(int c, Node u, int s);
-  
-  /// Construct all back traces
-  ///
-  /// @param c Character
-  /// @param stateVector Set of states
-  /// @param frontier Frontier of node state pairs leading to optimal solutions
-  void constructBackTrace(int c,
-                          IntNodeMap& stateVector,
-                          NodeStatePairList& frontier);
 };
 
 #endif // SANKOFF_H
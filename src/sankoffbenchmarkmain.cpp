@@ -0,0 +1,96 @@
+/*
+ * sankoffbenchmarkmain.cpp
+ *
+ *  Created on: 18-oct-2026
+ *      Author: M. El-Kebir
+ */
+
+#include "utils.h"
+#include "clonetree.h"
+#include "charactertree.h"
+#include "sankoff.h"
+#include <lemon/arg_parser.h>
+#include <lemon/time_measure.h>
+#include <fstream>
+
+int main(int argc, char** argv)
+{
+  int nrRepetitions = 100;
+
+  lemon::ArgParser ap(argc, argv);
+  ap.refOption("n", "Number of repetitions per instance (default: 100)", nrRepetitions)
+    .other("T", "Clone tree")
+    .other("leaf_labeling", "Leaf labeling (pairs of T and leaf_labeling may be repeated)");
+  ap.parse();
+
+  if (ap.files().empty() || ap.files().size() % 2 != 0)
+  {
+    std::cerr << "Error: pairs of <T> and <leaf_labeling> must be specified" << std::endl;
+    return 1;
+  }
+
+  std::cout << "T\tprimary\t|V(T)|\tm\tlabelings\ttime (ms)" << std::endl;
+
+  double totalTime = 0;
+  const int nrFiles = ap.files().size();
+  for (int i = 0; i < nrFiles; i += 2)
+  {
+    const std::string& filenameT = ap.files()[i];
+    std::ifstream inT(filenameT.c_str());
+    if (!inT.good())
+    {
+      std::cerr << "Could not open '" << filenameT << "' for reading" << std::endl;
+      return 1;
+    }
+
+    const std::string& filenameLabeling = ap.files()[i + 1];
+    std::ifstream inLabeling(filenameLabeling.c_str());
+    if (!inLabeling.good())
+    {
+      std::cerr << "Could not open '" << filenameLabeling << "' for reading" << std::endl;
+      return 1;
+    }
+
+    CloneTree T;
+    try
+    {
+      if (!T.read(inT)) return 1;
+      if (!T.readLeafLabeling(inLabeling)) return 1;
+    }
+    catch (std::runtime_error& e)
+    {
+      std::cerr << e.what() << std::endl;
+      return 1;
+    }
+
+    for (const std::string& primary : T.getAnatomicalSites())
+    {
+      StringVector stateToSample;
+      CharacterTree::StringToIntMap sampleToState;
+      CharacterTree charT(T, primary, stateToSample, sampleToState);
+
+      unsigned long long nrLabelings = 0;
+      lemon::Timer timer;
+      for (int r = 0; r < nrRepetitions; ++r)
+      {
+        Sankoff sankoff(charT);
+        sankoff.run(0);
+        nrLabelings = sankoff.getNrSolutions();
+      }
+      timer.stop();
+      totalTime += timer.realTime();
+
+      std::cout << filenameT << "\t"
+        << primary << "\t"
+        << lemon::countNodes(T.tree()) << "\t"
+        << T.getNrAnatomicalSites() << "\t"
+        << nrLabelings << "\t"
+        << 1000 * timer.realTime() / nrRepetitions
+        << std::endl;
+    }
+  }
+
+  std::cerr << "Total time: " << totalTime << " s" << std::endl;
+
+  return 0;
+}
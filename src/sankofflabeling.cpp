@@ -8,83 +8,276 @@
 #include "sankofflabeling.h"
 #include <fstream>
 
+void SankoffLabeling::setMigrationCosts(const StringPairToIntMap& migrationCosts)
+{
+  const int nrStates = _stateToSample.size();
+  
+  IntMatrix costs(nrStates, IntVector(nrStates, 1));
+  for (int s = 0; s < nrStates; ++s)
+  {
+    costs[s][s] = 0;
+  }
+  
+  for (const auto& kv : migrationCosts)
+  {
+    auto it_s = _sampleToState.find(kv.first.first);
+    auto it_t = _sampleToState.find(kv.first.second);
+    if (it_s != _sampleToState.end() && it_t != _sampleToState.end())
+    {
+      costs[it_s->second][it_t->second] = kv.second;
+    }
+  }
+  
+  _sankoff.setTransitionCosts(0, costs);
+}
+
+bool SankoffLabeling::readMigrationCosts(std::istream& in,
+                                         StringPairToIntMap& migrationCosts)
+{
+  migrationCosts.clear();
+  
+  while (in.good())
+  {
+    std::string line;
+    getline(in, line);
+    
+    if (line.empty())
+      continue;
+    
+    StringVector s;
+    boost::split(s, line, boost::is_any_of("\t "));
+    
+    if (s.size() != 3)
+    {
+      std::cerr << "Error: line '" << line << "' should be of the form '<source site> <target site> <cost>'" << std::endl;
+      return false;
+    }
+    
+    StringPair xy(s[0], s[1]);
+    if (xy.first == xy.second)
+    {
+      std::cerr << "Error: line '" << line << "' specifies a migration from an anatomical site to itself" << std::endl;
+      return false;
+    }
+    
+    if (migrationCosts.count(xy) != 0)
+    {
+      std::cerr << "Error: migration from '" << xy.first << "' to '" << xy.second << "' is already assigned a cost" << std::endl;
+      return false;
+    }
+    
+    int cost = boost::lexical_cast<int>(s[2]);
+    if (cost < 0)
+    {
+      std::cerr << "Error: migration from '" << xy.first << "' to '" << xy.second << "' has negative cost" << std::endl;
+      return false;
+    }
+    
+    migrationCosts[xy] = cost;
+  }
+  
+  return true;
+}
+
 void SankoffLabeling::run()
 {
   assert(_stateToSample[0] == _primary);
-  Sankoff sankoff(_charT);
-  sankoff.run(0);
+  _sankoff.computeCosts(0);
+
+  delete _pSolutionIt;
+  _pSolutionIt = new Sankoff::SolutionIt(_sankoff, 0);
+
+  if (valid())
+  {
+    updateLabeling();
+  }
+}
+
+bool SankoffLabeling::next()
+{
+  assert(valid());
+
+  ++(*_pSolutionIt);
+  if (valid())
+  {
+    updateLabeling();
+    return true;
+  }
+  else
+  {
+    return false;
+  }
+}
+
+void SankoffLabeling::initMappings()
+{
+  for (const std::string& sStr : _stateToSample)
+  {
+    _stateToSiteIndex.push_back(_T.anatomicalSiteToIndex(sStr));
+  }
   
-  do
+  for (NodeIt v(_charT.tree()); v != lemon::INVALID; ++v)
+  {
+    _charTToT[v] = _T.getNodeByLabel(_charT.label(v));
+    assert(_charTToT[v] != lemon::INVALID);
+  }
+}
+
+void SankoffLabeling::updateLabeling()
+{
+  for (NodeIt v(_charT.tree()); v != lemon::INVALID; ++v)
   {
-    StringNodeMap* pLabeling = new StringNodeMap(_T.tree());
-    for (NodeIt v(_charT.tree()); v != lemon::INVALID; ++v)
+    const Node vv = _charTToT[v];
+
+    const int s = _pSolutionIt->state(v);
+    assert(0 <= s && s < _stateToSample.size());
+
+    _labeling[vv] = _stateToSample[s];
+    _labelingIndex[vv] = _stateToSiteIndex[s];
+  }
+}
+
+SankoffLabeling::SeedingClassToBigIntMap SankoffLabeling::countLabelingsBySeedingClass() const
+{
+  const int nrStates = _stateToSample.size();
+  
+  SeedingClassToBigIntMap result;
+  for (const auto& kv : _sankoff.countSolutionsByTransitionProfile(0))
+  {
+    // the profile determines the migration graph up to
+    // arc multiplicities exceeding two
+    const Sankoff::TransitionProfile& profile = kv.first;
+    
+    Digraph G;
+    StringNodeMap id(G);
+    NodeVector stateToNode(nrStates, lemon::INVALID);
+    for (int s = 0; s < nrStates; ++s)
+    {
+      stateToNode[s] = G.addNode();
+      id[stateToNode[s]] = _stateToSample[s];
+    }
+    for (int s = 0; s < nrStates; ++s)
     {
-      const Node vv = _T.getNodeByLabel(_charT.label(v));
-      assert(vv != lemon::INVALID);
-      
-      const int s = sankoff.state(v, 0);
-      assert(0 <= s && s < _stateToSample.size());
-      
-      const std::string& sample = _stateToSample[s];
-      pLabeling->set(vv, sample);
+      for (int t = 0; t < nrStates; ++t)
+      {
+        for (int k = 0; k < profile[s * nrStates + t]; ++k)
+        {
+          G.addArc(stateToNode[s], stateToNode[t]);
+        }
+      }
     }
-    _mpLabelings.push_back(pLabeling);
-  } while (sankoff.nextSolution());
+    
+    MigrationGraph migrationGraph(G, stateToNode[0], id);
+    SeedingClass seedingClass = std::make_pair(migrationGraph.getNrSeedingSites(),
+                                               std::make_pair(migrationGraph.isMonoclonal(),
+                                                              static_cast<int>(migrationGraph.getPattern())));
+    result[seedingClass] += kv.second;
+  }
+  
+  return result;
 }
 
-void SankoffLabeling::run(const CloneTree& T,
-                          const std::string& primary,
-                          const std::string& outputDirectory,
-                          const StringToIntMap& colorMap)
+void SankoffLabeling::count(const CloneTree& T,
+                            const std::string& primary,
+                            const StringPairToIntMap& migrationCosts)
 {
   SankoffLabeling sankoff(T, primary);
-  
+  if (!migrationCosts.empty())
+  {
+    sankoff.setMigrationCosts(migrationCosts);
+  }
   sankoff.run();
-  const int nrLabelings = sankoff.getNrLabelings();
-  std::cerr << "Found " << nrLabelings << " maximum parsimony labelings with primary '" << primary << "'" << std::endl;
   
-  SankoffLabeling::IntTripleToIntMap result = sankoff.classify();
+  std::cerr << "Found " << sankoff.countLabelings() << " maximum parsimony labelings with primary '" << primary << "'" << std::endl;
+  
+  SeedingClassToBigIntMap result = sankoff.countLabelingsBySeedingClass();
   for (const auto& kv : result)
   {
-    MigrationGraph::Pattern pattern = static_cast<MigrationGraph::Pattern>(kv.first.second.second.second);
-    bool monoclonal = kv.first.second.second.first;
+    MigrationGraph::Pattern pattern = static_cast<MigrationGraph::Pattern>(kv.first.second.second);
+    bool monoclonal = kv.first.second.first;
     std::cerr << "Found " << kv.second
-      << " labelings with " << kv.first.first << " comigrations, "
-      << kv.first.second.first << " seeding sites and "
+      << " labelings with " << kv.first.first << " seeding sites and "
       << MigrationGraph::getPatternString(pattern, monoclonal)
       << std::endl;
   }
-  
+}
+
+void SankoffLabeling::run(const CloneTree& T,
+                          const std::string& primary,
+                          const std::string& outputDirectory,
+                          const StringToIntMap& colorMap,
+                          const StringPairToIntMap& migrationCosts,
+                          int limit)
+{
+  SankoffLabeling sankoff(T, primary);
+  if (!migrationCosts.empty())
+  {
+    sankoff.setMigrationCosts(migrationCosts);
+  }
+
+  IntTripleToIntMap result;
+
   char buf[1024];
-  for (int solIdx = 0; solIdx < nrLabelings; ++solIdx)
+  int solIdx = 0;
+  for (sankoff.run(); sankoff.valid() && (limit == -1 || solIdx < limit); sankoff.next(), ++solIdx)
   {
-    MigrationGraph G = sankoff.getMigrationGraph(solIdx);
+    const StringNodeMap& lPlus = sankoff.getLabeling();
+    MigrationGraph G = sankoff.getMigrationGraph();
+
+    IntTriple triple = sankoff.classify();
+    if (result.count(triple) == 0)
+    {
+      result[triple] = 1;
+    }
+    else
+    {
+      ++result[triple];
+    }
+
     std::cerr << "Labeling " << solIdx << ": "
       << G.getNrMigrations() << " migrations, "
-      << G.getNrComigrations(T, sankoff.getLabeling(solIdx)) << " comigrations, "
+      << triple.first << " comigrations, "
       << G.getNrSeedingSites() << " seeding sites and "
       << G.getPatternString(G.getPattern(), G.isMonoclonal());
     std::cerr << std::endl;
-    
+
     if (!outputDirectory.empty())
     {
       snprintf(buf, 1024, "%s/T-%s-%d.dot", outputDirectory.c_str(), primary.c_str(), solIdx);
       std::ofstream outT(buf);
-      T.writeDOT(outT, sankoff.getLabeling(solIdx), colorMap);
+      T.writeDOT(outT, lPlus, colorMap);
       outT.close();
-      
+
       snprintf(buf, 1024, "%s/G-%s-%d.dot", outputDirectory.c_str(), primary.c_str(), solIdx);
       std::ofstream outG(buf);
       G.writeDOT(outG, colorMap);
       outG.close();
-      
+
       snprintf(buf, 1024, "%s/T-%s-%d.labeling",
                outputDirectory.c_str(),
                primary.c_str(),
                solIdx);
       std::ofstream outLabeling(buf);
-      T.writeVertexLabeling(outLabeling, sankoff.getLabeling(solIdx));
+      T.writeVertexLabeling(outLabeling, lPlus);
       outLabeling.close();
     }
   }
+
+  std::cerr << "Found " << solIdx << " maximum parsimony labelings with primary '" << primary << "'";
+  if (sankoff.valid())
+  {
+    std::cerr << " (limit reached)";
+  }
+  std::cerr << std::endl;
+
+  for (const auto& kv : result)
+  {
+    MigrationGraph::Pattern pattern = static_cast<MigrationGraph::Pattern>(kv.first.second.second.second);
+    bool monoclonal = kv.first.second.second.first;
+    std::cerr << "Found " << kv.second
+      << " labelings with " << kv.first.first << " comigrations, "
+      << kv.first.second.first << " seeding sites and "
+      << MigrationGraph::getPatternString(pattern, monoclonal)
+      << std::endl;
+  }
 }
@@ -21,6 +21,11 @@ public:
   typedef Digraph::NodeMap<std::string> StringNodeMap;
   typedef std::pair<int, std::pair<int, std::pair<bool, int> > > IntTriple;
   typedef std::map<IntTriple, int> IntTripleToIntMap;
+  typedef std::map<StringPair, int> StringPairToIntMap;
+  typedef Sankoff::BigInt BigInt;
+  /// Seeding class: (sigma, (monoclonal, pattern))
+  typedef std::pair<int, std::pair<bool, int> > SeedingClass;
+  typedef std::map<SeedingClass, BigInt> SeedingClassToBigIntMap;
   
 public:
   /// Constructor
@@ -34,89 +39,132 @@ public:
     , _stateToSample()
     , _sampleToState()
     , _charT(_T, primary, _stateToSample, _sampleToState)
+    , _sankoff(_charT)
+    , _pSolutionIt(NULL)
+    , _labeling(_T.tree())
+    , _labelingIndex(_T.tree(), -1)
+    , _stateToSiteIndex()
+    , _charTToT(_charT.tree(), lemon::INVALID)
   {
+    initMappings();
   }
   
   /// Destructor
   ~SankoffLabeling()
   {
-    for (StringNodeMap* pLabeling : _mpLabelings)
-    {
-      delete pLabeling;
-    }
+    delete _pSolutionIt;
   }
   
-  /// Run the enumeration
+  /// Set the costs of migrations between anatomical sites,
+  /// migrations that are not specified have unit cost
+  ///
+  /// @param migrationCosts Cost of migrating from one anatomical site to another
+  void setMigrationCosts(const StringPairToIntMap& migrationCosts);
+  
+  /// Run the dynamic programming and move to the first labeling.
+  /// Labelings are enumerated lazily, one at a time.
   void run();
   
-  /// Return the number of labelings
-  int getNrLabelings() const
+  /// Return whether the current labeling is valid
+  bool valid() const
   {
-    return _mpLabelings.size();
+    return _pSolutionIt && _pSolutionIt->valid();
   }
   
-  /// Classify the results into (gamma, sigma, pattern) triples
-  IntTripleToIntMap classify() const
+  /// Move to the next labeling, returns false if there is none
+  bool next();
+  
+  /// Classify the current labeling into a (gamma, sigma, pattern) triple
+  IntTriple classify() const
   {
-    IntTripleToIntMap result;
+    assert(valid());
     
-    const int nrSolutions = getNrLabelings();
-    for (int solIdx = 0; solIdx < nrSolutions; ++solIdx)
-    {
-      MigrationGraph G(_T, getLabeling(solIdx));
-      int nrComigrations = G.getNrComigrations(_T, getLabeling(solIdx));
-      int nrSeedingSamples = G.getNrSeedingSites();
-      int migrationPattern = static_cast<int>(G.getPattern());
-      IntTriple triple = std::make_pair(nrComigrations,
-                                        std::make_pair(nrSeedingSamples,
-                                                       std::make_pair(G.isMonoclonal(),
-                                                                      migrationPattern)));
-      
-      if (result.count(triple) == 0)
-      {
-        result[triple] = 1;
-      }
-      else
-      {
-        ++result[triple];
-      }
-    }
-    
-    return result;
+    MigrationGraph G(_T, _labelingIndex);
+    int nrComigrations = G.getNrComigrations(_T, _labelingIndex);
+    int nrSeedingSamples = G.getNrSeedingSites();
+    int migrationPattern = static_cast<int>(G.getPattern());
+    return std::make_pair(nrComigrations,
+                          std::make_pair(nrSeedingSamples,
+                                         std::make_pair(G.isMonoclonal(),
+                                                        migrationPattern)));
   }
   
-  /// Return labeling corresponding to the given solution idnex
-  ///
-  /// @param solIdx Solution index
-  const StringNodeMap& getLabeling(int solIdx) const
+  /// Return the number of labelings without enumerating them.
+  /// Requires run().
+  BigInt countLabelings() const
   {
-    assert(0 <= solIdx && solIdx < _mpLabelings.size());
-    return *(_mpLabelings[solIdx]);
+    return _sankoff.countSolutions(0);
   }
   
-  /// Return migration graph corresponding to the given solution index
-  ///
-  /// @param solIdx Solution index
-  MigrationGraph getMigrationGraph(int solIdx) const
+  /// Return the number of labelings per seeding class
+  /// without enumerating them. Requires run().
+  SeedingClassToBigIntMap countLabelingsBySeedingClass() const;
+  
+  /// Return the current labeling
+  const StringNodeMap& getLabeling() const
   {
-    return MigrationGraph(_T, getLabeling(solIdx));
+    assert(valid());
+    return _labeling;
+  }
+  
+  /// Return the current labeling by anatomical site indices of T
+  const IntNodeMap& getIndexLabeling() const
+  {
+    assert(valid());
+    return _labelingIndex;
+  }
+  
+  /// Return migration graph corresponding to the current labeling
+  MigrationGraph getMigrationGraph() const
+  {
+    return MigrationGraph(_T, getIndexLabeling());
   }
   
   /// Run Sankoff enumeration algorithm to infer all vertex labelings
-  /// with minimum number of migrations
+  /// with minimum number of migrations. Labelings are written as they
+  /// are enumerated.
   ///
   /// @param T Clone tree
   /// @param primary Primary tumor label
   /// @param outputDirectory Output directory
   /// @param colorMap Color map
+  /// @param migrationCosts Migration costs (unit costs if empty)
+  /// @param limit Maximum number of labelings to enumerate (-1 if unlimited)
   static void run(const CloneTree& T,
                   const std::string& primary,
                   const std::string& outputDirectory,
-                  const StringToIntMap& colorMap);
+                  const StringToIntMap& colorMap,
+                  const StringPairToIntMap& migrationCosts,
+                  int limit = -1);
+  
+  /// Count all vertex labelings with minimum number of migrations
+  /// and classify them by number of seeding sites, clonality and
+  /// migration pattern without enumerating them
+  ///
+  /// @param T Clone tree
+  /// @param primary Primary tumor label
+  /// @param migrationCosts Migration costs (unit costs if empty)
+  static void count(const CloneTree& T,
+                    const std::string& primary,
+                    const StringPairToIntMap& migrationCosts);
+  
+  /// Read migration costs. Each line is of the form
+  /// '<source site> <target site> <cost>', where cost is a non-negative integer.
+  ///
+  /// @param in Input stream
+  /// @param migrationCosts Output migration costs
+  static bool readMigrationCosts(std::istream& in,
+                                 StringPairToIntMap& migrationCosts);
   
 private:
   typedef CharacterTree::StringToIntMap StringToIntMap;
-  typedef std::vector<StringNodeMap*> StringNodeMapVector;
+  
+  /// Initialize the mappings from states to anatomical site indices
+  /// and from nodes of _charT to nodes of _T
+  void initMappings();
+  
+  /// Update _labeling from the current solution
+  void updateLabeling();
   
 private:
   /// Clone tree
@@ -129,8 +177,18 @@ private:
   StringToIntMap _sampleToState;
   /// Character tree corresponding to _T
   const CharacterTree _charT;
-  /// Maximum parsimony (minimum migration) vertex labelings
-  StringNodeMapVector _mpLabelings;
+  /// Sankoff algorithm
+  Sankoff _sankoff;
+  /// Iterator over the maximum parsimony solutions
+  Sankoff::SolutionIt* _pSolutionIt;
+  /// Current maximum parsimony (minimum migration) vertex labeling
+  StringNodeMap _labeling;
+  /// Current vertex labeling by anatomical site indices of _T
+  IntNodeMap _labelingIndex;
+  /// Mapping from state to anatomical site index of _T
+  IntVector _stateToSiteIndex;
+  /// Mapping from nodes of _charT to nodes of _T
+  NodeNodeMap _charTToT;
 };
 
 #endif // SANKOFFLABELING_H
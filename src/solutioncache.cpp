@@ -0,0 +1,155 @@
+/*
+ * solutioncache.cpp
+ *
+ *  Created on: 18-oct-2026
+ *      Author: M. El-Kebir
+ */
+
+#include "solutioncache.h"
+#include <cstdio>
+#include <limits>
+#include <sstream>
+
+SolutionCache::SolutionCache(const std::string& directory,
+                             const std::string& problem)
+  : _directory(directory)
+  , _problem(problem)
+{
+}
+
+std::string SolutionCache::getKey(const CloneTree& T,
+                                  const std::string& primary,
+                                  MigrationGraph::Pattern pattern,
+                                  const IntTriple& bounds,
+                                  const StringPairList& forcedComigrations) const
+{
+  const Digraph& tree = T.tree();
+  
+  StringVector lines;
+  for (const StringPair& st : forcedComigrations)
+  {
+    lines.push_back("forced " + st.first + " " + st.second);
+  }
+  for (ArcIt a(tree); a != lemon::INVALID; ++a)
+  {
+    lines.push_back("edge " + T.label(tree.source(a)) + " " + T.label(tree.target(a)));
+  }
+  for (NodeIt u(tree); u != lemon::INVALID; ++u)
+  {
+    if (T.isLeaf(u))
+    {
+      lines.push_back("leaf " + T.label(u) + " " + T.l(u));
+    }
+  }
+  std::sort(lines.begin(), lines.end());
+  
+  std::stringstream ss;
+  ss << "problem " << _problem << std::endl
+     << "primary " << primary << std::endl
+     << "pattern " << MigrationGraph::getPatternString(pattern) << std::endl
+     << "bounds " << bounds.first << " " << bounds.second.first << " " << bounds.second.second << std::endl;
+  for (const std::string& line : lines)
+  {
+    ss << line << std::endl;
+  }
+  
+  return ss.str();
+}
+
+unsigned long long SolutionCache::hash(const std::string& str)
+{
+  unsigned long long res = 14695981039346656037ULL;
+  for (unsigned char c : str)
+  {
+    res ^= c;
+    res *= 1099511628211ULL;
+  }
+  return res;
+}
+
+std::string SolutionCache::getFilename(const std::string& key) const
+{
+  char buf[1024];
+  snprintf(buf, 1024, "%s/%016llx.txt", _directory.c_str(), hash(key));
+  return buf;
+}
+
+bool SolutionCache::lookup(const std::string& key,
+                           Entry& entry) const
+{
+  std::ifstream in(getFilename(key).c_str());
+  if (!in.good())
+  {
+    return false;
+  }
+  
+  // the stored key must match, as different keys may have the same hash
+  std::string storedKey;
+  std::string line;
+  while (getline(in, line) && line != "#solution")
+  {
+    storedKey += line + "\n";
+  }
+  if (storedKey != key)
+  {
+    return false;
+  }
+  
+  if (!getline(in, line))
+  {
+    return false;
+  }
+  std::stringstream ss(line);
+  ss >> entry._mu >> entry._gamma >> entry._sigma >> entry._pattern >> entry._LB >> entry._UB;
+  if (ss.fail())
+  {
+    return false;
+  }
+  
+  std::string* pSection = NULL;
+  entry._tree.clear();
+  entry._leafLabeling.clear();
+  entry._vertexLabeling.clear();
+  while (getline(in, line))
+  {
+    if (line == "#tree")
+      pSection = &entry._tree;
+    else if (line == "#leafLabeling")
+      pSection = &entry._leafLabeling;
+    else if (line == "#vertexLabeling")
+      pSection = &entry._vertexLabeling;
+    else if (pSection)
+      *pSection += line + "\n";
+    else
+      return false;
+  }
+  
+  return !entry._tree.empty() && !entry._vertexLabeling.empty();
+}
+
+bool SolutionCache::store(const std::string& key,
+                          const Entry& entry) const
+{
+  const std::string filename = getFilename(key);
+  AtomicOfstream out(filename);
+  if (!out.good())
+  {
+    std::cerr << "Warning: could not write cache entry '" << filename << "'" << std::endl;
+    return false;
+  }
+  
+  out.precision(std::numeric_limits<double>::max_digits10);
+  out << key
+      << "#solution" << std::endl
+      << entry._mu << " " << entry._gamma << " " << entry._sigma << " "
+      << entry._pattern << " " << entry._LB << " " << entry._UB << std::endl
+      << "#tree" << std::endl
+      << entry._tree
+      << "#leafLabeling" << std::endl
+      << entry._leafLabeling
+      << "#vertexLabeling" << std::endl
+      << entry._vertexLabeling;
+  out.close();
+  
+  return true;
+}
@@ -0,0 +1,119 @@
+/*
+ * solutioncache.h
+ *
+ *  Created on: 18-oct-2026
+ *      Author: M. El-Kebir
+ */
+
+#ifndef SOLUTIONCACHE_H
+#define SOLUTIONCACHE_H
+
+#include "utils.h"
+#include "clonetree.h"
+#include "migrationgraph.h"
+
+/// This class implements a persistent on-disk cache of optimal PMH solutions.
+/// Every solution is stored in its own file in the cache directory, named
+/// after the hash of the canonical key of the instance. Entries are written
+/// to a temporary file that is renamed afterwards, such that concurrent
+/// processes sharing the cache directory never observe partially written
+/// entries and no locking is needed.
+///
+/// \brief On-disk cache of PMH solutions
+class SolutionCache
+{
+public:
+  /// Cached solution
+  struct Entry
+  {
+    /// Default constructor
+    Entry()
+      : _mu(-1)
+      , _gamma(-1)
+      , _sigma(-1)
+      , _pattern()
+      , _LB(-1)
+      , _UB(-1)
+      , _tree()
+      , _leafLabeling()
+      , _vertexLabeling()
+    {
+    }
+    
+    /// Migration number
+    int _mu;
+    /// Comigration number
+    int _gamma;
+    /// Seeding site number
+    int _sigma;
+    /// Migration pattern of the solution
+    std::string _pattern;
+    /// Lower bound
+    double _LB;
+    /// Upper bound
+    double _UB;
+    /// Edge list of the (refined) clone tree
+    std::string _tree;
+    /// Leaf labeling of the (refined) clone tree
+    std::string _leafLabeling;
+    /// Vertex labeling of the (refined) clone tree
+    std::string _vertexLabeling;
+  };
+  
+  /// Constructor
+  ///
+  /// @param directory Cache directory, which must exist
+  /// @param problem Problem identifier, solutions of different problems
+  /// (e.g. pmh and pmh_tr) are cached separately
+  SolutionCache(const std::string& directory,
+                const std::string& problem);
+  
+  /// Return the canonical key of an instance, which does not depend on the
+  /// order of the edges and leaves in the input files
+  ///
+  /// @param T Clone tree
+  /// @param primary Primary tumor
+  /// @param pattern Topological constraint
+  /// @param bounds Upper bounds on mu, gamma and sigma
+  /// @param forcedComigrations List of ordered pairs of anatomical sites
+  /// that must be present
+  std::string getKey(const CloneTree& T,
+                     const std::string& primary,
+                     MigrationGraph::Pattern pattern,
+                     const IntTriple& bounds,
+                     const StringPairList& forcedComigrations) const;
+  
+  /// Look up the solution of the given key, returns false on a cache miss
+  ///
+  /// @param key Canonical key
+  /// @param entry Cached solution
+  bool lookup(const std::string& key,
+              Entry& entry) const;
+  
+  /// Store the solution of the given key, returns false if the entry
+  /// could not be written
+  ///
+  /// @param key Canonical key
+  /// @param entry Solution
+  bool store(const std::string& key,
+             const Entry& entry) const;
+  
+  /// Return the 64-bit FNV-1a hash of the given string
+  ///
+  /// @param str String
+  static unsigned long long hash(const std::string& str);
+
+private:
+  /// Return the filename of the entry of the given key
+  ///
+  /// @param key Canonical key
+  std::string getFilename(const std::string& key) const;
+
+private:
+  /// Cache directory
+  const std::string _directory;
+  /// Problem identifier
+  const std::string _problem;
+};
+
+#endif // SOLUTIONCACHE_H
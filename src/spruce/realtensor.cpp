@@ -17,26 +17,43 @@ RealTensor::RealTensor()
   
 RealTensor::RealTensor(int k, int m, int n)
   : Tensor(k, m, n)
-  , _C(k, DoubleMatrix(m, DoubleVector(n, 0)))
+  , _C(k * m * n, 0)
   , _trackChanges(false)
   , _deltas()
 {
 }
   
+DoubleTensor RealTensor::getTensor() const
+{
+  DoubleTensor res(_k, DoubleMatrix(_m, DoubleVector(_n, 0)));
+  for (int i = 0; i < _k; ++i)
+  {
+    for (int p = 0; p < _m; ++p)
+    {
+      for (int c = 0; c < _n; ++c)
+      {
+        res[i][p][c] = (*this)(i, p, c);
+      }
+    }
+  }
+  return res;
+}
+  
 void RealTensor::rollBack()
 {
-  for (DeltaListRevIt it = _deltas.rbegin(); it != _deltas.rend(); ++it)
+  for (DeltaVectorRevIt it = _deltas.rbegin(); it != _deltas.rend(); ++it)
   {
     const Delta& d = *it;
-    _C[d._i][d._p][d._c] = d._value;
+    _C[d._idx] = d._value;
   }
+  // keeps the capacity, such that subsequent changes do not allocate
   _deltas.clear();
 }
   
 std::ostream& operator<<(std::ostream& out,
                          const RealTensor& tensor)
 {
-  out << tensor._C;
+  out << tensor.getTensor();
   if (tensor._labelsSet)
   {
     out << std::endl;
@@ -59,14 +76,27 @@ std::ostream& operator<<(std::ostream& out,
 std::istream& operator>>(std::istream& in,
                          RealTensor& tensor)
 {
-  in >> tensor._C;
+  DoubleTensor C;
+  in >> C;
   
-  tensor._k = tensor._C.size();
-  tensor._m = tensor._k == 0 ? 0 : tensor._C.front().size();
-  tensor._n = tensor._m == 0 ? 0 : tensor._C.front().front().size();
+  tensor._k = C.size();
+  tensor._m = tensor._k == 0 ? 0 : C.front().size();
+  tensor._n = tensor._m == 0 ? 0 : C.front().front().size();
   tensor._rowLabel.resize(tensor._m);
   tensor._colLabel.resize(tensor._n);
   
+  tensor._C.assign(tensor._k * tensor._m * tensor._n, 0);
+  for (int i = 0; i < tensor._k; ++i)
+  {
+    for (int p = 0; p < tensor._m; ++p)
+    {
+      for (int c = 0; c < tensor._n; ++c)
+      {
+        tensor._C[tensor.index(i, p, c)] = C[i][p][c];
+      }
+    }
+  }
+  
   return in;
 }
   
@@ -86,7 +116,7 @@ RealTensor RealTensor::subTensor(const IntVector& columns) const
     {
       for (int p = 0; p < _m; ++p)
       {
-        res._C[i][p][c] = _C[i][p][cc];
+        res._C[res.index(i, p, c)] = (*this)(i, p, cc);
       }
     }
   }
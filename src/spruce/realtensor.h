@@ -10,7 +10,6 @@
 
 #include "tensor.h"
 #include "utils.h"
-#include <list>
 
 class RealTensor : public Tensor
 {
@@ -19,39 +18,46 @@ public:
   
   RealTensor(int k, int m, int n);
   
-  const DoubleTensor& getTensor() const
-  {
-    return _C;
-  }
+  DoubleTensor getTensor() const;
   
   double operator()(int slice, int row, int col) const
   {
-    assert(0 <= slice && slice < _k);
-    assert(0 <= row && row < _m);
-    assert(0 <= col && col < _n);
+    return _C[index(slice, row, col)];
+  }
     
-    return _C[slice][row][col];
+  // entries of all rows of the given slice and column, stored contiguously
+  const double* row(int slice, int col) const
+  {
+    return &_C[index(slice, 0, col)];
   }
   
   void set(int slice, int row, int col, double val)
   {
-    assert(0 <= slice && slice < _k);
-    assert(0 <= row && row < _m);
-    assert(0 <= col && col < _n);
-    
-    if (_C[slice][row][col] != val)
+    const int idx = index(slice, row, col);
+    if (_C[idx] != val)
     {
       if (_trackChanges)
       {
-        Delta d;
-        d._i = slice;
-        d._p = row;
-        d._c = col;
-        d._value = _C[slice][row][col];
+        _deltas.push_back(Delta(idx, _C[idx]));
+      }
+      _C[idx] = val;
+    }
+  }
         
-        _deltas.push_back(d);
+  // set rows rowBegin ... rowEnd-1 of the given slice and column to values
+  void set(int slice, int rowBegin, int rowEnd, int col, const double* values)
+  {
+    const int idx = index(slice, rowBegin, col);
+    for (int p = 0; p < rowEnd - rowBegin; ++p)
+    {
+      if (_C[idx + p] != values[p])
+      {
+        if (_trackChanges)
+        {
+          _deltas.push_back(Delta(idx + p, _C[idx + p]));
+        }
+        _C[idx + p] = values[p];
       }
-      _C[slice][row][col] = val;
     }
   }
   
@@ -65,6 +71,21 @@ public:
     return res;
   }
   
+  // set cumFreq[p-rowBegin] to getCumFreq(p, c, D) for rows rowBegin ... rowEnd-1
+  void getCumFreq(int rowBegin, int rowEnd, int c, const IntSet& D, double* cumFreq) const
+  {
+    const int size = rowEnd - rowBegin;
+    std::fill(cumFreq, cumFreq + size, 0.);
+    for (IntSetIt it = D.begin(); it != D.end(); ++it)
+    {
+      const double* F_i = row(*it, c) + rowBegin;
+      for (int p = 0; p < size; ++p)
+      {
+        cumFreq[p] += F_i[p];
+      }
+    }
+  }
+  
   bool operator==(const RealTensor& other) const
   {
     return _k == other._k && _m == other._m
@@ -97,22 +118,36 @@ public:
   void rollBack();
   
 protected:
-  DoubleTensor _C;
+  int index(int slice, int row, int col) const
+  {
+    assert(0 <= slice && slice < _k);
+    assert(0 <= row && row < _m);
+    assert(0 <= col && col < _n);
+    
+    return (slice * _n + col) * _m + row;
+  }
+  
+  // entry (slice, row, col) is stored at index(slice, row, col),
+  // such that the rows of a slice and column are contiguous
+  DoubleVector _C;
   bool _trackChanges;
   
   struct Delta
   {
-    int _p;
-    int _c;
-    int _i;
+    Delta(int idx, double value)
+      : _idx(idx)
+      , _value(value)
+    {
+    }
+    
+    int _idx;
     double _value;
   };
   
-  typedef std::list<Delta> DeltaList;
-  typedef DeltaList::const_iterator DeltaListIt;
-  typedef DeltaList::const_reverse_iterator DeltaListRevIt;
+  typedef std::vector<Delta> DeltaVector;
+  typedef DeltaVector::const_reverse_iterator DeltaVectorRevIt;
   
-  DeltaList _deltas;
+  DeltaVector _deltas;
 };
 
 #endif // REALTENSOR_H
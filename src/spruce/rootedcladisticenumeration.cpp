@@ -20,15 +20,27 @@ RootedCladisticEnumeration::RootedCladisticEnumeration(const RootedCladisticAnce
                                                        const IntSet& whiteList)
   : _G(G)
   , _result()
+  , _resultSize(0)
+  , _pSink(NULL)
+  , _sinkSize(0)
+  , _sinkCount(0)
   , _objectiveValue(0)
   , _limit(limit)
   , _timeLimit(timeLimit)
   , _threads(threads)
   , _lowerbound(lowerbound)
   , _counter(0)
+  , _limitReached(false)
   , _mutex()
-  , _sem(threads)
   , _threadGroup()
+  , _workers()
+  , _workspace()
+  , _pWorkerIdx()
+  , _nrPending(0)
+  , _nrQueued(0)
+  , _nrIdle(0)
+  , _idleMutex()
+  , _idleCondition()
   , _timer()
   , _monoclonal(monoclonal)
   , _fixTrunk(fixTrunk)
@@ -42,29 +54,12 @@ RootedCladisticEnumeration::~RootedCladisticEnumeration()
 
 std::string RootedCladisticEnumeration::newick(int solIdx) const
 {
-  assert(0 <= solIdx && solIdx < _result.size());
-  
-  ArcListList::const_iterator it = _result.begin();
-  int tmp = solIdx;
-  for (; tmp > 0; tmp--) ++it;
-  
-  const ArcList& L = *it;
   const Digraph& G = _G.G();
   
   BoolNodeMap filterNodesT(G, false);
   BoolArcMap filterArcsT(G, false);
   SubDigraph T(G, filterNodesT, filterArcsT);
-  
-  for (ArcListIt it = L.begin(); it != L.end(); ++it)
-  {
-    Arc a_cidj = *it;
-    Node v_ci = G.source(a_cidj);
-    Node v_dj = G.target(a_cidj);
-    
-    T.enable(a_cidj);
-    T.enable(v_ci);
-    T.enable(v_dj);
-  }
+  getTree(solIdx, T);
   
   std::string str = "[";
   newick(T, _G.root(), str);
@@ -100,98 +95,163 @@ void RootedCladisticEnumeration::newick(const SubDigraph& T,
 }
   
 bool RootedCladisticEnumeration::prune(const SubDigraph& T,
-                                       const ArcList& F) const
+                                       int begin,
+                                       int end) const
 {
-  int size_L = 0;
-  {
-    boost::interprocess::scoped_lock<boost::mutex> lock(_mutex);
-    size_L = _lowerbound;
-  }
+  const int size_L = _lowerbound;
   
   const Digraph& G = _G.G();
-  BoolNodeMap filterNodesTT(G, true);
-  BoolArcMap filterArcsTT(G, true);
+  const Node root = _G.root();
+  const int n = _G.F().n();
+  const int k = _G.F().k();
   
-  SubDigraph TT(G, filterNodesTT, filterArcsTT);
+  Workspace& ws = workspace();
+  const ArcVector& F = ws._frontier;
   
-  // Remove arcs incoming to vertices in T and F
-  BoolArcMap whiteList(G, false);  // these are arcs that occur in F, and need to be retained in TT
-  BoolNodeMap blackList(G, false); // these are nodes that are the target nodes of an arc in F
-  for (ArcListIt it = F.begin(); it != F.end(); ++it)
+  // Consider the subgraph TT of G without the arcs that are not in T and F,
+  // but either leave a vertex of T or enter a target vertex of F.
+  // Every vertex of T is reached from the root via the arcs of T,
+  // so the BFS only needs to start from the targets of F.
+  ws._queue.clear();
+  std::fill(ws._alive.begin(), ws._alive.end(), false);
+  for (int i = begin; i < end; ++i)
   {
-    Arc a_cidj = *it;
-    whiteList[a_cidj] = true;
-    
-    Node v_dj = G.target(a_cidj);
-    blackList[v_dj] = true;
+    const Arc a_cidj = F[i];
+    const Node v_dj = G.target(a_cidj);
+    ws._inF[G.id(a_cidj)] = true;
+    if (!ws._targetF[G.id(v_dj)])
+    {
+      ws._targetF[G.id(v_dj)] = true;
+      ws._alive[G.id(v_dj)] = true;
+      ws._queue.push_back(v_dj);
+    }
   }
-  
+  for (int idx = 0; idx < ws._queue.size(); ++idx)
+  {
+    const Node v_ci = ws._queue[idx];
+    assert(!T.status(v_ci));
+    for (OutArcIt a_cidj(G, v_ci); a_cidj != lemon::INVALID; ++a_cidj)
+    {
+      const Node v_dj = G.target(a_cidj);
+      if (!ws._alive[G.id(v_dj)] && !ws._targetF[G.id(v_dj)] && !T.status(v_dj))
+      {
+        ws._alive[G.id(v_dj)] = true;
+        ws._queue.push_back(v_dj);
+      }
+    }
+  }
+
   // determine set C of characters present in the tree (disregarding root)
-  IntSet C = _whiteList; // initialize to whitelist, these characters must be present in the tree
+  std::fill(ws._inC.begin(), ws._inC.end(), false);
+  for (int c : _whiteList)
+  {
+    // initialize to whitelist, these characters must be present in the tree
+    ws._inC[c] = true;
+  }
   for (SubNodeIt v_ci(T); v_ci != lemon::INVALID; ++v_ci)
   {
-    if (v_ci != _G.root())
+    ws._alive[G.id(v_ci)] = true;
+    if (v_ci != root)
     {
       for (const IntPair& ci : _G.nodeToCharState(v_ci))
       {
-        C.insert(ci.first);
+        ws._inC[ci.first] = true;
       }
     }
   }
-
-  //
-  for (ArcIt a_cidj(G); a_cidj != lemon::INVALID; ++a_cidj)
+  
+  bool res = false;
+  int size_TT = 0;
+  while (true)
   {
-    // retain arcs in T and F
-    if (T.status(a_cidj) || whiteList[a_cidj])
-      continue;
-    
-    Node v_ci = G.source(a_cidj);
-    Node v_dj = G.target(a_cidj);
+    size_TT = 0;
+    for (int c = 0; c < n; ++c)
+    {
+      bool complete = true;
+      for (int i = 1; i < k && complete; ++i)
+      {
+        complete = !_G.S(c).isPresent(i) || ws._alive[G.id(_G.charStateToNode(c, i))];
+      }
+      ws._complete[c] = complete;
+      if (complete)
+        ++size_TT;
+    }
+  
+    // check if there is a character that is state incomplete
+    for (int c = 0; c < n && !res; ++c)
+    {
+      res = ws._inC[c] && !ws._complete[c];
+    }
+    if (res)
+      break;
     
-    // pre: a_cidj not in F
-    // pre: a_cidj not in T
-    if (T.status(v_ci))
+    // make TT state complete by removing vertices without a state complete character,
+    // this does not affect the state complete characters
+    bool nodeRemoved = false;
+    for (NodeIt v_ci(G); v_ci != lemon::INVALID; ++v_ci)
     {
-      // disable arcs incoming to vertices in T
-      TT.disable(a_cidj);
+      if (v_ci == root || !ws._alive[G.id(v_ci)])
+        continue;
+      
+      bool somethingStateComplete_v_ci = false;
+      for (const IntPair& ci : _G.nodeToCharState(v_ci))
+      {
+        somethingStateComplete_v_ci = somethingStateComplete_v_ci || ws._complete[ci.first];
+      }
+      
+      if (!somethingStateComplete_v_ci)
+      {
+        ws._alive[G.id(v_ci)] = false;
+        nodeRemoved = true;
+      }
     }
-    if (blackList[v_dj])
+    if (!nodeRemoved)
+      break;
+    
+    // vertices that are no longer reachable from the root are removed too,
+    // which may break state-completeness of other characters
+    std::fill(ws._reached.begin(), ws._reached.end(), false);
+    ws._queue.clear();
+    ws._reached[G.id(root)] = true;
+    ws._queue.push_back(root);
+    for (int idx = 0; idx < ws._queue.size(); ++idx)
     {
-      // disable arcs incoming to target vertices in F
-      TT.disable(a_cidj);
+      const Node v_ci = ws._queue[idx];
+      for (OutArcIt a_cidj(G, v_ci); a_cidj != lemon::INVALID; ++a_cidj)
+      {
+        const Node v_dj = G.target(a_cidj);
+        if (ws._reached[G.id(v_dj)] || !ws._alive[G.id(v_dj)])
+          continue;
+        
+        if (T.status(a_cidj) || ws._inF[G.id(a_cidj)]
+            || (!T.status(v_ci) && !ws._targetF[G.id(v_dj)]))
+        {
+          ws._reached[G.id(v_dj)] = true;
+          ws._queue.push_back(v_dj);
+        }
+      }
     }
-  }
-  
-  // now do a BFS in TT
-  assert(TT.status(_G.root()));
-  lemon::Bfs<SubDigraph> bfs(TT);
-  bfs.run(_G.root());
-  
-  for (NodeIt v_ci(_G.G()); v_ci != lemon::INVALID; ++v_ci)
-  {
-    if (!bfs.reached(v_ci))
-      TT.disable(v_ci);
-  }
-  
-  // check if there is a character that is state incomplete
-  for (IntSetIt it = C.begin(); it != C.end(); ++it)
-  {
-    int c = *it;
-    if (!isStateComplete(TT, c))
+    
+    nodeRemoved = false;
+    for (NodeIt v_ci(G); v_ci != lemon::INVALID; ++v_ci)
     {
-      return true;
+      if (ws._alive[G.id(v_ci)] && !ws._reached[G.id(v_ci)])
+      {
+        ws._alive[G.id(v_ci)] = false;
+        nodeRemoved = true;
+      }
     }
+    if (!nodeRemoved)
+      break;
   }
   
-  int size_TT = makeStateComplete(TT);
-  if (size_TT < size_L)
+  for (int i = begin; i < end; ++i)
   {
-//    std::cout << "TT: " << size_TT << ", L: " << size_L << ", F: " << F.size() << std::endl;
-    return true;
+    ws._inF[G.id(F[i])] = false;
+    ws._targetF[G.id(G.target(F[i]))] = false;
   }
   
-  return false;
+  return res || size_TT < size_L;
 }
   
 void RootedCladisticEnumeration::init(Arc a_00dj,
@@ -266,9 +326,9 @@ void RootedCladisticEnumeration::init(SubDigraph& subG,
   F.sort(Compare(_G));
 }
   
-void RootedCladisticEnumeration::runArc(Arc a_00dj)
+void RootedCladisticEnumeration::initTask(Arc a_00dj,
+                                          Task& task)
 {
-  _sem.wait();
   const Digraph& G = _G.G();
   
   BoolNodeMap filterNodesT(G, false);
@@ -282,13 +342,226 @@ void RootedCladisticEnumeration::runArc(Arc a_00dj)
   ArcList F;
   
   init(a_00dj, subG, T, F);
-  grow(subG, T, F);
+  snapshot(subG, T, lemon::INVALID, task);
+  task._F.assign(F.begin(), F.end());
+}
   
-//  for (int idx = 0; idx < _result.size(); ++idx)
-//  {
-//    std::cerr << newick(idx) << " " << idx << std::endl;
-//  }
-  _sem.post();
+void RootedCladisticEnumeration::runTask(Task& task)
+{
+  const Digraph& G = _G.G();
+  
+  BoolNodeMap filterNodesT(G, false);
+  BoolArcMap filterArcsT(G, false);
+  SubDigraph T(G, filterNodesT, filterArcsT);
+  
+  BoolNodeMap filterNodesG(G, true);
+  BoolArcMap filterArcsG(G, true);
+  SubDigraph subG(G, filterNodesG, filterArcsG);
+  
+  restore(task, subG, T);
+  
+  ArcVector& F = workspace()._frontier;
+  F.assign(task._F.begin(), task._F.end());
+  if (task._a == lemon::INVALID)
+  {
+    grow(subG, T, 0);
+  }
+  else
+  {
+    branch(subG, T, 0, F.size(), task._a);
+  }
+}
+  
+void RootedCladisticEnumeration::snapshot(const SubDigraph& subG,
+                                          const SubDigraph& T,
+                                          Arc a_cidj,
+                                          Task& task) const
+{
+  const Digraph& G = _G.G();
+  
+  task._a = a_cidj;
+  task._nodesG.assign(G.maxNodeId() + 1, false);
+  task._nodesT.assign(G.maxNodeId() + 1, false);
+  for (NodeIt v_ci(G); v_ci != lemon::INVALID; ++v_ci)
+  {
+    task._nodesG[G.id(v_ci)] = subG.status(v_ci);
+    task._nodesT[G.id(v_ci)] = T.status(v_ci);
+  }
+  task._arcsG.assign(G.maxArcId() + 1, false);
+  task._arcsT.assign(G.maxArcId() + 1, false);
+  for (ArcIt a_cidj(G); a_cidj != lemon::INVALID; ++a_cidj)
+  {
+    task._arcsG[G.id(a_cidj)] = subG.status(a_cidj);
+    task._arcsT[G.id(a_cidj)] = T.status(a_cidj);
+  }
+}
+  
+void RootedCladisticEnumeration::restore(const Task& task,
+                                         SubDigraph& subG,
+                                         SubDigraph& T) const
+{
+  const Digraph& G = _G.G();
+  
+  for (NodeIt v_ci(G); v_ci != lemon::INVALID; ++v_ci)
+  {
+    subG.status(v_ci, task._nodesG[G.id(v_ci)]);
+    T.status(v_ci, task._nodesT[G.id(v_ci)]);
+  }
+  for (ArcIt a_cidj(G); a_cidj != lemon::INVALID; ++a_cidj)
+  {
+    subG.status(a_cidj, task._arcsG[G.id(a_cidj)]);
+    T.status(a_cidj, task._arcsT[G.id(a_cidj)]);
+  }
+}
+  
+void RootedCladisticEnumeration::initWorkspace(Workspace& workspace) const
+{
+  const Digraph& G = _G.G();
+  const int nrNodes = G.maxNodeId() + 1;
+  const int nrArcs = G.maxArcId() + 1;
+  const int n = _G.F().n();
+  
+  // the frontier stack only grows in the first descent of the search
+  workspace._frontier.clear();
+  workspace._frontier.reserve(4 * nrArcs);
+  workspace._inF.assign(nrArcs, false);
+  workspace._targetF.assign(nrNodes, false);
+  workspace._reached.assign(nrNodes, false);
+  workspace._alive.assign(nrNodes, false);
+  workspace._inC.assign(n, false);
+  workspace._complete.assign(n, false);
+  workspace._queue.clear();
+  workspace._queue.reserve(nrNodes);
+}
+  
+void RootedCladisticEnumeration::runPool(const ArcList& arcs)
+{
+  _workers.clear();
+  for (int i = 0; i < _threads; ++i)
+  {
+    _workers.push_back(std::unique_ptr<Worker>(new Worker()));
+    initWorkspace(_workers.back()->_workspace);
+  }
+  
+  // seed the pool with one task per arc, further tasks are split off
+  // at arbitrary depth of the search whenever workers are idle
+  int idx = 0;
+  for (ArcListIt it = arcs.begin(); it != arcs.end(); ++it, ++idx)
+  {
+    std::deque<Task>& tasks = _workers[idx % _threads]->_tasks;
+    tasks.push_back(Task());
+    initTask(*it, tasks.back());
+  }
+  _nrPending = _nrQueued = arcs.size();
+  _nrIdle = 0;
+  
+  for (int i = 0; i < _threads; ++i)
+  {
+    _threadGroup.create_thread(boost::bind(&RootedCladisticEnumeration::runWorker, this, i));
+  }
+  _threadGroup.join_all();
+  
+  mergeResults();
+  _workers.clear();
+}
+  
+void RootedCladisticEnumeration::mergeResults()
+{
+  // only the solutions of maximum size are retained
+  for (const std::unique_ptr<Worker>& pWorker : _workers)
+  {
+    if (pWorker->_result.empty() || pWorker->_resultSize < _resultSize)
+      continue;
+    
+    if (pWorker->_resultSize > _resultSize)
+    {
+      _result.clear();
+      _resultSize = pWorker->_resultSize;
+    }
+    _result.append(pWorker->_result);
+    pWorker->_result.clear();
+  }
+}
+  
+void RootedCladisticEnumeration::runWorker(int i)
+{
+  _pWorkerIdx.reset(new int(i));
+  
+  Task task;
+  while (true)
+  {
+    if (popTask(i, task))
+    {
+      runTask(task);
+      if (--_nrPending == 0)
+      {
+        boost::interprocess::scoped_lock<boost::mutex> lock(_idleMutex);
+        _idleCondition.notify_all();
+      }
+    }
+    else
+    {
+      boost::unique_lock<boost::mutex> lock(_idleMutex);
+      ++_nrIdle;
+      while (_nrQueued == 0 && _nrPending != 0)
+      {
+        _idleCondition.wait(lock);
+      }
+      --_nrIdle;
+      
+      if (_nrPending == 0)
+        break;
+    }
+  }
+}
+  
+bool RootedCladisticEnumeration::popTask(int i,
+                                         Task& task)
+{
+  const int nrWorkers = _workers.size();
+  for (int j = 0; j < nrWorkers && _nrQueued != 0; ++j)
+  {
+    Worker& worker = *_workers[(i + j) % nrWorkers];
+    boost::interprocess::scoped_lock<boost::mutex> lock(worker._mutex);
+    if (worker._tasks.empty())
+      continue;
+    
+    if (j == 0)
+    {
+      // own task: most recent one, which is the deepest in the search
+      task = std::move(worker._tasks.back());
+      worker._tasks.pop_back();
+    }
+    else
+    {
+      // steal the oldest task, which is the largest subtree of the search
+      task = std::move(worker._tasks.front());
+      worker._tasks.pop_front();
+    }
+    --_nrQueued;
+    return true;
+  }
+  
+  return false;
+}
+  
+void RootedCladisticEnumeration::pushTask(Task& task)
+{
+  assert(_pWorkerIdx.get() != NULL);
+  
+  ++_nrPending;
+  Worker& worker = *_workers[*_pWorkerIdx];
+  {
+    boost::interprocess::scoped_lock<boost::mutex> lock(worker._mutex);
+    worker._tasks.push_back(std::move(task));
+    ++_nrQueued;
+  }
+  
+  if (_nrIdle != 0)
+  {
+    boost::interprocess::scoped_lock<boost::mutex> lock(_idleMutex);
+    _idleCondition.notify_one();
+  }
 }
   
 void RootedCladisticEnumeration::run()
@@ -298,6 +571,7 @@ void RootedCladisticEnumeration::run()
   
   _timer.start();
   _counter = 0;
+  _limitReached = false;
   if (_threads == 1)
   {
     BoolNodeMap filterNodesT(G, false);
@@ -311,18 +585,19 @@ void RootedCladisticEnumeration::run()
     ArcList F;
     
     init(subG, T, F);
-    grow(subG, T, F);
+    initWorkspace(_workspace);
+    _workspace._frontier.assign(F.begin(), F.end());
+    grow(subG, T, 0);
   }
   else
   {
+    ArcList arcs;
     for (OutArcIt a_00dj(G, root); a_00dj != lemon::INVALID; ++a_00dj)
     {
-//      std::cerr << _G.label(G.target(a_00dj)) << std::endl;
-      _threadGroup.create_thread(boost::bind(&RootedCladisticEnumeration::runArc, this, a_00dj));
-//      RootedCladisticEnumeration::runArc(a_00dj);
+      arcs.push_back(a_00dj);
     }
     
-    _threadGroup.join_all();
+    runPool(arcs);
   }
 
   if (g_verbosity >= VERBOSE_ESSENTIAL)
@@ -337,9 +612,6 @@ bool RootedCladisticEnumeration::finalize(SubDigraph& T)
   
 //  writeDOT(std::cout, T, ArcList());
   
-  boost::interprocess::scoped_lock<boost::mutex> lock(_mutex);
-  int currentSize = std::max(_lowerbound, _objectiveValue);
-  
   // make copy of T
   BoolNodeMap filterNodesT(_G.G(), false);
   BoolArcMap filterArcsT(_G.G(), false);
@@ -354,10 +626,17 @@ bool RootedCladisticEnumeration::finalize(SubDigraph& T)
   }
   
   int newSizeT = makeStateComplete(TT);
+  
+  // each worker buffers its own solutions
+  Worker* pWorker = _pWorkerIdx.get() != NULL ? _workers[*_pWorkerIdx].get() : NULL;
+  ResultArena& result = pWorker ? pWorker->_result : _result;
+  int& resultSize = pWorker ? pWorker->_resultSize : _resultSize;
+  
   if (g_verbosity >= VERBOSE_NON_ESSENTIAL)
   {
+    boost::interprocess::scoped_lock<boost::mutex> lock(_mutex);
     std::cerr << "\r                                                            \r";
-    std::cerr << newSizeT << "/" << _result.size() << "/" << _counter << "/" << _limit << " (" << _lowerbound << ")" << std::flush;
+    std::cerr << newSizeT << "/" << (_pSink ? _sinkCount : result.size()) << "/" << _counter << "/" << _limit << " (" << _lowerbound << ")" << std::flush;
   }
   
   const int k = _G.F().k();
@@ -373,144 +652,105 @@ bool RootedCladisticEnumeration::finalize(SubDigraph& T)
     }
   }
   
+  int currentSize = std::max<int>(_lowerbound, _objectiveValue);
   if (newSizeT < currentSize || newSizeT == 0)
   {
     return false;
   }
-  else if (newSizeT > currentSize && !_result.empty())
+  else if (newSizeT > currentSize && _counter != 0)
   {
-    _objectiveValue = _lowerbound = newSizeT;
+    increaseTo(_lowerbound, newSizeT);
     if (g_verbosity >= VERBOSE_NON_ESSENTIAL)
     {
+      boost::interprocess::scoped_lock<boost::mutex> lock(_mutex);
       std::cerr << std::endl;
     }
-    _result.clear();
   }
-  else
+  increaseTo(_objectiveValue, newSizeT);
+  
+  if (_pSink)
   {
-    _objectiveValue = newSizeT;
+    // a worker may have found a larger solution in the meantime
+    boost::interprocess::scoped_lock<boost::mutex> lock(_mutex);
+    if (newSizeT >= _sinkSize)
+    {
+      if (newSizeT > _sinkSize)
+      {
+        _pSink->clear();
+        _sinkSize = newSizeT;
+        _sinkCount = 0;
+      }
+      _pSink->add(solution(TT));
+      ++_sinkCount;
+    }
   }
-  
-  ++_counter;
-  
-  _result.push_back(ArcList());
-  ArcList& res = _result.back();
-  
-  for (SubArcIt a_cidj(TT); a_cidj != lemon::INVALID; ++a_cidj)
+  else
   {
-    res.push_back(a_cidj);
+    if (newSizeT > resultSize)
+    {
+      result.clear();
+      resultSize = newSizeT;
+    }
+    
+    for (SubArcIt a_cidj(TT); a_cidj != lemon::INVALID; ++a_cidj)
+    {
+      result.push_back(a_cidj);
+    }
+    result.close();
   }
   
-  return _result.size() >= _limit;
+  const int counter = ++_counter;
+  return _limit != -1 && counter >= _limit;
 }
   
 bool RootedCladisticEnumeration::grow(SubDigraph& G,
                                       SubDigraph& T,
-                                      ArcList& F)
+                                      int begin)
 {
+  // the frontier is the top segment of the frontier stack
+  ArcVector& F = workspace()._frontier;
+  const int end = F.size();
+  
   if (limitReached())
   {
     return true;
   }
-  else if (F.empty())
+  else if (begin == end)
   {
     return finalize(T);
   }
-  else if (prune(T, F))
+  else if (prune(T, begin, end))
   {
     return false;
   }
   else
   {
-    ArcList FF;
-    
-    do
+    for (int k = end - 1; k >= begin; --k)
     {
-      assert(!F.empty());
-      
-      Arc a_cidj = F.back();
-      F.pop_back();
-      
-//      Arc a_cidj = F.front();
-//      F.pop_front();
-      Node v_ci = G.source(a_cidj);
-      Node v_dj = G.target(a_cidj);
-      
-      assert(T.status(v_ci));
-      assert(!T.status(v_dj));
-      assert(!T.status(a_cidj));
-      
-      // add a_cidj to T
-      addArc(T, a_cidj);
-      
-      ArcList newF = F;
-      
-      // remove each arc wv where w in T from F
-      for (ArcListNonConstIt it = newF.begin(); it != newF.end();)
+      // F may be reallocated by the recursive calls, so copy the arc
+      Arc a_cidj = F[k];
+    
+      if (k > begin && isTaskRequested())
       {
-        if (G.target(*it) == v_dj)
-        {
-          assert(T.status(G.source(*it)));
-          it = newF.erase(it);
-        }
-        else if (G.source(*it) == v_ci && !isValid(T, *it))
-        {
-          it = newF.erase(it);
-        }
-        else
-        {
-          assert(isValid(T, *it));
-          ++it;
-        }
+        // hand the subtree of a_cidj to an idle worker and proceed as if it has been explored
+        Task task;
+        snapshot(G, T, a_cidj, task);
+        task._F.assign(F.begin() + begin, F.begin() + k);
+        pushTask(task);
       }
-      
-      // push each arc a_djel where v_el not in V(T) onto F
-      for (SubOutArcIt a_djel(G, v_dj); a_djel != lemon::INVALID; ++a_djel)
+      else if (branch(G, T, begin, k, a_cidj))
       {
-        Node v_el = G.target(a_djel);
-        
-        // violation of tree constraint (no cycles)
-        if (T.status(v_el))
-          continue;
-        
-        // isFirstAncestor violation (consistency)
-        bool isConsistent = true;
-        for (const IntPair& el : _G.nodeToCharState(v_el))
-        {
-          int pi_l = _G.S(el.first).parent(el.second);
-          assert(pi_l != -1 && pi_l != -2);
-          if (!(pi_l != -1 && pi_l != -2))
-          {
-            abort();
-          }
-          Node v_e_pi_l = _G.charStateToNode(el.first, pi_l);
-          assert(v_e_pi_l != lemon::INVALID);
-          
-          isConsistent = isConsistent && isFirstAncestor(T, el.first, v_e_pi_l, v_dj);
-        }
-        
-        if (isValid(T, a_djel))
-        {
-          newF.push_back(a_djel);
-        }
-      }
-      
-      if (grow(G, T, newF))
         return true;
+      }
       
       G.disable(a_cidj);
+    }
       
-      removeArc(T, a_cidj);
-      
-      FF.push_back(a_cidj);
-    } while (!F.empty());
-    
-    for (ArcListRevIt it = FF.rbegin(); it != FF.rend(); ++it)
+    for (int k = begin; k < end; ++k)
     {
-      Arc a = *it;
+      Arc a = F[k];
       assert(!G.status(a));
       
-      F.push_back(*it);
       G.enable(a);
     }
     
@@ -518,6 +758,86 @@ bool RootedCladisticEnumeration::grow(SubDigraph& G,
   }
 }
   
+bool RootedCladisticEnumeration::branch(SubDigraph& G,
+                                        SubDigraph& T,
+                                        int begin,
+                                        int end,
+                                        Arc a_cidj)
+{
+  Node v_ci = G.source(a_cidj);
+  Node v_dj = G.target(a_cidj);
+  
+  assert(T.status(v_ci));
+  assert(!T.status(v_dj));
+  assert(!T.status(a_cidj));
+  
+  // add a_cidj to T
+  addArc(T, a_cidj);
+  
+  // the new frontier is pushed on top of the frontier stack
+  ArcVector& F = workspace()._frontier;
+  const int newBegin = F.size();
+  
+  // copy F without each arc wv where w in T
+  for (int k = begin; k < end; ++k)
+  {
+    Arc a = F[k];
+    if (G.target(a) == v_dj)
+    {
+      assert(T.status(G.source(a)));
+    }
+    else if (G.source(a) == v_ci && !isValid(T, a))
+    {
+      continue;
+    }
+    else
+    {
+      assert(isValid(T, a));
+      F.push_back(a);
+    }
+  }
+  
+  // push each arc a_djel where v_el not in V(T) onto F
+  for (SubOutArcIt a_djel(G, v_dj); a_djel != lemon::INVALID; ++a_djel)
+  {
+    Node v_el = G.target(a_djel);
+    
+    // violation of tree constraint (no cycles)
+    if (T.status(v_el))
+      continue;
+    
+    // isFirstAncestor violation (consistency)
+    bool isConsistent = true;
+    for (const IntPair& el : _G.nodeToCharState(v_el))
+    {
+      int pi_l = _G.S(el.first).parent(el.second);
+      assert(pi_l != -1 && pi_l != -2);
+      if (!(pi_l != -1 && pi_l != -2))
+      {
+        abort();
+      }
+      Node v_e_pi_l = _G.charStateToNode(el.first, pi_l);
+      assert(v_e_pi_l != lemon::INVALID);
+      
+      isConsistent = isConsistent && isFirstAncestor(T, el.first, v_e_pi_l, v_dj);
+    }
+    
+    if (isValid(T, a_djel))
+    {
+      F.push_back(a_djel);
+    }
+  }
+  
+  bool res = grow(G, T, newBegin);
+  F.resize(newBegin);
+  if (res)
+    return true;
+  
+  removeArc(T, a_cidj);
+  
+  return false;
+}
+  
 bool RootedCladisticEnumeration::isFirstAncestor(const SubDigraph& T,
                                                  int c, // character to check
                                                  Node v_ci, // is this node the first ancestor
@@ -726,27 +1046,34 @@ bool RootedCladisticEnumeration::isValid(const SubDigraph& T,
   
 Solution RootedCladisticEnumeration::solution(int solIdx) const
 {
-  assert(0 <= solIdx && solIdx < _result.size());
-  const int n = _G.F().n();
   const Digraph& G = _G.G();
   
-  ArcListList::const_iterator it = _result.begin();
-  int tmp = solIdx;
-  for (; tmp > 0; tmp--) ++it;
-  
   BoolNodeMap nodes(G, false);
   BoolArcMap arcs(G, false);
   SubDigraph T(G, nodes, arcs);
-  T.enable(_G.root());
+  getTree(solIdx, T);
+  
+  return solution(T);
+}
   
-  const ArcList& arcList = *it;
-  for (ArcListIt it2 = arcList.begin(); it2 != arcList.end(); ++it2)
+void RootedCladisticEnumeration::getTree(int solIdx,
+                                         SubDigraph& T) const
+{
+  const Digraph& G = _G.G();
+  
+  T.enable(_G.root());
+  for (ArcVector::const_iterator it = _result.begin(solIdx); it != _result.end(solIdx); ++it)
   {
-    Arc a = *it2;
+    Arc a = *it;
     T.enable(G.source(a));
     T.enable(G.target(a));
     T.enable(a);
   }
+}
+  
+Solution RootedCladisticEnumeration::solution(const SubDigraph& T) const
+{
+  const int n = _G.F().n();
   
   assert(T.status(_G.root()));
   
@@ -761,7 +1088,7 @@ Solution RootedCladisticEnumeration::solution(int solIdx) const
 //  writeDOT(std::cerr, T, ArcList());
   
   initA(T, _G.root(), stateComplete, sol._A);
-  initF(solIdx, sol._inferredF);
+  initF(T, sol._inferredF);
   initU(T, sol._inferredF, _G.root(), stateComplete, sol._U);
   
   return sol;
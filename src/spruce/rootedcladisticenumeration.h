@@ -14,8 +14,12 @@
 #include <boost/asio/signal_set.hpp>
 #include <boost/thread.hpp>
 #include <boost/thread/mutex.hpp>
-#include <boost/interprocess/sync/interprocess_semaphore.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/tss.hpp>
 #include <boost/interprocess/sync/scoped_lock.hpp>
+#include <atomic>
+#include <deque>
+#include <memory>
 #include "utils.h"
 #include "rootedcladisticancestrygraph.h"
 #include "solution.h"
@@ -39,6 +43,28 @@ public:
   
   virtual ~RootedCladisticEnumeration();
   
+  // receives the solutions as they are found, calls are serialized
+  class SolutionSink
+  {
+  public:
+    virtual ~SolutionSink()
+    {
+    }
+    
+    // discard the solutions added so far as a larger one has been found
+    virtual void clear() = 0;
+    
+    virtual void add(const Solution& sol) = 0;
+  };
+  
+  // stream the solutions to pSink rather than retaining them
+  void setSink(SolutionSink* pSink)
+  {
+    _pSink = pSink;
+    _sinkSize = 0;
+    _sinkCount = 0;
+  }
+  
   virtual void run();
   
   int solutionCount() const
@@ -48,7 +74,7 @@ public:
   
   void stop()
   {
-    _mutex.lock();
+    _limitReached = true;
     _threadGroup.interrupt_all();
   }
   
@@ -69,7 +95,71 @@ protected:
   typedef ArcList::iterator ArcListNonConstIt;
   typedef ArcList::const_reverse_iterator ArcListRevIt;
   typedef std::vector<ArcList> ArcListVector;
-  typedef std::list<ArcList> ArcListList;
+  typedef std::vector<Arc> ArcVector;
+  
+  // solutions stored back to back, the arcs of solution i are
+  // _arcs[_offset[i]] ... _arcs[_offset[i+1]-1]
+  struct ResultArena
+  {
+    ResultArena()
+      : _arcs()
+      , _offset(1, 0)
+    {
+    }
+    
+    int size() const
+    {
+      return _offset.size() - 1;
+    }
+    
+    bool empty() const
+    {
+      return _offset.size() == 1;
+    }
+    
+    void clear()
+    {
+      _arcs.clear();
+      _offset.assign(1, 0);
+    }
+    
+    // add arc to the solution under construction
+    void push_back(Arc a)
+    {
+      _arcs.push_back(a);
+    }
+    
+    // finish the solution under construction
+    void close()
+    {
+      _offset.push_back(_arcs.size());
+    }
+    
+    void append(const ResultArena& other)
+    {
+      const size_t shift = _arcs.size();
+      _arcs.insert(_arcs.end(), other._arcs.begin(), other._arcs.end());
+      for (int i = 1; i < other._offset.size(); ++i)
+      {
+        _offset.push_back(shift + other._offset[i]);
+      }
+    }
+    
+    ArcVector::const_iterator begin(int i) const
+    {
+      assert(0 <= i && i < size());
+      return _arcs.begin() + _offset[i];
+    }
+    
+    ArcVector::const_iterator end(int i) const
+    {
+      assert(0 <= i && i < size());
+      return _arcs.begin() + _offset[i + 1];
+    }
+    
+    ArcVector _arcs;
+    std::vector<size_t> _offset;
+  };
   typedef lemon::SubDigraph<const Digraph> SubDigraph;
   typedef SubDigraph::ArcIt SubArcIt;
   typedef SubDigraph::NodeIt SubNodeIt;
@@ -77,13 +167,102 @@ protected:
   typedef SubDigraph::InArcIt SubInArcIt;
   typedef Digraph::NodeMap<IntSet> IntSetNodeMap;
   
-  virtual void runArc(Arc a_00dj);
+  // subtree of the search space, to be explored by any worker
+  struct Task
+  {
+    Arc _a;
+    BoolVector _nodesG;
+    BoolVector _arcsG;
+    BoolVector _nodesT;
+    BoolVector _arcsT;
+    ArcVector _F;
+    RealTensor _Fhat;
+  };
+  
+  // buffers that are reused by every step of the search of a thread
+  struct Workspace
+  {
+    Workspace()
+      : _frontier()
+      , _inF()
+      , _targetF()
+      , _reached()
+      , _alive()
+      , _inC()
+      , _complete()
+      , _queue()
+    {
+    }
+    
+    // stack of frontiers, each level of the recursion owns the top segment
+    ArcVector _frontier;
+    // arcs in F and their targets, indexed by id
+    BoolVector _inF;
+    BoolVector _targetF;
+    // nodes reached in prune, indexed by id
+    BoolVector _reached;
+    BoolVector _alive;
+    // characters in T and state complete characters
+    BoolVector _inC;
+    BoolVector _complete;
+    NodeVector _queue;
+  };
+  
+  struct Worker
+  {
+    Worker()
+      : _mutex()
+      , _tasks()
+      , _resultSize(0)
+      , _result()
+      , _workspace()
+    {
+    }
+    
+    // the worker pushes and pops at the back, idle workers steal from the front
+    boost::mutex _mutex;
+    std::deque<Task> _tasks;
+    // solutions found by the worker, merged into _result at the end
+    int _resultSize;
+    ResultArena _result;
+    Workspace _workspace;
+  };
+  
+  virtual void initTask(Arc a_cidj, Task& task);
+  
+  virtual void runTask(Task& task);
+  
+  void runPool(const ArcList& arcs);
+  
+  bool isTaskRequested() const
+  {
+    return _nrQueued < _nrIdle && _pWorkerIdx.get() != NULL;
+  }
+  
+  void pushTask(Task& task);
+  
+  void snapshot(const SubDigraph& subG,
+                const SubDigraph& T,
+                Arc a_cidj,
+                Task& task) const;
+  
+  void restore(const Task& task,
+               SubDigraph& subG,
+               SubDigraph& T) const;
+  
+  void initWorkspace(Workspace& workspace) const;
+  
+  Workspace& workspace() const
+  {
+    return _pWorkerIdx.get() != NULL ? _workers[*_pWorkerIdx]->_workspace : _workspace;
+  }
   
   void init(SubDigraph& subG, SubDigraph& T, ArcList& F);
   void init(Arc a_00dj, SubDigraph& subG, SubDigraph& T, ArcList& F);
   
   bool prune(const SubDigraph& T,
-             const ArcList& F) const;
+             int begin,
+             int end) const;
 
   bool isFirstAncestor(const SubDigraph& T,
                        int c,
@@ -226,8 +405,12 @@ protected:
   
   bool limitReached() const
   {
-    boost::interprocess::scoped_lock<boost::mutex> lock(_mutex);
-    return (_limit != -1 && _counter >= _limit) || (_timeLimit != -1 && _timer.realTime() > _timeLimit);
+    if (!_limitReached &&
+        ((_limit != -1 && _counter >= _limit) || (_timeLimit != -1 && _timer.realTime() > _timeLimit)))
+    {
+      _limitReached = true;
+    }
+    return _limitReached;
   }
   
   struct Compare
@@ -289,7 +472,25 @@ protected:
 private:
   bool grow(SubDigraph& G,
             SubDigraph& T,
-            ArcList& F);
+            int begin);
+  
+  bool branch(SubDigraph& G,
+              SubDigraph& T,
+              int begin,
+              int end,
+              Arc a_cidj);
+  
+  void runWorker(int i);
+  
+  bool popTask(int i, Task& task);
+  
+  void mergeResults();
+  
+  static void increaseTo(std::atomic<int>& x, int value)
+  {
+    int old = x;
+    while (old < value && !x.compare_exchange_weak(old, value));
+  }
   
   virtual bool isValid(const SubDigraph& T) const;
   virtual bool isValid(const SubDigraph& T, Arc a_ciel) const;
@@ -304,7 +505,11 @@ private:
              const BoolVector& stateComplete,
              RealMatrix& U) const;
   
-  virtual void initF(int solIdx, RealTensor& F) const
+  void getTree(int solIdx, SubDigraph& T) const;
+  
+  Solution solution(const SubDigraph& T) const;
+  
+  virtual void initF(const SubDigraph& T, RealTensor& F) const
   {
     F = _G.F();
   }
@@ -312,19 +517,32 @@ private:
 protected:
   const RootedCladisticAncestryGraph& _G;
   
-  ArcListList _result;
-  int _objectiveValue;
+  ResultArena _result;
+  int _resultSize;
+  SolutionSink* _pSink;
+  int _sinkSize;
+  int _sinkCount;
+  std::atomic<int> _objectiveValue;
   
   int _limit;
   int _timeLimit;
   int _threads;
-  int _lowerbound;
-  int _counter;
+  std::atomic<int> _lowerbound;
+  std::atomic<int> _counter;
+  mutable std::atomic<bool> _limitReached;
   
   mutable boost::mutex _mutex;
-  boost::interprocess::interprocess_semaphore _sem;
   boost::thread_group _threadGroup;
   
+  std::vector<std::unique_ptr<Worker> > _workers;
+  mutable Workspace _workspace;
+  boost::thread_specific_ptr<int> _pWorkerIdx;
+  std::atomic<int> _nrPending;
+  std::atomic<int> _nrQueued;
+  std::atomic<int> _nrIdle;
+  boost::mutex _idleMutex;
+  boost::condition_variable _idleCondition;
+  
   lemon::Timer _timer;
   bool _monoclonal;
   bool _fixTrunk;
@@ -151,39 +151,62 @@ bool RootedCladisticNoisyEnumeration::updateFhat(const SubDigraph& T,
   const int m = Fhat.m();
   const int n = Fhat.n();
   const int k = Fhat.k();
+  const double eps = g_tol.epsilon();
+  
+  // samples are processed in blocks, the loops over the samples of a block
+  // are free of branches such that they can be vectorized
+  double sum_of_children[_blockSize];
+  double sum_of_descendant_states[_blockSize];
+  double f_cum_hat_dj[_blockSize];
+  double f_hat_ci[_blockSize];
   
   if (v_ci == _G.root())
   {
     // set \hat{f}_{p,(c,i)}
-    for (int p = 0; p < m; ++p)
+    for (int p_begin = 0; p_begin < m; p_begin += _blockSize)
     {
-      double sum_of_children = 0;
+      const int p_end = std::min(m, p_begin + _blockSize);
+      const int size = p_end - p_begin;
+      
+      std::fill(sum_of_children, sum_of_children + size, 0.);
       for (SubOutArcIt a_cidj(T, v_ci); a_cidj != lemon::INVALID; ++a_cidj)
       {
         Node v_dj = T.target(a_cidj);
         const IntPair& dj = *(_G.nodeToCharState(v_dj).begin());
         
-        double f_cum_hat_p_dj = Fhat.getCumFreq(p, dj.first, _G.S(dj.first).D(dj.second));
-        sum_of_children += f_cum_hat_p_dj;
+        Fhat.getCumFreq(p_begin, p_end, dj.first, _G.S(dj.first).D(dj.second), f_cum_hat_dj);
+        for (int p = 0; p < size; ++p)
+        {
+          sum_of_children[p] += f_cum_hat_dj[p];
+        }
       }
       
       for (int c = 0; c < n; ++c)
       {
-        double sum_of_descendant_states = 0; // proper descendants
+        std::fill(sum_of_descendant_states, sum_of_descendant_states + size, 0.); // proper descendants
         for (int j = 1; j < k; ++j)
         {
           if (_G.charStateToNode(c, j) != lemon::INVALID)
           {
-            sum_of_descendant_states += Fhat(j, p, c);
+            const double* f_hat_cj = Fhat.row(j, c) + p_begin;
+            for (int p = 0; p < size; ++p)
+            {
+              sum_of_descendant_states[p] += f_hat_cj[p];
+            }
           }
         }
         
-        double f_hat_p_ci = 1 - sum_of_descendant_states;
-        if (g_tol.less(f_hat_p_ci, 0) || g_tol.less(1, f_hat_p_ci) || g_tol.less(1, sum_of_children))
+        bool violated = false;
+        for (int p = 0; p < size; ++p)
+        {
+          f_hat_ci[p] = 1 - sum_of_descendant_states[p];
+          violated |= (f_hat_ci[p] + eps < 0) | (1 + eps < f_hat_ci[p]) | (1 + eps < sum_of_children[p]);
+        }
+        if (violated)
         {
           return false;
         }
-        Fhat.set(0, p, c, 1 - sum_of_descendant_states);
+        Fhat.set(0, p_begin, p_end, c, f_hat_ci);
       }
     }
     return true;
@@ -197,41 +220,55 @@ bool RootedCladisticNoisyEnumeration::updateFhat(const SubDigraph& T,
     for (auto it_ci = X_ci.rbegin(); it_ci != X_ci.rend(); ++it_ci)
     {
       const IntPair& ci = *it_ci;
-      for (int p = 0; p < m; ++p)
+      const IntSet& D_ci = _G.S(ci.first).D(ci.second);
+      for (int p_begin = 0; p_begin < m; p_begin += _blockSize)
       {
-        double sum_of_children = 0;
+        const int p_end = std::min(m, p_begin + _blockSize);
+        const int size = p_end - p_begin;
+        
         if (it_ci == X_ci.rbegin())
         {
+          std::fill(sum_of_children, sum_of_children + size, 0.);
           for (SubOutArcIt a_cidj(T, v_ci); a_cidj != lemon::INVALID; ++a_cidj)
           {
             Node v_dj = T.target(a_cidj);
             const IntPair& dj = *(_G.nodeToCharState(v_dj).begin());
             
-            double f_cum_hat_p_dj = Fhat.getCumFreq(p, dj.first, _G.S(dj.first).D(dj.second));
-            sum_of_children += f_cum_hat_p_dj;
+            Fhat.getCumFreq(p_begin, p_end, dj.first, _G.S(dj.first).D(dj.second), f_cum_hat_dj);
+            for (int p = 0; p < size; ++p)
+            {
+              sum_of_children[p] += f_cum_hat_dj[p];
+            }
           }
         }
         else
         {
           const IntPair& pi_ci = *std::prev(it_ci);
-          sum_of_children = Fhat.getCumFreq(p, pi_ci.first, _G.S(pi_ci.first).D(pi_ci.second));
+          Fhat.getCumFreq(p_begin, p_end, pi_ci.first, _G.S(pi_ci.first).D(pi_ci.second), sum_of_children);
         }
         
-        double sum_of_descendant_states = 0; // proper descendants
-        const IntSet& D_ci = _G.S(ci.first).D(ci.second);
-        for (int j = 0; j < k; ++j)
+        std::fill(sum_of_descendant_states, sum_of_descendant_states + size, 0.); // proper descendants
+        for (int j : D_ci)
         {
           if (j == ci.second) continue;
-          if (D_ci.find(j) == D_ci.end()) continue;
           assert(_G.charStateToNode(ci.first, j) != lemon::INVALID);
-          sum_of_descendant_states += Fhat(j, p, ci.first);
+          const double* f_hat_cj = Fhat.row(j, ci.first) + p_begin;
+          for (int p = 0; p < size; ++p)
+          {
+            sum_of_descendant_states[p] += f_hat_cj[p];
+          }
         }
         
-        double l_p_ci = F_lb(ci.second, p, ci.first);
-        double u_p_ci = F_ub(ci.second, p, ci.first);
-        double f_hat_p_ci = std::max(l_p_ci, sum_of_children - sum_of_descendant_states);
-        Fhat.set(ci.second, p, ci.first, f_hat_p_ci);
-        if (g_tol.less(f_hat_p_ci, l_p_ci) || g_tol.less(u_p_ci, f_hat_p_ci))
+        const double* l_ci = F_lb.row(ci.second, ci.first) + p_begin;
+        const double* u_ci = F_ub.row(ci.second, ci.first) + p_begin;
+        bool violated = false;
+        for (int p = 0; p < size; ++p)
+        {
+          f_hat_ci[p] = std::max(l_ci[p], sum_of_children[p] - sum_of_descendant_states[p]);
+          violated |= (f_hat_ci[p] + eps < l_ci[p]) | (u_ci[p] + eps < f_hat_ci[p]);
+        }
+        Fhat.set(ci.second, p_begin, p_end, ci.first, f_hat_ci);
+        if (violated)
         {
           return false;
         }
@@ -279,6 +316,7 @@ void RootedCladisticNoisyEnumeration::run()
   
   _timer.start();
   _counter = 0;
+  _limitReached = false;
 //  if (_threads == 1)
 //  {
 //    BoolNodeMap filterNodesT(G, false);
@@ -311,7 +349,9 @@ void RootedCladisticNoisyEnumeration::run()
     RealTensor Fhat;
     
     init(subG, T, H, Fhat);
-    grow(subG, T, H, Fhat);
+    initWorkspace(_workspace);
+    _workspace._frontier.assign(H.begin(), H.end());
+    grow(subG, T, 0, Fhat);
   }
   if (_monoclonal && _fixTrunk)
   {
@@ -319,21 +359,23 @@ void RootedCladisticNoisyEnumeration::run()
     OutArcIt a_00ci(G, root);
     Node v_ci = G.target(a_00ci);
     
+    ArcList arcs;
     for (OutArcIt a_cidj(G, v_ci); a_cidj != lemon::INVALID; ++a_cidj)
     {
-      _threadGroup.create_thread(boost::bind(&RootedCladisticNoisyEnumeration::runArc, this, a_cidj));
+      arcs.push_back(a_cidj);
     }
     
-    _threadGroup.join_all();
+    runPool(arcs);
   }
   else if (_monoclonal)
   {
+    ArcList arcs;
     for (OutArcIt a_00dj(G, root); a_00dj != lemon::INVALID; ++a_00dj)
     {
-      _threadGroup.create_thread(boost::bind(&RootedCladisticNoisyEnumeration::runArc, this, a_00dj));
+      arcs.push_back(a_00dj);
     }
     
-    _threadGroup.join_all();
+    runPool(arcs);
   }
   
   if (g_verbosity >= VERBOSE_ESSENTIAL)
@@ -342,9 +384,9 @@ void RootedCladisticNoisyEnumeration::run()
   }
 }
   
-void RootedCladisticNoisyEnumeration::runArc(Arc a_00dj)
+void RootedCladisticNoisyEnumeration::initTask(Arc a_cidj,
+                                               Task& task)
 {
-  _sem.wait();
   const Digraph& G = _G.G();
   
   BoolNodeMap filterNodesT(G, false);
@@ -356,12 +398,36 @@ void RootedCladisticNoisyEnumeration::runArc(Arc a_00dj)
   SubDigraph subG(G, filterNodesG, filterArcsG);
   
   ArcList H;
-  RealTensor Fhat;
   
-  init(a_00dj, subG, T, H, Fhat);
-  grow(subG, T, H, Fhat);
+  init(a_cidj, subG, T, H, task._Fhat);
+  snapshot(subG, T, lemon::INVALID, task);
+  task._F.assign(H.begin(), H.end());
+}
+  
+void RootedCladisticNoisyEnumeration::runTask(Task& task)
+{
+  const Digraph& G = _G.G();
+  
+  BoolNodeMap filterNodesT(G, false);
+  BoolArcMap filterArcsT(G, false);
+  SubDigraph T(G, filterNodesT, filterArcsT);
   
-  _sem.post();
+  BoolNodeMap filterNodesG(G, true);
+  BoolArcMap filterArcsG(G, true);
+  SubDigraph subG(G, filterNodesG, filterArcsG);
+  
+  restore(task, subG, T);
+  
+  ArcVector& H = workspace()._frontier;
+  H.assign(task._F.begin(), task._F.end());
+  if (task._a == lemon::INVALID)
+  {
+    grow(subG, T, 0, task._Fhat);
+  }
+  else
+  {
+    branch(subG, T, 0, H.size(), task._a, task._Fhat);
+  }
 }
   
 //void RootedCladisticNoisyEnumeration::run()
@@ -437,139 +503,56 @@ void RootedCladisticNoisyEnumeration::writeDOT(std::ostream& out,
   
 bool RootedCladisticNoisyEnumeration::grow(SubDigraph& G,
                                            SubDigraph& T,
-                                           ArcList& H,
+                                           int begin,
                                            RealTensor& Fhat)
 {
+  // the frontier is the top segment of the frontier stack
+  ArcVector& H = workspace()._frontier;
+  const int end = H.size();
+  
   if (limitReached())
   {
     return true;
   }
-  else if (H.empty())
+  else if (begin == end)
   {
     int m = lemon::countArcs(T);
-    if (m >= std::max(_lowerbound, _objectiveValue))
+    if (m >= std::max<int>(_lowerbound, _objectiveValue))
       return finalize(T);
   }
-  else if (prune(T, H))
+  else if (prune(T, begin, end))
   {
     return false;
   }
   else
   {
-    ArcList HH;
-    
-    do
+    for (int k = end - 1; k >= begin; --k)
     {
-      assert(!H.empty());
-      
-      Arc a_cidj = H.back();
-      H.pop_back();
-      
-      const Node v_ci = G.source(a_cidj);
-      const Node v_dj = G.target(a_cidj);
-      
-      assert(T.status(v_ci));
-      assert(!T.status(v_dj));
-      assert(!T.status(a_cidj));
-      
-      // add a_cidj to T
-      assert(isValid(T, a_cidj));
-      addArc(T, Fhat, a_cidj);
-      
-      ArcList newH = H;
-      
-      // remove each arc wv where w in T from F
-      for (ArcListNonConstIt it = newH.begin(); it != newH.end();)
-      {
-        Arc a_elfs = *it;
-        Node v_el = G.source(a_elfs);
-        Node v_fs = G.target(a_elfs);
-        if (T.status(v_fs))
-        {
-          it = newH.erase(it);
-        }
-        else if (v_fs == v_dj)
-        {
-          assert(T.status(v_el));
-          it = newH.erase(it);
-        }
-        else if (!checkFhat(T, Fhat, a_elfs))
-        {
-          it = newH.erase(it);
-        }
-        else
-        {
-//          if (!isValid(T, a_elfs))
-//          {
-//            RootedCladisticEnumeration::writeDOT(std::cout, T, HH);
-//          }
-          assert(checkFhat(T, Fhat, *it));
-          assert(isValid(T, *it));
-          ++it;
-        }
-      }
-      
-      // push each arc a_djel where v_el not in V(T) onto F
-      for (SubOutArcIt a_djel(G, v_dj); a_djel != lemon::INVALID; ++a_djel)
+      // H may be reallocated by the recursive calls, so copy the arc
+      Arc a_cidj = H[k];
+    
+      if (k > begin && isTaskRequested())
       {
-        Node v_el = G.target(a_djel);
-        
-        // violation of tree constraint (no cycles)
-        if (T.status(v_el))
-          continue;
-        
-        // isFirstAncestor violation (consistency)
-        bool isConsistent = true;
-        for (const IntPair& el : _G.nodeToCharState(v_el))
-        {
-          int pi_l = _G.S(el.first).parent(el.second);
-          assert(0 <= pi_l && pi_l < Fhat.k());
-          Node v_e_pi_l = _G.charStateToNode(el.first, pi_l);
-
-          isConsistent = isConsistent && isFirstAncestor(T, el.first, v_e_pi_l, v_dj);
-        }
-        
-        if (!isConsistent)
-          continue;
-        
-        if (checkFhat(T, Fhat, a_djel))
-        {
-          assert(isValid(T, a_djel));
-          newH.push_back(a_djel);
-        }
+        // hand the subtree of a_cidj to an idle worker and proceed as if it has been explored
+        Task task;
+        snapshot(G, T, a_cidj, task);
+        task._F.assign(H.begin() + begin, H.begin() + k);
+        task._Fhat = Fhat;
+        pushTask(task);
       }
-      
-      // shuffle frontier, depth-first is overrated
-      if (_monoclonal)
+      else if (branch(G, T, begin, k, a_cidj, Fhat))
       {
-        std::vector<Arc> tmpVec;
-        tmpVec.insert(tmpVec.begin(), newH.begin(), newH.end());
-        std::shuffle(tmpVec.begin(), tmpVec.end(), g_rng);
-        newH.clear();
-        for (Arc a : tmpVec)
-        {
-          newH.push_back(a);
-        }
-      }
-      
-//      RootedCladisticEnumeration::writeDOT(std::cout, T, newH);
-      
-      if (grow(G, T, newH, Fhat))
         return true;
+      }
       
       G.disable(a_cidj);
+    }
       
-      removeArc(T, Fhat, a_cidj);
-      
-      HH.push_back(a_cidj);
-    } while (!H.empty());
-    
-    for (ArcListRevIt it = HH.rbegin(); it != HH.rend(); ++it)
+    for (int k = begin; k < end; ++k)
     {
-      Arc a = *it;
+      Arc a = H[k];
       assert(!G.status(a));
       
-      H.push_back(*it);
       G.enable(a);
     }
     
@@ -585,6 +568,108 @@ bool RootedCladisticNoisyEnumeration::grow(SubDigraph& G,
     return false;
 }
   
+bool RootedCladisticNoisyEnumeration::branch(SubDigraph& G,
+                                             SubDigraph& T,
+                                             int begin,
+                                             int end,
+                                             Arc a_cidj,
+                                             RealTensor& Fhat)
+{
+  const Node v_ci = G.source(a_cidj);
+  const Node v_dj = G.target(a_cidj);
+  
+  assert(T.status(v_ci));
+  assert(!T.status(v_dj));
+  assert(!T.status(a_cidj));
+  
+  // add a_cidj to T
+  assert(isValid(T, a_cidj));
+  addArc(T, Fhat, a_cidj);
+  
+  // the new frontier is pushed on top of the frontier stack
+  ArcVector& H = workspace()._frontier;
+  const int newBegin = H.size();
+  
+  // copy H without each arc wv where w in T
+  for (int k = begin; k < end; ++k)
+  {
+    Arc a_elfs = H[k];
+    Node v_el = G.source(a_elfs);
+    Node v_fs = G.target(a_elfs);
+    if (T.status(v_fs))
+    {
+      continue;
+    }
+    else if (v_fs == v_dj)
+    {
+      assert(T.status(v_el));
+    }
+    else if (!checkFhat(T, Fhat, a_elfs))
+    {
+      continue;
+    }
+    else
+    {
+//      if (!isValid(T, a_elfs))
+//      {
+//        RootedCladisticEnumeration::writeDOT(std::cout, T, HH);
+//      }
+      assert(checkFhat(T, Fhat, a_elfs));
+      assert(isValid(T, a_elfs));
+      H.push_back(a_elfs);
+    }
+  }
+  
+  // push each arc a_djel where v_el not in V(T) onto F
+  for (SubOutArcIt a_djel(G, v_dj); a_djel != lemon::INVALID; ++a_djel)
+  {
+    Node v_el = G.target(a_djel);
+    
+    // violation of tree constraint (no cycles)
+    if (T.status(v_el))
+      continue;
+    
+    // isFirstAncestor violation (consistency)
+    bool isConsistent = true;
+    for (const IntPair& el : _G.nodeToCharState(v_el))
+    {
+      int pi_l = _G.S(el.first).parent(el.second);
+      assert(0 <= pi_l && pi_l < Fhat.k());
+      Node v_e_pi_l = _G.charStateToNode(el.first, pi_l);
+      
+      isConsistent = isConsistent && isFirstAncestor(T, el.first, v_e_pi_l, v_dj);
+    }
+    
+    if (!isConsistent)
+      continue;
+    
+    if (checkFhat(T, Fhat, a_djel))
+    {
+      assert(isValid(T, a_djel));
+      H.push_back(a_djel);
+    }
+  }
+  
+  // shuffle frontier, depth-first is overrated
+  if (_monoclonal)
+  {
+    // g_rng is shared by all workers
+    boost::interprocess::scoped_lock<boost::mutex> lock(_mutex);
+    std::shuffle(H.begin() + newBegin, H.end(), g_rng);
+  }
+  
+//  RootedCladisticEnumeration::writeDOT(std::cout, T, newH);
+  
+  bool res = grow(G, T, newBegin, Fhat);
+  H.resize(newBegin);
+  if (res)
+    return true;
+  
+  removeArc(T, Fhat, a_cidj);
+  
+  return false;
+}
+  
 bool RootedCladisticNoisyEnumeration::isValid(const SubDigraph& T) const
 {
   RealTensor F_hat = _noisyG.F_lb();
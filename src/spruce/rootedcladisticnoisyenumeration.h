@@ -43,9 +43,16 @@ protected:
 private:
   bool grow(SubDigraph& G,
             SubDigraph& T,
-            ArcList& H,
+            int begin,
             RealTensor& Fhat);
    
+  bool branch(SubDigraph& G,
+              SubDigraph& T,
+              int begin,
+              int end,
+              Arc a_cidj,
+              RealTensor& Fhat);
+   
   void writeDOT(std::ostream& out,
                 const SubDigraph& T,
                 const RealTensor& F_hat) const;
@@ -60,6 +67,9 @@ private:
             ArcList& H,
             RealTensor& Fhat);
   
+  // number of samples that updateFhat processes at once
+  static const int _blockSize = 32;
+  
   bool updateFhat(const SubDigraph& T,
                   Node v_ci,
                   RealTensor& Fhat) const;
@@ -76,31 +86,12 @@ private:
   bool isValid(const SubDigraph& T,
                Arc a_cidj) const;
   
-  virtual void runArc(Arc a_00dj);
+  virtual void initTask(Arc a_cidj, Task& task);
   
-  virtual void initF(int solIdx, RealTensor& F) const
+  virtual void runTask(Task& task);
+  
+  virtual void initF(const SubDigraph& T, RealTensor& F) const
   {
-    const Digraph& G = _G.G();
-    
-    BoolNodeMap filterNodesT(G, false);
-    BoolArcMap filterArcsT(G, false);
-    
-    SubDigraph T(G, filterNodesT, filterArcsT);
-    
-    ArcListList::const_iterator it = _result.begin();
-    int tmp = solIdx;
-    for (; tmp > 0; --tmp, ++it);
-    const ArcList& arcs = *it;
-    for (ArcListIt it = arcs.begin(); it != arcs.end(); ++it)
-    {
-      Arc a_cidj = *it;
-      Node v_ci = G.source(a_cidj);
-      Node v_dj = G.target(a_cidj);
-      T.enable(v_ci);
-      T.enable(v_dj);
-      T.enable(a_cidj);
-    }
-    
     isValid(T, _G.root(), F);
 
     for (int p = 0; p < F.m(); ++p)
@@ -7,6 +7,9 @@
 
 #include "utils.h"
 #include <fstream>
+#include <cstdio>
+#include <atomic>
+#include <unistd.h>
 
 lemon::Tolerance<double> g_tol(1e-4);
 
@@ -202,3 +205,41 @@ std::istream& operator>>(std::istream& in, DoubleTensor& M)
   
   return in;
 }
+
+/// Return a temporary filename for the given target filename that is unique
+/// per process and call
+///
+/// @param filename Target filename
+static std::string getTmpFilename(const std::string& filename)
+{
+  static std::atomic<unsigned long> counter(0);
+  return filename + "." + std::to_string(getpid()) + "." + std::to_string(counter++) + ".tmp";
+}
+
+AtomicOfstream::AtomicOfstream(const std::string& filename)
+  : std::ofstream()
+  , _filename(filename)
+  , _tmpFilename(getTmpFilename(filename))
+{
+  open(_tmpFilename.c_str());
+}
+
+AtomicOfstream::~AtomicOfstream()
+{
+  close();
+}
+
+void AtomicOfstream::close()
+{
+  if (!is_open())
+  {
+    return;
+  }
+  
+  std::ofstream::close();
+  if (std::rename(_tmpFilename.c_str(), _filename.c_str()) != 0)
+  {
+    std::cerr << "Error: failed to rename '" << _tmpFilename
+              << "' to '" << _filename << "'" << std::endl;
+  }
+}
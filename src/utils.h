@@ -13,6 +13,7 @@
 #include <lemon/tolerance.h>
 #include <cassert>
 #include <iostream>
+#include <fstream>
 #include <set>
 #include <algorithm>
 #include <list>
@@ -144,4 +145,32 @@ std::ostream& operator<<(std::ostream& out, const DoubleTensor& M);
 /// @param M Tensor of doubles
 std::istream& operator>>(std::istream& in, DoubleTensor& M);
 
+/// This class implements an output file stream that writes to a temporary
+/// file, which is renamed to the target filename upon closing. Readers
+/// thus never observe partially written output files. The temporary
+/// filename is unique per process and stream, such that concurrent writers
+/// of the same target do not interfere and the last rename wins.
+///
+/// \brief Atomically written output file stream
+class AtomicOfstream : public std::ofstream
+{
+public:
+  /// Constructor
+  ///
+  /// @param filename Target filename
+  AtomicOfstream(const std::string& filename);
+  
+  /// Destructor, closes the stream if still open
+  ~AtomicOfstream();
+  
+  /// Close the stream and rename the temporary file to the target filename
+  void close();
+  
+private:
+  /// Target filename
+  const std::string _filename;
+  /// Temporary filename
+  const std::string _tmpFilename;
+};
+
 #endif // UTILS_H